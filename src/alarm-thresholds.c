@@ -0,0 +1,133 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration.h"
+#include "delta-method.h"
+#include "alarm-thresholds.h"
+
+uint32_t
+alarmThresholdGetFirstCountAbove(const CalibrationContext *  context, double temperature)
+{
+	double		estimate = calibrationContextConvertTemperature(context, temperature);
+	uint32_t	count;
+
+	if (!(estimate > 0))
+	{
+		count = 0;
+	}
+	else if (estimate >= kAlarmThresholdNumberOfCounts)
+	{
+		count = kAlarmThresholdNumberOfCounts;
+	}
+	else
+	{
+		count = (uint32_t) ceil(estimate);
+	}
+
+	/*
+	 *	Counts below the calibrated range convert to NaN, which exceeds no threshold.
+	 */
+	while ((count > 0) && (calibrationContextConvertCounts(context, count - 1) > temperature))
+	{
+		count--;
+	}
+
+	while ((count < kAlarmThresholdNumberOfCounts) && !(calibrationContextConvertCounts(context, count) > temperature))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+void
+alarmThresholdBuild(AlarmThreshold *  threshold, const DeltaMethodContext *  deltaMethodContext, double temperature)
+{
+	const CalibrationContext *	context = &deltaMethodContext->context;
+	double				estimate = calibrationContextConvertTemperature(context, temperature);
+	DeltaMethodResult		result;
+
+	/*
+	 *	The band is that of the count at the threshold, including its quantization. A threshold
+	 *	outside the range of the counts has no band.
+	 */
+	threshold->temperature = temperature;
+	threshold->standardDeviation = NAN;
+	if ((estimate >= 0) && (estimate < kAlarmThresholdNumberOfCounts))
+	{
+		deltaMethodPropagate(deltaMethodContext, estimate, 1.0 / 12, &result);
+		threshold->standardDeviation = result.standardDeviation;
+	}
+
+	threshold->firstCounts[kAlarmThresholdBandCentral] = alarmThresholdGetFirstCountAbove(context, temperature);
+	if (isnan(threshold->standardDeviation))
+	{
+		threshold->firstCounts[kAlarmThresholdBandLower] = threshold->firstCounts[kAlarmThresholdBandCentral];
+		threshold->firstCounts[kAlarmThresholdBandUpper] = threshold->firstCounts[kAlarmThresholdBandCentral];
+	}
+	else
+	{
+		threshold->firstCounts[kAlarmThresholdBandLower] = alarmThresholdGetFirstCountAbove(
+									context,
+									temperature - kAlarmThresholdBandStandardDeviations * threshold->standardDeviation);
+		threshold->firstCounts[kAlarmThresholdBandUpper] = alarmThresholdGetFirstCountAbove(
+									context,
+									temperature + kAlarmThresholdBandStandardDeviations * threshold->standardDeviation);
+	}
+
+	return;
+}
+
+void
+alarmThresholdsCountRow(
+	const AlarmThreshold *	thresholds,
+	size_t			numberOfThresholds,
+	const uint16_t *	rawCounts,
+	size_t			width,
+	size_t *		pixelCounts)
+{
+	/*
+	 *	One comparison and add per pixel and band edge, which the compiler vectorizes
+	 *	over the 16-bit counts.
+	 */
+	for (size_t k = 0; k < numberOfThresholds; k++)
+	{
+		for (size_t band = 0; band < kAlarmThresholdBandMax; band++)
+		{
+			uint32_t	firstCount = thresholds[k].firstCounts[band];
+			size_t		numberOfPixels = 0;
+
+			for (size_t i = 0; i < width; i++)
+			{
+				numberOfPixels += (rawCounts[i] >= firstCount);
+			}
+
+			pixelCounts[k * kAlarmThresholdBandMax + band] += numberOfPixels;
+		}
+	}
+
+	return;
+}
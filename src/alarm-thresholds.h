@@ -0,0 +1,116 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration.h"
+#include "delta-method.h"
+
+/*
+ *	Temperature alarm thresholds mapped back to raw counts. The conversion
+ *	increases with the count, so a pixel exceeds a threshold exactly when its
+ *	count is at least the first count that does, and frames can be checked
+ *	with integer comparisons before any pixel is converted.
+ */
+typedef enum
+{
+	/*
+	 *	Most alarm thresholds accepted by `-at`.
+	 */
+	kAlarmThresholdsMaximum		= 16,
+	/*
+	 *	One more than the largest raw count.
+	 */
+	kAlarmThresholdNumberOfCounts	= UINT16_MAX + 1,
+} AlarmThresholdConstant;
+
+/*
+ *	Each threshold is mapped at its temperature and at the edges of its uncertainty band,
+ *	`kAlarmThresholdBandStandardDeviations` first-order standard deviations below and above it.
+ */
+typedef enum
+{
+	kAlarmThresholdBandLower	= 0,
+	kAlarmThresholdBandCentral,
+	kAlarmThresholdBandUpper,
+	kAlarmThresholdBandMax,
+} AlarmThresholdBand;
+
+/*
+ *	Two-sided 95% band of a normal temperature.
+ */
+static const double	kAlarmThresholdBandStandardDeviations = 1.96;
+
+typedef struct
+{
+	double		temperature;
+	/*
+	 *	First-order standard deviation of the temperature of the count at the threshold.
+	 */
+	double		standardDeviation;
+	/*
+	 *	For each band edge, the first count whose temperature exceeds it, or
+	 *	`kAlarmThresholdNumberOfCounts` if none does.
+	 */
+	uint32_t	firstCounts[kAlarmThresholdBandMax];
+} AlarmThreshold;
+
+/**
+ *	@brief  Maps a temperature threshold and its uncertainty band to raw counts.
+ *
+ *	@param  threshold		: Pointer to the threshold to build.
+ *	@param  deltaMethodContext	: The first-order context of the calibration, whose nominal
+ *					  context converts the counts.
+ *	@param  temperature		: The threshold temperature.
+ */
+void	alarmThresholdBuild(AlarmThreshold *  threshold, const DeltaMethodContext *  deltaMethodContext, double temperature);
+
+/**
+ *	@brief  Returns the first count whose temperature exceeds `temperature`. The inverse conversion
+ *		gives it up to round-off, which comparisons with the forward conversion then remove.
+ *
+ *	@param  context		: Pointer to the calibration context.
+ *	@param  temperature	: The temperature.
+ *
+ *	@return			: The count, or `kAlarmThresholdNumberOfCounts` if no count exceeds `temperature`.
+ */
+uint32_t	alarmThresholdGetFirstCountAbove(const CalibrationContext *  context, double temperature);
+
+/**
+ *	@brief  Counts the pixels of a row whose counts reach each band edge of each threshold.
+ *
+ *	@param  thresholds		: The thresholds.
+ *	@param  numberOfThresholds	: Number of thresholds.
+ *	@param  rawCounts		: The raw counts of the row.
+ *	@param  width			: Number of pixels of the row.
+ *	@param  pixelCounts		: `numberOfThresholds * kAlarmThresholdBandMax` counts, indexed by
+ *					  threshold and then band, to add the pixels of the row to.
+ */
+void	alarmThresholdsCountRow(
+		const AlarmThreshold *	thresholds,
+		size_t			numberOfThresholds,
+		const uint16_t *	rawCounts,
+		size_t			width,
+		size_t *		pixelCounts);
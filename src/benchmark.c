@@ -0,0 +1,532 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+/*
+ *	Benchmark suite for the conversion routines. This is a separate program
+ *	from the demo application (see README.md for how to build it). It sweeps
+ *	frame sizes, conversion modes, Monte Carlo iteration counts and thread
+ *	counts, times every run with the monotonic clock, and prints the results
+ *	as one JSON document on stdout, so that runs can be compared across
+ *	releases.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "calibration.h"
+#include "conversion.h"
+#include "lookup-table.h"
+#include "material-map.h"
+#include "monte-carlo.h"
+#include "random.h"
+#include "streaming-statistics.h"
+#include "timing.h"
+
+typedef enum
+{
+	kBenchmarkFrameModePoint	= 0,
+	kBenchmarkFrameModeVectorized,
+	kBenchmarkFrameModeVectorizedFloat32,
+	kBenchmarkFrameModeVectorizedMaterials,
+	kBenchmarkFrameModeLookupTable,
+	kBenchmarkFrameModeMax,
+} BenchmarkFrameMode;
+
+typedef enum
+{
+	/*
+	 *	Frame runs are repeated until about this many pixels have been
+	 *	converted, and at least `kBenchmarkMinimumRepetitions` times.
+	 */
+	kBenchmarkPixelsPerMeasurement	= 20000000,
+	kBenchmarkMinimumRepetitions	= 5,
+	/*
+	 *	`--quick` divides the work of every measurement by this factor.
+	 */
+	kBenchmarkQuickDivisor		= 20,
+	kBenchmarkFrameMonteCarloIterations	= 200,
+	/*
+	 *	The materials mode labels the frame in square blocks of this many
+	 *	pixels a side, cycling through this many materials.
+	 */
+	kBenchmarkMaterialBlockSize	= 32,
+	kBenchmarkNumberOfMaterials	= 4,
+	kBenchmarkSeed			= 0xBE4C,
+} BenchmarkConstant;
+
+static const char *	kBenchmarkFrameModeNames[kBenchmarkFrameModeMax] =
+			{
+				[kBenchmarkFrameModePoint]		= "point",
+				[kBenchmarkFrameModeVectorized]		= "vectorized",
+				[kBenchmarkFrameModeVectorizedFloat32]	= "vectorized-float32",
+				[kBenchmarkFrameModeVectorizedMaterials]	= "vectorized-materials",
+				[kBenchmarkFrameModeLookupTable]	= "lookup-table",
+			};
+
+/*
+ *	Lepton (160x120), QVGA, the Ax5 (320x256) and larger cores.
+ */
+static const size_t	kBenchmarkFrameSizes[][2] = {{160, 120}, {320, 240}, {320, 256}, {640, 512}, {1280, 1024}};
+static const size_t	kBenchmarkMonteCarloIterations[] = {10000, 100000, 1000000};
+/*
+ *	Zero selects all online processors.
+ */
+static const size_t	kBenchmarkThreadCounts[] = {1, 2, 4, 0};
+static const double	kBenchmarkLatencyPercentileProbabilities[] = {0.50, 0.90, 0.99};
+enum
+{
+	kBenchmarkNumberOfFrameSizes			= sizeof(kBenchmarkFrameSizes) / sizeof(kBenchmarkFrameSizes[0]),
+	kBenchmarkNumberOfMonteCarloIterations		= sizeof(kBenchmarkMonteCarloIterations) / sizeof(kBenchmarkMonteCarloIterations[0]),
+	kBenchmarkNumberOfThreadCounts			= sizeof(kBenchmarkThreadCounts) / sizeof(kBenchmarkThreadCounts[0]),
+	kBenchmarkNumberOfLatencyPercentiles		= sizeof(kBenchmarkLatencyPercentileProbabilities) / sizeof(kBenchmarkLatencyPercentileProbabilities[0]),
+};
+
+static int
+compareDoubles(const void *  a, const void *  b)
+{
+	double	x = *(const double *) a;
+	double	y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ *	@brief  Sorts `latencies` and prints their percentiles and maximum as the members of a JSON object.
+ *
+ *	@param  latencies		: The latencies, in seconds. Sorted in place.
+ *	@param  numberOfLatencies	: Number of latencies.
+ */
+static void
+printLatencyPercentiles(double *  latencies, size_t numberOfLatencies)
+{
+	qsort(latencies, numberOfLatencies, sizeof(double), compareDoubles);
+
+	printf("\"latencySeconds\": {");
+	for (size_t i = 0; i < kBenchmarkNumberOfLatencyPercentiles; i++)
+	{
+		/*
+		 *	Nearest-rank percentile.
+		 */
+		size_t	rank = (size_t) ceil(kBenchmarkLatencyPercentileProbabilities[i] * numberOfLatencies);
+
+		printf(
+			"\"p%g\": %.9g, ",
+			100 * kBenchmarkLatencyPercentileProbabilities[i],
+			latencies[(rank > 0) ? rank - 1 : 0]);
+	}
+	printf("\"max\": %.9g}", latencies[numberOfLatencies - 1]);
+
+	return;
+}
+
+/**
+ *	@brief  Fills a frame with reproducible counts spread over a typical scene range.
+ *
+ *	@param  rawCounts		: The frame.
+ *	@param  numberOfPixels		: Number of pixels of the frame.
+ */
+static void
+fillBenchmarkFrame(uint16_t *  rawCounts, size_t numberOfPixels)
+{
+	double	uniforms[1];
+
+	for (size_t i = 0; i < numberOfPixels; i++)
+	{
+		counterBasedUniforms(kBenchmarkSeed, i, 1, uniforms);
+		rawCounts[i] = (uint16_t) (29000 + 2000 * uniforms[0]);
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Labels a frame with blocks of `kBenchmarkNumberOfMaterials` materials.
+ *
+ *	@param  labels			: The labels.
+ *	@param  width			: Frame width in pixels.
+ *	@param  height			: Frame height in pixels.
+ */
+static void
+fillBenchmarkMaterialLabels(uint8_t *  labels, size_t width, size_t height)
+{
+	for (size_t row = 0; row < height; row++)
+	{
+		for (size_t column = 0; column < width; column++)
+		{
+			labels[row * width + column] = (uint8_t) ((row / kBenchmarkMaterialBlockSize + column / kBenchmarkMaterialBlockSize) % kBenchmarkNumberOfMaterials);
+		}
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Times repeated conversions of one frame in one mode and prints the result as a JSON object.
+ *
+ *	@param  mode			: The conversion mode.
+ *	@param  context			: Pointer to the nominal calibration context.
+ *	@param  lookupTable		: Pointer to the lookup table built from `context`.
+ *	@param  materialTable		: Pointer to the material table, built here for the frame's map.
+ *	@param  width			: Frame width in pixels.
+ *	@param  height			: Frame height in pixels.
+ *	@param  workDivisor		: Divides the number of repetitions.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+benchmarkFrameConversion(
+	BenchmarkFrameMode		mode,
+	const CalibrationContext *	context,
+	const CountsLookupTable *	lookupTable,
+	MaterialTable *			materialTable,
+	size_t				width,
+	size_t				height,
+	size_t				workDivisor)
+{
+	size_t				numberOfPixels = width * height;
+	size_t				repetitions = kBenchmarkPixelsPerMeasurement / workDivisor / numberOfPixels;
+	uint16_t *			rawCounts;
+	double *			temperatures;
+	double *			latencies;
+	uint8_t *			labels;
+	MaterialMap			materialMap = {0};
+	double				totalSeconds = 0;
+	CommonConstantReturnType	ret = kCommonConstantReturnTypeSuccess;
+
+	if (repetitions < kBenchmarkMinimumRepetitions)
+	{
+		repetitions = kBenchmarkMinimumRepetitions;
+	}
+
+	rawCounts = (uint16_t *) checkedMalloc(numberOfPixels * sizeof(uint16_t), __FILE__, __LINE__);
+	temperatures = (double *) checkedMalloc(numberOfPixels * sizeof(double), __FILE__, __LINE__);
+	latencies = (double *) checkedMalloc(repetitions * sizeof(double), __FILE__, __LINE__);
+	fillBenchmarkFrame(rawCounts, numberOfPixels);
+
+	if (mode == kBenchmarkFrameModeVectorizedMaterials)
+	{
+		labels = (uint8_t *) checkedMalloc(numberOfPixels * sizeof(uint8_t), __FILE__, __LINE__);
+		fillBenchmarkMaterialLabels(labels, width, height);
+		materialMapInit(&materialMap, labels, width, height);
+		free(labels);
+		ret = materialTableBuild(materialTable, &materialMap, &context->parameters);
+	}
+
+	for (size_t r = 0; (r < repetitions) && (ret == kCommonConstantReturnTypeSuccess); r++)
+	{
+		double	start = getMonotonicTimeInSeconds();
+
+		switch (mode)
+		{
+			case kBenchmarkFrameModePoint:
+				ret = convertRawCountsFrameToTemperature(context, rawCounts, width, height, width, temperatures);
+				break;
+			case kBenchmarkFrameModeVectorized:
+				ret = convertRawCountsFrameToTemperatureVectorized(context, rawCounts, width, height, width, temperatures);
+				break;
+			case kBenchmarkFrameModeVectorizedFloat32:
+				/*
+				 *	The float64 buffer has room for the float32 frame.
+				 */
+				ret = convertRawCountsFrameToTemperatureFloat32(context, rawCounts, width, height, width, (float *) temperatures);
+				break;
+			case kBenchmarkFrameModeVectorizedMaterials:
+				ret = convertRawCountsFrameToTemperatureWithMaterials(materialTable, rawCounts, materialMap.slots, width, height, width, temperatures);
+				break;
+			default:
+				ret = convertRawCountsFrameToTemperatureViaLookupTable(lookupTable, rawCounts, width, height, width, temperatures);
+				break;
+		}
+
+		latencies[r] = getMonotonicTimeInSeconds() - start;
+		totalSeconds += latencies[r];
+	}
+
+	if (ret == kCommonConstantReturnTypeSuccess)
+	{
+		printf(
+			"{\"mode\": \"%s\", \"width\": %zu, \"height\": %zu, \"repetitions\": %zu, \"nsPerPixel\": %.6g, \"megapixelsPerSecond\": %.6g, ",
+			kBenchmarkFrameModeNames[mode],
+			width,
+			height,
+			repetitions,
+			1e9 * totalSeconds / (repetitions * numberOfPixels),
+			repetitions * numberOfPixels / totalSeconds / 1e6);
+		printLatencyPercentiles(latencies, repetitions);
+		printf("}");
+	}
+
+	materialMapFree(&materialMap);
+	free(latencies);
+	free(temperatures);
+	free(rawCounts);
+
+	return ret;
+}
+
+/**
+ *	@brief  Times a streaming Monte Carlo run of the single-value conversion and prints the result
+ *		as a JSON object.
+ *
+ *	@param  numberOfIterations	: Number of Monte Carlo iterations.
+ *	@param  numberOfThreads		: Number of worker threads, zero for all processors.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+benchmarkMonteCarlo(size_t numberOfIterations, size_t numberOfThreads)
+{
+	MonteCarloConfiguration		configuration;
+	StreamingStatistics		statistics;
+	CommonConstantReturnType	ret;
+	double				start;
+	double				seconds;
+
+	monteCarloConfigurationSetDefaults(&configuration);
+	configuration.seed = kBenchmarkSeed;
+	configuration.numberOfThreads = numberOfThreads;
+	streamingStatisticsInit(&statistics);
+
+	start = getMonotonicTimeInSeconds();
+	ret = monteCarloRunStreaming(&configuration, 0, numberOfIterations, &statistics);
+	seconds = getMonotonicTimeInSeconds() - start;
+
+	if (ret == kCommonConstantReturnTypeSuccess)
+	{
+		printf(
+			"{\"mode\": \"monte-carlo\", \"iterations\": %zu, \"threads\": %zu, \"seconds\": %.9g, \"iterationsPerSecond\": %.6g, \"nsPerIteration\": %.6g}",
+			numberOfIterations,
+			monteCarloResolveNumberOfThreads(numberOfThreads),
+			seconds,
+			numberOfIterations / seconds,
+			1e9 * seconds / numberOfIterations);
+	}
+
+	streamingStatisticsFree(&statistics);
+
+	return ret;
+}
+
+/**
+ *	@brief  Times a frame-level Monte Carlo run, with calibration draws shared by all pixels,
+ *		and prints the result as a JSON object.
+ *
+ *	@param  width			: Frame width in pixels.
+ *	@param  height			: Frame height in pixels.
+ *	@param  numberOfIterations	: Number of Monte Carlo iterations.
+ *	@param  numberOfThreads		: Number of worker threads, zero for all processors.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+benchmarkMonteCarloFrame(size_t width, size_t height, size_t numberOfIterations, size_t numberOfThreads)
+{
+	MonteCarloConfiguration		configuration;
+	MonteCarloFrame			frame;
+	MonteCarloFrameResult		result = {0};
+	CommonConstantReturnType	ret;
+	size_t				numberOfPixels = width * height;
+	uint16_t *			rawCounts = (uint16_t *) checkedMalloc(numberOfPixels * sizeof(uint16_t), __FILE__, __LINE__);
+	double				start;
+	double				seconds;
+
+	fillBenchmarkFrame(rawCounts, numberOfPixels);
+	monteCarloConfigurationSetDefaults(&configuration);
+	configuration.seed = kBenchmarkSeed;
+	configuration.numberOfThreads = numberOfThreads;
+	frame = (MonteCarloFrame) { .rawCounts = rawCounts, .width = width, .height = height, .strideInPixels = width };
+	result.pixelMeans = (double *) checkedMalloc(numberOfPixels * sizeof(double), __FILE__, __LINE__);
+	result.pixelStandardDeviations = (double *) checkedMalloc(numberOfPixels * sizeof(double), __FILE__, __LINE__);
+	streamingStatisticsInit(&result.frameMeans);
+
+	start = getMonotonicTimeInSeconds();
+	ret = monteCarloRunFrame(&configuration, 0, numberOfIterations, &frame, &result);
+	seconds = getMonotonicTimeInSeconds() - start;
+
+	if (ret == kCommonConstantReturnTypeSuccess)
+	{
+		printf(
+			"{\"mode\": \"monte-carlo-frame\", \"width\": %zu, \"height\": %zu, \"iterations\": %zu, \"threads\": %zu, \"seconds\": %.9g, \"iterationsPerSecond\": %.6g, \"nsPerPixelIteration\": %.6g}",
+			width,
+			height,
+			numberOfIterations,
+			monteCarloResolveNumberOfThreads(numberOfThreads),
+			seconds,
+			numberOfIterations / seconds,
+			1e9 * seconds / (numberOfIterations * numberOfPixels));
+	}
+
+	streamingStatisticsFree(&result.frameMeans);
+	free(result.pixelStandardDeviations);
+	free(result.pixelMeans);
+	free(rawCounts);
+
+	return ret;
+}
+
+static void
+printBenchmarkUsage(void)
+{
+	fprintf(stderr, "FLIR Ax5 conversion routines benchmark suite.\n");
+	fprintf(stderr, "Usage: Valid command-line arguments are:\n");
+	fprintf(
+		stderr,
+		"\t[-q, --quick] (Divide the work of every measurement by %d.)\n"
+		"\t[-h, --help] (Display this help message.)\n",
+		kBenchmarkQuickDivisor);
+
+	return;
+}
+
+int
+main(int argc, char *  argv[])
+{
+	CalibrationParameters	nominalParameters;
+	CalibrationContext	nominalContext = {0};
+	CountsLookupTable	lookupTable = {0};
+	MaterialTable *		materialTable;
+	size_t			workDivisor = 1;
+	bool			isFirst = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-q") == 0) || (strcmp(argv[i], "--quick") == 0))
+		{
+			workDivisor = kBenchmarkQuickDivisor;
+		}
+		else if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0))
+		{
+			printBenchmarkUsage();
+
+			return 0;
+		}
+		else
+		{
+			fprintf(stderr, "Error: Unknown argument \"%s\".\n", argv[i]);
+			printBenchmarkUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	calibrationParametersSetNominal(&nominalParameters);
+	calibrationContextUpdate(&nominalContext, &nominalParameters);
+
+	if (countsLookupTableBuild(&lookupTable, &nominalContext) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Material 0 keeps the calibration; the others are less emissive.
+	 */
+	materialTable = (MaterialTable *) checkedMalloc(sizeof(MaterialTable), __FILE__, __LINE__);
+	materialTableInit(materialTable);
+	for (size_t m = 1; m < kBenchmarkNumberOfMaterials; m++)
+	{
+		materialTableSetParameter(materialTable, (uint8_t) m, kCalibrationParameterIndexEmiss, nominalParameters.values[kCalibrationParameterIndexEmiss] - 0.1 * m);
+	}
+
+	printf("{\n");
+	printf("\"benchmark\": \"FLIR Ax5 conversion routines\",\n");
+#ifdef __VERSION__
+	printf("\"compiler\": \"%s\",\n", __VERSION__);
+#endif
+	printf("\"vectorizedKernel\": \"%s\",\n", getVectorizedConversionKernelName(getVectorizedConversionKernel()));
+	printf("\"numberOfProcessors\": %zu,\n", monteCarloResolveNumberOfThreads(0));
+	printf("\"lookupTableBuildSeconds\": %.9g,\n", lookupTable.buildTimeSeconds);
+	printf("\"results\": [\n");
+
+	for (size_t s = 0; s < kBenchmarkNumberOfFrameSizes; s++)
+	{
+		for (int mode = 0; mode < kBenchmarkFrameModeMax; mode++)
+		{
+			printf(isFirst ? "\t" : ",\n\t");
+			isFirst = false;
+
+			if (benchmarkFrameConversion(
+				(BenchmarkFrameMode) mode,
+				&nominalContext,
+				&lookupTable,
+				materialTable,
+				kBenchmarkFrameSizes[s][0],
+				kBenchmarkFrameSizes[s][1],
+				workDivisor) != kCommonConstantReturnTypeSuccess)
+			{
+				countsLookupTableFree(&lookupTable);
+				free(materialTable);
+
+				return kCommonConstantReturnTypeError;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < kBenchmarkNumberOfMonteCarloIterations; i++)
+	{
+		for (size_t t = 0; t < kBenchmarkNumberOfThreadCounts; t++)
+		{
+			size_t	numberOfIterations = kBenchmarkMonteCarloIterations[i] / workDivisor;
+
+			printf(",\n\t");
+			if (benchmarkMonteCarlo((numberOfIterations > 0) ? numberOfIterations : 1, kBenchmarkThreadCounts[t]) != kCommonConstantReturnTypeSuccess)
+			{
+				countsLookupTableFree(&lookupTable);
+				free(materialTable);
+
+				return kCommonConstantReturnTypeError;
+			}
+		}
+	}
+
+	for (size_t t = 0; t < kBenchmarkNumberOfThreadCounts; t++)
+	{
+		size_t	numberOfIterations = kBenchmarkFrameMonteCarloIterations / workDivisor;
+
+		printf(",\n\t");
+		if (benchmarkMonteCarloFrame(
+			kBenchmarkFrameSizes[0][0],
+			kBenchmarkFrameSizes[0][1],
+			(numberOfIterations > 0) ? numberOfIterations : 1,
+			kBenchmarkThreadCounts[t]) != kCommonConstantReturnTypeSuccess)
+		{
+			countsLookupTableFree(&lookupTable);
+			free(materialTable);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	printf("\n]\n}\n");
+
+	countsLookupTableFree(&lookupTable);
+	free(materialTable);
+
+	return 0;
+}
@@ -0,0 +1,322 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "common.h"
+#include "calibration.h"
+#include "calibration-profile.h"
+
+static const char *	kCalibrationProfileDefaultName = "default";
+static const char *	kCalibrationProfileKeyword = "profile";
+static const char *	kCalibrationProfileSeparators = " \t\r\n";
+
+/*
+ *	Starts a profile with the built-in values of `utilities-config.h`.
+ */
+static void
+calibrationProfileInitDefault(CalibrationProfile *  profile, const char *  name)
+{
+	snprintf(profile->name, sizeof(profile->name), "%s", name);
+	calibrationParametersSetNominal(&profile->nominalParameters);
+	calibrationParametersSetHalfWidths(&profile->parameterHalfWidths);
+
+	return;
+}
+
+/*
+ *	Builds the nominal context of a profile and checks that it gives a finite conversion.
+ */
+static CommonConstantReturnType
+calibrationProfileBuild(CalibrationProfile *  profile)
+{
+	CalibrationContext *	context = &profile->nominalContext;
+
+	context->hasExplicitParameters = false;
+	calibrationContextUpdate(context, &profile->nominalParameters);
+	if (!isfinite(context->K1) || !isfinite(context->K2) || !isfinite(context->countsGain))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Strips a `#` comment and returns the first token of a line, or NULL for a blank line.
+ */
+static char *
+calibrationProfileFirstToken(char *  line)
+{
+	char *	comment = strchr(line, '#');
+
+	if (comment != NULL)
+	{
+		*comment = '\0';
+	}
+
+	return strtok(line, kCalibrationProfileSeparators);
+}
+
+static bool
+calibrationProfileFindParameter(const char *  name, CalibrationParameterIndex *  parameterIndex)
+{
+	for (size_t i = 0; i < kCalibrationParameterIndexMax; i++)
+	{
+		if (strcmp(name, calibrationParameterGetName((CalibrationParameterIndex)i)) == 0)
+		{
+			*parameterIndex = (CalibrationParameterIndex)i;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ *	Parses the tokens after the first one of a parameter line into a profile.
+ */
+static CommonConstantReturnType
+calibrationProfileParseParameter(
+	CalibrationProfile *	profile,
+	const char *		parameterName,
+	const char *		path,
+	size_t			lineNumber)
+{
+	CalibrationParameterIndex	parameterIndex;
+	const char *			nominalToken = strtok(NULL, kCalibrationProfileSeparators);
+	const char *			halfWidthToken = (nominalToken != NULL) ? strtok(NULL, kCalibrationProfileSeparators) : NULL;
+	double				nominal;
+	double				halfWidth = 0;
+
+	if (!calibrationProfileFindParameter(parameterName, &parameterIndex))
+	{
+		fprintf(stderr, "Error: %s:%zu: Unknown calibration parameter \"%s\".\n", path, lineNumber, parameterName);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((nominalToken == NULL) ||
+		(strtok(NULL, kCalibrationProfileSeparators) != NULL) ||
+		(parseDoubleChecked(nominalToken, &nominal) != kCommonConstantReturnTypeSuccess) ||
+		!isfinite(nominal) ||
+		((halfWidthToken != NULL) &&
+			((parseDoubleChecked(halfWidthToken, &halfWidth) != kCommonConstantReturnTypeSuccess) ||
+			!isfinite(halfWidth) || (halfWidth < 0))))
+	{
+		fprintf(stderr, "Error: %s:%zu: Expected \"%s <nominal> [<half-width>]\", with a finite nominal value and a non-negative half-width.\n", path, lineNumber, parameterName);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	profile->nominalParameters.values[parameterIndex] = nominal;
+	profile->parameterHalfWidths.values[parameterIndex] = halfWidth;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Parses the lines of a profile file into `set->profiles`, which has room for
+ *	every `profile` line of the file.
+ */
+static CommonConstantReturnType
+calibrationProfileSetParse(CalibrationProfileSet *  set, FILE *  inputFile, const char *  path)
+{
+	char			line[kCalibrationProfileMaximumLineLength];
+	size_t			lineNumber = 0;
+	CalibrationProfile *	profile = NULL;
+
+	while (fgets(line, sizeof(line), inputFile) != NULL)
+	{
+		char *	token;
+
+		lineNumber++;
+		if ((strchr(line, '\n') == NULL) && !feof(inputFile))
+		{
+			fprintf(stderr, "Error: %s:%zu: Line is longer than %d characters.\n", path, lineNumber, kCalibrationProfileMaximumLineLength - 2);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		token = calibrationProfileFirstToken(line);
+		if (token == NULL)
+		{
+			continue;
+		}
+
+		if (strcmp(token, kCalibrationProfileKeyword) == 0)
+		{
+			const char *	name = strtok(NULL, kCalibrationProfileSeparators);
+
+			if ((name == NULL) || (strtok(NULL, kCalibrationProfileSeparators) != NULL) ||
+				(strlen(name) >= kCalibrationProfileMaximumNameLength))
+			{
+				fprintf(stderr, "Error: %s:%zu: Expected \"profile <name>\", with a name of at most %d characters.\n", path, lineNumber, kCalibrationProfileMaximumNameLength - 1);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			if (calibrationProfileSetFind(set, name) != NULL)
+			{
+				fprintf(stderr, "Error: %s:%zu: Calibration profile \"%s\" is defined more than once.\n", path, lineNumber, name);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			profile = &set->profiles[set->numberOfProfiles++];
+			calibrationProfileInitDefault(profile, name);
+
+			continue;
+		}
+
+		if (profile == NULL)
+		{
+			fprintf(stderr, "Error: %s:%zu: Calibration parameters must follow a \"profile <name>\" line.\n", path, lineNumber);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (calibrationProfileParseParameter(profile, token, path, lineNumber) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (ferror(inputFile))
+	{
+		fprintf(stderr, "Error: Could not read calibration profile file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t i = 0; i < set->numberOfProfiles; i++)
+	{
+		if (calibrationProfileBuild(&set->profiles[i]) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: Calibration profile \"%s\" of \"%s\" does not give a finite conversion.\n", set->profiles[i].name, path);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+calibrationProfileSetInitDefault(CalibrationProfileSet *  set)
+{
+	set->profiles = (CalibrationProfile *) checkedMalloc(sizeof(CalibrationProfile), __FILE__, __LINE__);
+	set->numberOfProfiles = 1;
+	calibrationProfileInitDefault(&set->profiles[0], kCalibrationProfileDefaultName);
+	calibrationProfileBuild(&set->profiles[0]);
+
+	return;
+}
+
+CommonConstantReturnType
+calibrationProfileSetLoad(CalibrationProfileSet *  set, const char *  path)
+{
+	FILE *				inputFile;
+	char				line[kCalibrationProfileMaximumLineLength];
+	size_t				maximumNumberOfProfiles = 0;
+	CommonConstantReturnType	result;
+
+	set->profiles = NULL;
+	set->numberOfProfiles = 0;
+
+	inputFile = fopen(path, "r");
+	if (inputFile == NULL)
+	{
+		fprintf(stderr, "Error: Could not open calibration profile file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Count the `profile` lines first, so that the profiles are one array
+	 *	that frames index in constant time.
+	 */
+	while (fgets(line, sizeof(line), inputFile) != NULL)
+	{
+		const char *	token = calibrationProfileFirstToken(line);
+
+		if ((token != NULL) && (strcmp(token, kCalibrationProfileKeyword) == 0))
+		{
+			maximumNumberOfProfiles++;
+		}
+	}
+
+	if (maximumNumberOfProfiles == 0)
+	{
+		fprintf(stderr, "Error: Calibration profile file \"%s\" defines no profiles.\n", path);
+		fclose(inputFile);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	rewind(inputFile);
+	set->profiles = (CalibrationProfile *) checkedMalloc(maximumNumberOfProfiles * sizeof(CalibrationProfile), __FILE__, __LINE__);
+	result = calibrationProfileSetParse(set, inputFile, path);
+	fclose(inputFile);
+
+	if (result != kCommonConstantReturnTypeSuccess)
+	{
+		calibrationProfileSetFree(set);
+	}
+
+	return result;
+}
+
+void
+calibrationProfileSetFree(CalibrationProfileSet *  set)
+{
+	free(set->profiles);
+	set->profiles = NULL;
+	set->numberOfProfiles = 0;
+
+	return;
+}
+
+const CalibrationProfile *
+calibrationProfileSetGet(const CalibrationProfileSet *  set, size_t index)
+{
+	return (index < set->numberOfProfiles) ? &set->profiles[index] : NULL;
+}
+
+const CalibrationProfile *
+calibrationProfileSetFind(const CalibrationProfileSet *  set, const char *  name)
+{
+	for (size_t i = 0; i < set->numberOfProfiles; i++)
+	{
+		if (strcmp(set->profiles[i].name, name) == 0)
+		{
+			return &set->profiles[i];
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,117 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration.h"
+
+/*
+ *	Calibration profiles are loaded at startup from a text file, so one binary
+ *	serves cameras with different calibrations. `#` starts a comment. A line
+ *	`profile <name>` starts a profile, which begins with the built-in values
+ *	of `utilities-config.h`. Each following line `<parameter> <nominal> [<half-width>]`
+ *	overrides one parameter, named as in `calibrationParameterGetName()`, with a
+ *	uniform distribution on [nominal - half-width, nominal + half-width], or the
+ *	exact nominal value if the half-width is omitted:
+ *
+ *		profile ax5-lab
+ *		B	1428.0	0.05
+ *		J0	89.796	0.0005
+ *		R	16556
+ *
+ *	Profiles are numbered from zero in file order. Camera-tagged raw frame
+ *	files refer to them by that number.
+ */
+typedef enum
+{
+	kCalibrationProfileMaximumNameLength	= 64,
+	kCalibrationProfileMaximumLineLength	= 512,
+} CalibrationProfileConstant;
+
+typedef struct
+{
+	char			name[kCalibrationProfileMaximumNameLength];
+	CalibrationParameters	nominalParameters;
+	CalibrationParameters	parameterHalfWidths;
+	/*
+	 *	Built when the profile is loaded, so that converting a frame with the
+	 *	profile needs no `pow()` evaluations.
+	 */
+	CalibrationContext	nominalContext;
+} CalibrationProfile;
+
+typedef struct
+{
+	CalibrationProfile *	profiles;
+	size_t			numberOfProfiles;
+} CalibrationProfileSet;
+
+/**
+ *	@brief  Initializes a set holding a single profile, "default", with the built-in values of
+ *		`utilities-config.h`.
+ *
+ *	@param  set		: Pointer to the set to initialize. Free with `calibrationProfileSetFree()`.
+ */
+void	calibrationProfileSetInitDefault(CalibrationProfileSet *  set);
+
+/**
+ *	@brief  Loads the profiles of a calibration profile file and builds the nominal calibration
+ *		context of each.
+ *
+ *	@param  set		: Pointer to the set to load. Free with `calibrationProfileSetFree()`,
+ *				  only if loading succeeded.
+ *	@param  path		: Path of the profile file.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	calibrationProfileSetLoad(CalibrationProfileSet *  set, const char *  path);
+
+/**
+ *	@brief  Frees the profiles of a set.
+ *
+ *	@param  set		: Pointer to the set.
+ */
+void	calibrationProfileSetFree(CalibrationProfileSet *  set);
+
+/**
+ *	@brief  Returns the profile with a given number, in constant time.
+ *
+ *	@param  set		: Pointer to the set.
+ *	@param  index		: The number of the profile.
+ *
+ *	@return			: Pointer to the profile, or NULL if the set has no such profile.
+ */
+const CalibrationProfile *	calibrationProfileSetGet(const CalibrationProfileSet *  set, size_t index);
+
+/**
+ *	@brief  Returns the profile with a given name. This is a linear search, meant for startup.
+ *
+ *	@param  set		: Pointer to the set.
+ *	@param  name		: The name of the profile.
+ *
+ *	@return			: Pointer to the profile, or NULL if the set has no such profile.
+ */
+const CalibrationProfile *	calibrationProfileSetFind(const CalibrationProfileSet *  set, const char *  name);
@@ -0,0 +1,231 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+#include <uxhw.h>
+#include "utilities-config.h"
+#include "calibration.h"
+
+static const char *	kCalibrationParameterNames[kCalibrationParameterIndexMax] =
+			{
+				[kCalibrationParameterIndexEmiss]			= "Emiss",
+				[kCalibrationParameterIndexTRefl]			= "TRefl",
+				[kCalibrationParameterIndexTAtmC]			= "TAtmC",
+				[kCalibrationParameterIndexTau]				= "Tau",
+				[kCalibrationParameterIndexTExtOptics]			= "TExtOptics",
+				[kCalibrationParameterIndexTransmissionExtOptics]	= "TransmissionExtOptics",
+				[kCalibrationParameterIndexR]				= "R",
+				[kCalibrationParameterIndexB]				= "B",
+				[kCalibrationParameterIndexF]				= "F",
+				[kCalibrationParameterIndexJ1]				= "J1",
+				[kCalibrationParameterIndexJ0]				= "J0",
+			};
+
+static void
+calibrationContextFoldCountsTerms(CalibrationContext *  context)
+{
+	/*
+	 *	Fold `K1 * ((counts - J0) / J1) - K2` into `countsGain * counts - countsOffset`,
+	 *	so that per-count work before the division and `log` is a single multiply and subtract.
+	 */
+	context->countsGain	= context->K1 * context->oneOverJ1;
+	context->countsOffset	= context->countsGain * context->J0 + context->K2;
+
+	return;
+}
+
+void
+calibrationParametersSetNominal(CalibrationParameters *  parameters)
+{
+	double *	p = parameters->values;
+
+	p[kCalibrationParameterIndexEmiss]			= kFLIRobjectParameterEmissNominal;
+	p[kCalibrationParameterIndexTRefl]			= kFLIRobjectParameterTReflNominal;
+	p[kCalibrationParameterIndexTAtmC]			= kFLIRatmosphericAttenuationParameterTAtmCNominal;
+	p[kCalibrationParameterIndexTau]			= kFLIRatmosphericAttenuationParameterTauNominal;
+	p[kCalibrationParameterIndexTExtOptics]			= kFLIRexternalOpticsParameterTExtOptics;
+	p[kCalibrationParameterIndexTransmissionExtOptics]	= kFLIRexternalOpticsParameterTransmissionExtOpticsNominal;
+	p[kCalibrationParameterIndexR]				= kFLIRcameraAx5CalibrationParameterR;
+	p[kCalibrationParameterIndexB]				= kFLIRcameraAx5CalibrationParameterBNominal;
+	p[kCalibrationParameterIndexF]				= kFLIRcameraAx5CalibrationParameterFNominal;
+	p[kCalibrationParameterIndexJ1]				= kFLIRcameraAx5CalibrationParameterJ1Nominal;
+	p[kCalibrationParameterIndexJ0]				= kFLIRcameraAx5CalibrationParameterJ0Nominal;
+
+	return;
+}
+
+void
+calibrationParametersSetHalfWidths(CalibrationParameters *  halfWidths)
+{
+	double *	h = halfWidths->values;
+
+	h[kCalibrationParameterIndexEmiss]			= kFLIRobjectParameterEmissHalfWidth;
+	h[kCalibrationParameterIndexTRefl]			= kFLIRobjectParameterTReflHalfWidth;
+	h[kCalibrationParameterIndexTAtmC]			= kFLIRatmosphericAttenuationParameterTAtmCHalfWidth;
+	h[kCalibrationParameterIndexTau]			= kFLIRatmosphericAttenuationParameterTauHalfWidth;
+	h[kCalibrationParameterIndexTExtOptics]			= 0;
+	h[kCalibrationParameterIndexTransmissionExtOptics]	= kFLIRexternalOpticsParameterTransmissionExtOpticsHalfWidth;
+	h[kCalibrationParameterIndexR]				= 0;
+	h[kCalibrationParameterIndexB]				= kFLIRcameraAx5CalibrationParameterBHalfWidth;
+	h[kCalibrationParameterIndexF]				= kFLIRcameraAx5CalibrationParameterFHalfWidth;
+	h[kCalibrationParameterIndexJ1]				= kFLIRcameraAx5CalibrationParameterJ1HalfWidth;
+	h[kCalibrationParameterIndexJ0]				= kFLIRcameraAx5CalibrationParameterJ0HalfWidth;
+
+	return;
+}
+
+const char *
+calibrationParameterGetName(CalibrationParameterIndex parameterIndex)
+{
+	return (parameterIndex < kCalibrationParameterIndexMax) ? kCalibrationParameterNames[parameterIndex] : "unknown";
+}
+
+void
+calibrationContextInitFromConfig(CalibrationContext *  context)
+{
+	CalibrationParameters	nominalParameters;
+	CalibrationParameters	halfWidths;
+
+	calibrationParametersSetNominal(&nominalParameters);
+	calibrationParametersSetHalfWidths(&halfWidths);
+	calibrationContextInitFromDistributions(context, &nominalParameters, &halfWidths);
+
+	return;
+}
+
+void
+calibrationContextInitFromDistributions(
+	CalibrationContext *		context,
+	const CalibrationParameters *	nominalParameters,
+	const CalibrationParameters *	halfWidths)
+{
+	CalibrationParameters	parameters;
+
+	/*
+	 *	Each parameter is built exactly once, so every parameter is a single
+	 *	quantity (one UxHw distribution, or one draw natively) that all the
+	 *	terms of the formula share.
+	 */
+	for (size_t i = 0; i < kCalibrationParameterIndexMax; i++)
+	{
+		double	nominal = nominalParameters->values[i];
+		double	halfWidth = halfWidths->values[i];
+
+		parameters.values[i] = (halfWidth > 0) ? kFLIRUniformAboutNominal(nominal, halfWidth) : nominal;
+	}
+
+	context->hasExplicitParameters = false;
+	calibrationContextUpdate(context, &parameters);
+
+	return;
+}
+
+bool
+calibrationContextUpdate(CalibrationContext *  context, const CalibrationParameters *  parameters)
+{
+	const double *	p = parameters->values;
+	double		Emiss;
+	double		Tau;
+	double		TransmissionExtOptics;
+	double		R;
+	double		B;
+	double		F;
+	double		r1;
+	double		r2;
+	double		r3;
+
+	/*
+	 *	Compare bitwise so that a rebuild is skipped only for identical inputs.
+	 */
+	if (context->hasExplicitParameters && (memcmp(&context->parameters, parameters, sizeof(*parameters)) == 0))
+	{
+		return false;
+	}
+
+	Emiss			= p[kCalibrationParameterIndexEmiss];
+	Tau			= p[kCalibrationParameterIndexTau];
+	TransmissionExtOptics	= p[kCalibrationParameterIndexTransmissionExtOptics];
+	R			= p[kCalibrationParameterIndexR];
+	B			= p[kCalibrationParameterIndexB];
+	F			= p[kCalibrationParameterIndexF];
+
+	context->K1	= 1 / (Tau * Emiss * TransmissionExtOptics);
+
+	/*
+	 *	Pseudo radiances of the reflected environment, the atmosphere and the external optics.
+	 */
+	r1	= ((1 - Emiss)/Emiss) * (R / (pow(M_E, B/p[kCalibrationParameterIndexTRefl]) - F));
+	r2	= ((1 - Tau)/(Emiss * Tau)) *
+		  (R / (pow(M_E, B/(p[kCalibrationParameterIndexTAtmC] + kAbsoluteZeroKelvinInCelsius)) - F));
+	r3	= ((1 - TransmissionExtOptics)/(Emiss * Tau * TransmissionExtOptics)) *
+		  (R / (pow(M_E, B/p[kCalibrationParameterIndexTExtOptics]) - F));
+
+	context->K2		= r1 + r2 + r3;
+	context->R		= R;
+	context->B		= B;
+	context->F		= F;
+	context->J0		= p[kCalibrationParameterIndexJ0];
+	context->oneOverJ1	= 1 / p[kCalibrationParameterIndexJ1];
+
+	context->parameters		= *parameters;
+	context->hasExplicitParameters	= true;
+	calibrationContextFoldCountsTerms(context);
+
+	return true;
+}
+
+double
+calibrationContextConvertCounts(const CalibrationContext *  context, double counts)
+{
+	double	signal = (counts - context->J0) * context->oneOverJ1;
+
+	return	(
+			context->B /
+			log(context->R / ((context->K1 * signal) - context->K2) + context->F)
+		) - kAbsoluteZeroKelvinInCelsius;
+}
+
+double
+calibrationContextConvertTemperature(const CalibrationContext *  context, double temperature)
+{
+	/*
+	 *	Solve `temperature + 273.15 = B / log(R / D + F)` for the denominator D, which is
+	 *	`K1 * (counts - J0) / J1 - K2`. Temperatures the conversion only reaches as D grows
+	 *	without bound leave `exp() - F` at or below zero, and every count exceeds absolute zero.
+	 */
+	double	radiance = exp(context->B / (temperature + kAbsoluteZeroKelvinInCelsius)) - context->F;
+
+	if (!(temperature + kAbsoluteZeroKelvinInCelsius > 0))
+	{
+		return -INFINITY;
+	}
+
+	if (!(radiance > 0))
+	{
+		return INFINITY;
+	}
+
+	return (context->R / radiance + context->K2) / (context->K1 * context->oneOverJ1) + context->J0;
+}
@@ -0,0 +1,155 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/*
+ *	Calibration parameters of the FLIR conversion. The enumerator names
+ *	purposefully mimic the names used in the reference example by FLIR.
+ */
+typedef enum
+{
+	kCalibrationParameterIndexEmiss				= 0,
+	kCalibrationParameterIndexTRefl,
+	kCalibrationParameterIndexTAtmC,
+	kCalibrationParameterIndexTau,
+	kCalibrationParameterIndexTExtOptics,
+	kCalibrationParameterIndexTransmissionExtOptics,
+	kCalibrationParameterIndexR,
+	kCalibrationParameterIndexB,
+	kCalibrationParameterIndexF,
+	kCalibrationParameterIndexJ1,
+	kCalibrationParameterIndexJ0,
+	kCalibrationParameterIndexMax,
+} CalibrationParameterIndex;
+
+typedef struct
+{
+	double	values[kCalibrationParameterIndexMax];
+} CalibrationParameters;
+
+/*
+ *	Count-independent terms of the FLIR conversion. Once built, converting
+ *	a count needs no `pow()` evaluations and no divisions other than the
+ *	ones inside the final `log()` expression.
+ */
+typedef struct
+{
+	/*
+	 *	`parameters` holds the values the context was last built from. It is
+	 *	only meaningful when `hasExplicitParameters` is true.
+	 */
+	CalibrationParameters	parameters;
+	bool			hasExplicitParameters;
+	double			K1;
+	double			K2;
+	double			R;
+	double			B;
+	double			F;
+	double			J0;
+	double			oneOverJ1;
+	double			countsGain;
+	double			countsOffset;
+} CalibrationContext;
+
+/**
+ *	@brief  Sets calibration parameters to the nominal (centre) values of the `kFLIR*` definitions.
+ *
+ *	@param  parameters	: Pointer to the parameters to set.
+ */
+void	calibrationParametersSetNominal(CalibrationParameters *  parameters);
+
+/**
+ *	@brief  Sets calibration parameters to the half-widths of the uniform distributions of the
+ *		`kFLIR*` definitions. Parameters without uncertainty get a half-width of zero.
+ *
+ *	@param  halfWidths	: Pointer to the parameters to set.
+ */
+void	calibrationParametersSetHalfWidths(CalibrationParameters *  halfWidths);
+
+/**
+ *	@brief  Returns the name of a calibration parameter, as used in the FLIR reference example.
+ *
+ *	@param  parameterIndex	: The index of the parameter.
+ *
+ *	@return			: The name of the parameter.
+ */
+const char *	calibrationParameterGetName(CalibrationParameterIndex parameterIndex);
+
+/**
+ *	@brief  Builds a calibration context from the `kFLIR*` definitions in `utilities-config.h`.
+ *		Each uncertain parameter is sampled once per call and is the same quantity in every
+ *		term of the formula.
+ *
+ *	@param  context		: Pointer to the context to build.
+ */
+void	calibrationContextInitFromConfig(CalibrationContext *  context);
+
+/**
+ *	@brief  Builds a calibration context from nominal values and the half-widths of uniform
+ *		distributions about them. Parameters with a zero half-width are exact. Each uncertain
+ *		parameter is sampled once per call and is the same quantity in every term of the formula.
+ *
+ *	@param  context			: Pointer to the context to build.
+ *	@param  nominalParameters	: The nominal (centre) values of the parameters.
+ *	@param  halfWidths		: The half-widths of the uniform distributions.
+ */
+void	calibrationContextInitFromDistributions(
+		CalibrationContext *		context,
+		const CalibrationParameters *	nominalParameters,
+		const CalibrationParameters *	halfWidths);
+
+/**
+ *	@brief  Rebuilds a calibration context from explicit parameter values, if they differ from
+ *		the values the context was last built from.
+ *
+ *	@param  context		: Pointer to the context to update.
+ *	@param  parameters	: The calibration parameter values.
+ *
+ *	@return			: `true` if the context was rebuilt, `false` if it was already up to date.
+ */
+bool	calibrationContextUpdate(CalibrationContext *  context, const CalibrationParameters *  parameters);
+
+/**
+ *	@brief  Converts a single raw count to a calibrated temperature using a built context.
+ *
+ *	@param  context		: Pointer to the calibration context.
+ *	@param  counts		: The raw radiometric count.
+ *
+ *	@return			: The calibrated temperature.
+ */
+double	calibrationContextConvertCounts(const CalibrationContext *  context, double counts);
+
+/**
+ *	@brief  Inverts `calibrationContextConvertCounts()`: returns the raw count whose calibrated
+ *		temperature is `temperature`. The conversion increases with the count wherever it is
+ *		defined, so comparing counts with the result compares their temperatures with `temperature`.
+ *
+ *	@param  context		: Pointer to the calibration context.
+ *	@param  temperature	: The calibrated temperature.
+ *
+ *	@return			: The raw count, not rounded, +infinity if no count reaches `temperature`, or
+ *				  -infinity if `temperature` is at or below absolute zero.
+ */
+double	calibrationContextConvertTemperature(const CalibrationContext *  context, double temperature);
@@ -1,4 +1,28 @@
 SOURCES =\
 	main.c\
 	common.c\
-	utilities.c
+	utilities.c\
+	conversion.c\
+	conversion-vectorized.c\
+	conversion-float32.c\
+	calibration.c\
+	calibration-profile.c\
+	material-map.c\
+	lookup-table.c\
+	timing.c\
+	stream-io.c\
+	random.c\
+	monte-carlo.c\
+	streaming-statistics.c\
+	raw-frames.c\
+	frame-pipeline.c\
+	conversion-server.c\
+	delta-method.c\
+	alarm-thresholds.c\
+	incremental-conversion.c\
+	region-statistics.c\
+	instrumentation.c\
+	sample-file.c\
+	json-writer.c\
+	exceedance.c\
+	quasi-random.c
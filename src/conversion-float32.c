@@ -0,0 +1,432 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "common.h"
+#include "utilities-config.h"
+#include "calibration.h"
+#include "conversion.h"
+#include "timing.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define kConversionFloat32HaveX86Kernels	(1)
+#include <immintrin.h>
+#else
+#define kConversionFloat32HaveX86Kernels	(0)
+#endif
+
+/*
+ *	Single-precision copy of the count-dependent terms of a calibration context.
+ *	`countsGain * counts - countsOffset` cancels heavily near the bottom of the
+ *	radiometric range, which float32 cannot afford. It is evaluated instead as
+ *	`countsGain * ((counts - countsZeroHigh) - countsZeroLow)`, where the count
+ *	of zero signal, `countsOffset / countsGain`, is split into two floats. The
+ *	first subtraction is exact near the zero, so the signal keeps its relative
+ *	precision all the way down to it.
+ */
+typedef struct
+{
+	float	countsGain;
+	float	countsZeroHigh;
+	float	countsZeroLow;
+	float	R;
+	float	B;
+	float	F;
+} Float32ConversionTerms;
+
+typedef enum
+{
+	kFloat32ConversionAllCounts		= 65536,
+	/*
+	 *	`measureFloat32ConversionError()` times each kernel over this many
+	 *	conversions of all 65536 counts.
+	 */
+	kFloat32ConversionTimingRepetitions	= 64,
+} Float32ConversionConstant;
+
+static void
+float32ConversionTermsInit(Float32ConversionTerms *  terms, const CalibrationContext *  context)
+{
+	double	countsZero = context->countsOffset / context->countsGain;
+
+	terms->countsGain	= (float) context->countsGain;
+	terms->countsZeroHigh	= (float) countsZero;
+	terms->countsZeroLow	= (float) (countsZero - (double) terms->countsZeroHigh);
+	terms->R		= (float) context->R;
+	terms->B		= (float) context->B;
+	terms->F		= (float) context->F;
+
+	return;
+}
+
+static inline float
+convertCountsScalarFloat32(const Float32ConversionTerms *  terms, uint16_t counts)
+{
+	float	signal = terms->countsGain * (((float) counts - terms->countsZeroHigh) - terms->countsZeroLow);
+
+	return (terms->B / logf(terms->R / signal + terms->F)) - (float) kAbsoluteZeroKelvinInCelsius;
+}
+
+#if kConversionFloat32HaveX86Kernels
+/*
+ *	Vectorized single-precision natural logarithm, after Cephes `logf()`:
+ *	reduction of the mantissa to [sqrt(2)/2, sqrt(2)) and a degree-8
+ *	polynomial, with a documented error below 1 ULP over the normal range.
+ *	Lanes outside the normal positive finite range are recomputed by the
+ *	caller through libm.
+ */
+static const float	kLogfSqrtHalf	= 0.707106781186547524f;
+static const float	kLogfP0		= 7.0376836292e-2f;
+static const float	kLogfP1		= -1.1514610310e-1f;
+static const float	kLogfP2		= 1.1676998740e-1f;
+static const float	kLogfP3		= -1.2420140846e-1f;
+static const float	kLogfP4		= 1.4249322787e-1f;
+static const float	kLogfP5		= -1.6668057665e-1f;
+static const float	kLogfP6		= 2.0000714765e-1f;
+static const float	kLogfP7		= -2.4999993993e-1f;
+static const float	kLogfP8		= 3.3333331174e-1f;
+static const float	kLogfLn2Low	= -2.12194440e-4f;
+static const float	kLogfLn2High	= 0.693359375f;
+
+/*
+ *	Mantissa bits, and the exponent bits of 0.5, which place the mantissa in [0.5, 1).
+ */
+static const int32_t	kLogfMantissaMask	= 0x007FFFFF;
+static const int32_t	kLogfHalfBits		= 0x3F000000;
+static const int32_t	kLogfExponentBias	= 126;
+
+__attribute__((target("avx2,fma")))
+static inline __m256
+logfAVX2(__m256 x)
+{
+	__m256i	bits = _mm256_castps_si256(x);
+	__m256	e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(kLogfExponentBias)));
+	__m256	m = _mm256_castsi256_ps(
+			_mm256_or_si256(
+				_mm256_and_si256(bits, _mm256_set1_epi32(kLogfMantissaMask)),
+				_mm256_set1_epi32(kLogfHalfBits)));
+	__m256	isSmall = _mm256_cmp_ps(m, _mm256_set1_ps(kLogfSqrtHalf), _CMP_LT_OQ);
+	__m256	z;
+	__m256	y;
+
+	/*
+	 *	m in [sqrt(2)/2, sqrt(2)) after doubling the small ones, and f = m - 1.
+	 */
+	e = _mm256_sub_ps(e, _mm256_and_ps(isSmall, _mm256_set1_ps(1.0f)));
+	m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(isSmall, m)), _mm256_set1_ps(1.0f));
+	z = _mm256_mul_ps(m, m);
+
+	y = _mm256_set1_ps(kLogfP0);
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP1));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP2));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP3));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP4));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP5));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP6));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP7));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogfP8));
+	y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+
+	y = _mm256_fmadd_ps(e, _mm256_set1_ps(kLogfLn2Low), y);
+	y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+
+	return _mm256_fmadd_ps(e, _mm256_set1_ps(kLogfLn2High), _mm256_add_ps(m, y));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512
+logfAVX512(__m512 x)
+{
+	__m512i		bits = _mm512_castps_si512(x);
+	__m512		e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(kLogfExponentBias)));
+	__m512		m = _mm512_castsi512_ps(
+				_mm512_or_si512(
+					_mm512_and_si512(bits, _mm512_set1_epi32(kLogfMantissaMask)),
+					_mm512_set1_epi32(kLogfHalfBits)));
+	__mmask16	isSmall = _mm512_cmp_ps_mask(m, _mm512_set1_ps(kLogfSqrtHalf), _CMP_LT_OQ);
+	__m512		z;
+	__m512		y;
+
+	e = _mm512_mask_sub_ps(e, isSmall, e, _mm512_set1_ps(1.0f));
+	m = _mm512_sub_ps(_mm512_mask_add_ps(m, isSmall, m, m), _mm512_set1_ps(1.0f));
+	z = _mm512_mul_ps(m, m);
+
+	y = _mm512_set1_ps(kLogfP0);
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP1));
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP2));
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP3));
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP4));
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP5));
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP6));
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP7));
+	y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogfP8));
+	y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+
+	y = _mm512_fmadd_ps(e, _mm512_set1_ps(kLogfLn2Low), y);
+	y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+
+	return _mm512_fmadd_ps(e, _mm512_set1_ps(kLogfLn2High), _mm512_add_ps(m, y));
+}
+
+__attribute__((target("avx2,fma")))
+static void
+convertRowFloat32AVX2(const Float32ConversionTerms *  terms, const uint16_t *  rawCounts, size_t width, float *  temperatures)
+{
+	const __m256	gain = _mm256_set1_ps(terms->countsGain);
+	const __m256	zeroHigh = _mm256_set1_ps(terms->countsZeroHigh);
+	const __m256	zeroLow = _mm256_set1_ps(terms->countsZeroLow);
+	const __m256	R = _mm256_set1_ps(terms->R);
+	const __m256	F = _mm256_set1_ps(terms->F);
+	const __m256	B = _mm256_set1_ps(terms->B);
+	const __m256	absoluteZero = _mm256_set1_ps((float) kAbsoluteZeroKelvinInCelsius);
+	const __m256	smallestNormal = _mm256_set1_ps(FLT_MIN);
+	const __m256	largestFinite = _mm256_set1_ps(FLT_MAX);
+	size_t		column = 0;
+
+	for (; column + 8 <= width; column += 8)
+	{
+		__m256	counts;
+		__m256	y;
+		__m256	isNormal;
+
+		counts = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &rawCounts[column])));
+		y = _mm256_add_ps(_mm256_div_ps(R, _mm256_mul_ps(gain, _mm256_sub_ps(_mm256_sub_ps(counts, zeroHigh), zeroLow))), F);
+		_mm256_storeu_ps(&temperatures[column], _mm256_sub_ps(_mm256_div_ps(B, logfAVX2(y)), absoluteZero));
+
+		isNormal = _mm256_and_ps(
+				_mm256_cmp_ps(y, smallestNormal, _CMP_GE_OQ),
+				_mm256_cmp_ps(y, largestFinite, _CMP_LE_OQ));
+		if (_mm256_movemask_ps(isNormal) != 0xFF)
+		{
+			for (size_t lane = 0; lane < 8; lane++)
+			{
+				temperatures[column + lane] = convertCountsScalarFloat32(terms, rawCounts[column + lane]);
+			}
+		}
+	}
+
+	for (; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalarFloat32(terms, rawCounts[column]);
+	}
+
+	return;
+}
+
+__attribute__((target("avx512f,avx2")))
+static void
+convertRowFloat32AVX512(const Float32ConversionTerms *  terms, const uint16_t *  rawCounts, size_t width, float *  temperatures)
+{
+	const __m512	gain = _mm512_set1_ps(terms->countsGain);
+	const __m512	zeroHigh = _mm512_set1_ps(terms->countsZeroHigh);
+	const __m512	zeroLow = _mm512_set1_ps(terms->countsZeroLow);
+	const __m512	R = _mm512_set1_ps(terms->R);
+	const __m512	F = _mm512_set1_ps(terms->F);
+	const __m512	B = _mm512_set1_ps(terms->B);
+	const __m512	absoluteZero = _mm512_set1_ps((float) kAbsoluteZeroKelvinInCelsius);
+	const __m512	smallestNormal = _mm512_set1_ps(FLT_MIN);
+	const __m512	largestFinite = _mm512_set1_ps(FLT_MAX);
+	size_t		column = 0;
+
+	for (; column + 16 <= width; column += 16)
+	{
+		__m512		counts;
+		__m512		y;
+		__mmask16	isNormal;
+
+		counts = _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *) &rawCounts[column])));
+		y = _mm512_add_ps(_mm512_div_ps(R, _mm512_mul_ps(gain, _mm512_sub_ps(_mm512_sub_ps(counts, zeroHigh), zeroLow))), F);
+		_mm512_storeu_ps(&temperatures[column], _mm512_sub_ps(_mm512_div_ps(B, logfAVX512(y)), absoluteZero));
+
+		isNormal = _mm512_cmp_ps_mask(y, smallestNormal, _CMP_GE_OQ) & _mm512_cmp_ps_mask(y, largestFinite, _CMP_LE_OQ);
+		if (isNormal != 0xFFFF)
+		{
+			for (size_t lane = 0; lane < 16; lane++)
+			{
+				temperatures[column + lane] = convertCountsScalarFloat32(terms, rawCounts[column + lane]);
+			}
+		}
+	}
+
+	for (; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalarFloat32(terms, rawCounts[column]);
+	}
+
+	return;
+}
+#endif /* kConversionFloat32HaveX86Kernels */
+
+static void
+convertRowFloat32Scalar(const Float32ConversionTerms *  terms, const uint16_t *  rawCounts, size_t width, float *  temperatures)
+{
+	for (size_t column = 0; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalarFloat32(terms, rawCounts[column]);
+	}
+
+	return;
+}
+
+typedef void (*ConvertRowFloat32Function)(const Float32ConversionTerms *  terms, const uint16_t *  rawCounts, size_t width, float *  temperatures);
+
+/*
+ *	The same runtime selection as the float64 kernels, so both report the same kernel name.
+ */
+static ConvertRowFloat32Function
+selectRowKernelFloat32(void)
+{
+#if kConversionFloat32HaveX86Kernels
+	switch (getVectorizedConversionKernel())
+	{
+		case kVectorizedConversionKernelAVX512:
+			return convertRowFloat32AVX512;
+		case kVectorizedConversionKernelAVX2:
+			return convertRowFloat32AVX2;
+		default:
+			break;
+	}
+#endif
+
+	return convertRowFloat32Scalar;
+}
+
+CommonConstantReturnType
+convertRawCountsFrameToTemperatureFloat32(
+	const CalibrationContext *	context,
+	const uint16_t *		rawCounts,
+	size_t				width,
+	size_t				height,
+	size_t				strideInPixels,
+	float *				temperatures)
+{
+	Float32ConversionTerms		terms;
+	ConvertRowFloat32Function	convertRow;
+
+	if ((context == NULL) || (rawCounts == NULL) || (temperatures == NULL))
+	{
+		fprintf(stderr, "Error: Frame conversion called with a NULL context or frame pointer.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (strideInPixels < width)
+	{
+		fprintf(stderr, "Error: Frame stride (%zu pixels) is smaller than the frame width (%zu pixels).\n", strideInPixels, width);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	float32ConversionTermsInit(&terms, context);
+	convertRow = selectRowKernelFloat32();
+
+	for (size_t row = 0; row < height; row++)
+	{
+		convertRow(&terms, &rawCounts[row * strideInPixels], width, &temperatures[row * width]);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+measureFloat32ConversionError(const CalibrationContext *  context, Float32ConversionErrorReport *  report)
+{
+	uint16_t *	allCounts = (uint16_t *) checkedMalloc(kFloat32ConversionAllCounts * sizeof(uint16_t), __FILE__, __LINE__);
+	double *	float64Temperatures = (double *) checkedMalloc(kFloat32ConversionAllCounts * sizeof(double), __FILE__, __LINE__);
+	float *		float32Temperatures = (float *) checkedMalloc(kFloat32ConversionAllCounts * sizeof(float), __FILE__, __LINE__);
+	double		start;
+
+	memset(report, 0, sizeof(*report));
+	report->kernel = getVectorizedConversionKernel();
+
+	for (size_t i = 0; i < kFloat32ConversionAllCounts; i++)
+	{
+		allCounts[i] = (uint16_t) i;
+	}
+
+	/*
+	 *	Both kernels are run once untimed, so the timings do not include first-touch page faults.
+	 */
+	if ((convertRawCountsFrameToTemperatureVectorized(context, allCounts, kFloat32ConversionAllCounts, 1, kFloat32ConversionAllCounts, float64Temperatures) != kCommonConstantReturnTypeSuccess) ||
+		(convertRawCountsFrameToTemperatureFloat32(context, allCounts, kFloat32ConversionAllCounts, 1, kFloat32ConversionAllCounts, float32Temperatures) != kCommonConstantReturnTypeSuccess))
+	{
+		free(allCounts);
+		free(float64Temperatures);
+		free(float32Temperatures);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	start = getMonotonicTimeInSeconds();
+	for (size_t r = 0; r < kFloat32ConversionTimingRepetitions; r++)
+	{
+		convertRawCountsFrameToTemperatureVectorized(context, allCounts, kFloat32ConversionAllCounts, 1, kFloat32ConversionAllCounts, float64Temperatures);
+	}
+	report->float64NanosecondsPerPixel = 1e9 * (getMonotonicTimeInSeconds() - start) / ((double) kFloat32ConversionTimingRepetitions * kFloat32ConversionAllCounts);
+
+	start = getMonotonicTimeInSeconds();
+	for (size_t r = 0; r < kFloat32ConversionTimingRepetitions; r++)
+	{
+		convertRawCountsFrameToTemperatureFloat32(context, allCounts, kFloat32ConversionAllCounts, 1, kFloat32ConversionAllCounts, float32Temperatures);
+	}
+	report->float32NanosecondsPerPixel = 1e9 * (getMonotonicTimeInSeconds() - start) / ((double) kFloat32ConversionTimingRepetitions * kFloat32ConversionAllCounts);
+
+	/*
+	 *	Counts below the radiometric range are undefined (NaN) in float64. Over the
+	 *	rest, a float32 result that is not finite counts as an infinite error.
+	 */
+	for (size_t i = 0; i < kFloat32ConversionAllCounts; i++)
+	{
+		double	error;
+
+		if (!isfinite(float64Temperatures[i]))
+		{
+			report->numberOfUndefinedCounts++;
+
+			continue;
+		}
+
+		error = isfinite(float32Temperatures[i]) ? fabs((double) float32Temperatures[i] - float64Temperatures[i]) : INFINITY;
+		report->numberOfComparedCounts++;
+		report->numberOfCountsOutsideTolerance += (error > kFloat32ConversionToleranceKelvin);
+
+		if (error > report->maximumAbsoluteError)
+		{
+			report->maximumAbsoluteError = error;
+			report->countsAtMaximumError = i;
+		}
+	}
+
+	report->float64MaximumUlpDifference = measureVectorizedConversionMaximumUlpDifference(context);
+
+	free(allCounts);
+	free(float64Temperatures);
+	free(float32Temperatures);
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,561 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "common.h"
+#include "calibration.h"
+#include "calibration-profile.h"
+#include "conversion.h"
+#include "monte-carlo.h"
+#include "raw-frames.h"
+#include "streaming-statistics.h"
+#include "timing.h"
+#include "stream-io.h"
+#include "conversion-server.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#define kConversionServerHavePosix	(1)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#else
+#define kConversionServerHavePosix	(0)
+#endif
+
+#if kConversionServerHavePosix
+
+static const double	kConversionServerMonteCarloQuantileProbabilities[] = {0.05, 0.50, 0.95};
+
+typedef struct
+{
+	const ConversionServerConfiguration *	configuration;
+	/*
+	 *	The socket of each client being served, or -1 for a free slot.
+	 */
+	int					clientFileDescriptors[kConversionServerMaximumConnections];
+	size_t					numberOfActiveConnections;
+	size_t					numberOfConnections;
+	size_t					numberOfRequests;
+	pthread_mutex_t				mutex;
+	pthread_cond_t				condition;
+} ConversionServer;
+
+typedef struct
+{
+	ConversionServer *	server;
+	size_t			slot;
+	int			fileDescriptor;
+	/*
+	 *	Grown as requests need, and kept for the next request of the connection.
+	 */
+	void *			requestPayload;
+	size_t			requestPayloadCapacity;
+	double *		responseValues;
+	size_t			responseValuesCapacity;
+} ConversionServerConnection;
+
+/*
+ *	Set by SIGINT and SIGTERM. The handler is installed without `SA_RESTART`, so
+ *	that the signal also interrupts the `pselect()` waiting for clients.
+ */
+static volatile sig_atomic_t	conversionServerIsStopRequested = 0;
+
+static void
+conversionServerHandleStopSignal(int signalNumber)
+{
+	(void) signalNumber;
+	conversionServerIsStopRequested = 1;
+
+	return;
+}
+
+/*
+ *	Returns the payload size of a request, or zero if the header is malformed.
+ */
+static size_t
+conversionServerGetRequestPayloadSize(const ConversionServerRequestHeader *  header)
+{
+	if ((header->magic != kConversionServerRequestMagic) || (header->count > kConversionServerMaximumCount))
+	{
+		return 0;
+	}
+
+	switch (header->type)
+	{
+		case kConversionServerRequestTypeValues:
+			return (header->count > 0) ? header->count * sizeof(double) : 0;
+		case kConversionServerRequestTypeFrame:
+			if ((header->count == 0) || (header->width == 0) || ((header->count % header->width) != 0))
+			{
+				return 0;
+			}
+
+			return header->count * sizeof(uint16_t);
+		case kConversionServerRequestTypeMonteCarlo:
+			return (header->count > 0) ? sizeof(double) : 0;
+		default:
+			return 0;
+	}
+}
+
+static void
+conversionServerReserve(ConversionServerConnection *  connection, size_t payloadSize, size_t numberOfValues)
+{
+	if (payloadSize > connection->requestPayloadCapacity)
+	{
+		free(connection->requestPayload);
+		connection->requestPayload = checkedMalloc(payloadSize, __FILE__, __LINE__);
+		connection->requestPayloadCapacity = payloadSize;
+	}
+
+	if (numberOfValues > connection->responseValuesCapacity)
+	{
+		free(connection->responseValues);
+		connection->responseValues = (double *) checkedMalloc(numberOfValues * sizeof(double), __FILE__, __LINE__);
+		connection->responseValuesCapacity = numberOfValues;
+	}
+
+	return;
+}
+
+/*
+ *	Runs a Monte Carlo request with the profile's calibration distributions.
+ */
+static ConversionServerStatus
+conversionServerRunMonteCarlo(
+	const ConversionServerConfiguration *	configuration,
+	const CalibrationProfile *		profile,
+	double					counts,
+	size_t					numberOfIterations,
+	double *				values)
+{
+	MonteCarloConfiguration		monteCarloConfiguration;
+	StreamingStatistics		statistics;
+	ConversionServerStatus		status = kConversionServerStatusSuccess;
+
+	monteCarloConfigurationSetDefaults(&monteCarloConfiguration);
+	monteCarloConfiguration.nominalParameters = profile->nominalParameters;
+	monteCarloConfiguration.parameterHalfWidths = profile->parameterHalfWidths;
+	monteCarloConfiguration.seed = configuration->seed;
+	monteCarloConfiguration.numberOfThreads = configuration->numberOfThreads;
+
+	if (!isnan(counts))
+	{
+		monteCarloConfiguration.countsLow = counts;
+		monteCarloConfiguration.countsHigh = counts;
+	}
+
+	streamingStatisticsInit(&statistics);
+	if (monteCarloRunStreaming(&monteCarloConfiguration, 0, numberOfIterations, &statistics) != kCommonConstantReturnTypeSuccess)
+	{
+		status = kConversionServerStatusConversionFailed;
+	}
+	else
+	{
+		values[kConversionServerMonteCarloValueIndexMean] = statistics.moments.mean;
+		values[kConversionServerMonteCarloValueIndexStandardDeviation] = sqrt(streamingStatisticsVariance(&statistics));
+		values[kConversionServerMonteCarloValueIndexMinimum] = statistics.moments.minimum;
+		values[kConversionServerMonteCarloValueIndexMaximum] = statistics.moments.maximum;
+		streamingStatisticsQuantiles(
+			&statistics,
+			kConversionServerMonteCarloQuantileProbabilities,
+			sizeof(kConversionServerMonteCarloQuantileProbabilities) / sizeof(kConversionServerMonteCarloQuantileProbabilities[0]),
+			&values[kConversionServerMonteCarloValueIndexQuantiles]);
+	}
+	streamingStatisticsFree(&statistics);
+
+	return status;
+}
+
+/*
+ *	Reads and answers one request. Returns `false` once the connection is to be closed.
+ */
+static bool
+conversionServerServeRequest(ConversionServerConnection *  connection)
+{
+	const ConversionServerConfiguration *	configuration = connection->server->configuration;
+	ConversionServerRequestHeader		request;
+	ConversionServerResponseHeader		response = {0};
+	const CalibrationProfile *		profile;
+	size_t					payloadSize;
+	size_t					numberOfValues = 0;
+	ssize_t					count;
+
+	count = streamReadFully(connection->fileDescriptor, &request, sizeof(request));
+	if (count != (ssize_t) sizeof(request))
+	{
+		return false;
+	}
+
+	response.magic = kConversionServerResponseMagic;
+	response.type = request.type;
+	response.status = kConversionServerStatusSuccess;
+
+	payloadSize = conversionServerGetRequestPayloadSize(&request);
+	if (payloadSize == 0)
+	{
+		/*
+		 *	Without a valid header, the end of the payload is unknown.
+		 */
+		response.status = kConversionServerStatusBadRequest;
+		streamWriteFully(connection->fileDescriptor, &response, sizeof(response));
+
+		return false;
+	}
+
+	numberOfValues = (request.type == kConversionServerRequestTypeMonteCarlo) ? kConversionServerMonteCarloValueIndexMax : request.count;
+	conversionServerReserve(connection, payloadSize, numberOfValues);
+
+	count = streamReadFully(connection->fileDescriptor, connection->requestPayload, payloadSize);
+	if (count != (ssize_t) payloadSize)
+	{
+		return false;
+	}
+
+	profile = calibrationProfileSetGet(configuration->profiles, request.profileIndex);
+	if (profile == NULL)
+	{
+		response.status = kConversionServerStatusUnknownProfile;
+	}
+	else if (request.type == kConversionServerRequestTypeValues)
+	{
+		const double *	counts = (const double *) connection->requestPayload;
+
+		for (size_t i = 0; i < request.count; i++)
+		{
+			connection->responseValues[i] = calibrationContextConvertCounts(&profile->nominalContext, counts[i]);
+		}
+	}
+	else if (request.type == kConversionServerRequestTypeFrame)
+	{
+		if (convertRawCountsFrameToTemperatureVectorized(
+				&profile->nominalContext,
+				(const uint16_t *) connection->requestPayload,
+				request.width,
+				request.count / request.width,
+				request.width,
+				connection->responseValues) != kCommonConstantReturnTypeSuccess)
+		{
+			response.status = kConversionServerStatusConversionFailed;
+		}
+	}
+	else
+	{
+		double	counts;
+
+		memcpy(&counts, connection->requestPayload, sizeof(counts));
+		response.status = conversionServerRunMonteCarlo(configuration, profile, counts, request.count, connection->responseValues);
+	}
+
+	if (response.status == kConversionServerStatusSuccess)
+	{
+		response.count = (uint32_t) numberOfValues;
+	}
+
+	pthread_mutex_lock(&connection->server->mutex);
+	connection->server->numberOfRequests++;
+	pthread_mutex_unlock(&connection->server->mutex);
+
+	if (streamWriteFully(connection->fileDescriptor, &response, sizeof(response)) != kCommonConstantReturnTypeSuccess)
+	{
+		return false;
+	}
+
+	if ((response.count > 0) &&
+		(streamWriteFully(connection->fileDescriptor, connection->responseValues, response.count * sizeof(double)) != kCommonConstantReturnTypeSuccess))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+static void *
+conversionServerServeConnection(void *  argument)
+{
+	ConversionServerConnection *	connection = (ConversionServerConnection *) argument;
+	ConversionServer *		server = connection->server;
+
+	while (conversionServerServeRequest(connection))
+	{
+	}
+
+	pthread_mutex_lock(&server->mutex);
+	server->clientFileDescriptors[connection->slot] = -1;
+	server->numberOfActiveConnections--;
+	pthread_cond_broadcast(&server->condition);
+	pthread_mutex_unlock(&server->mutex);
+
+	close(connection->fileDescriptor);
+	free(connection->responseValues);
+	free(connection->requestPayload);
+	free(connection);
+
+	return NULL;
+}
+
+/*
+ *	Hands an accepted client to a thread of its own, or closes it if all slots are taken.
+ */
+static void
+conversionServerStartConnection(ConversionServer *  server, int clientFileDescriptor)
+{
+	ConversionServerConnection *	connection;
+	pthread_t			thread;
+	size_t				slot = kConversionServerMaximumConnections;
+
+	pthread_mutex_lock(&server->mutex);
+	for (size_t i = 0; i < kConversionServerMaximumConnections; i++)
+	{
+		if (server->clientFileDescriptors[i] < 0)
+		{
+			slot = i;
+			server->clientFileDescriptors[i] = clientFileDescriptor;
+			server->numberOfActiveConnections++;
+			server->numberOfConnections++;
+
+			break;
+		}
+	}
+	pthread_mutex_unlock(&server->mutex);
+
+	if (slot == kConversionServerMaximumConnections)
+	{
+		fprintf(stderr, "Warning: Closing a client, since %d clients are already being served.\n", kConversionServerMaximumConnections);
+		close(clientFileDescriptor);
+
+		return;
+	}
+
+	connection = (ConversionServerConnection *) checkedMalloc(sizeof(ConversionServerConnection), __FILE__, __LINE__);
+	*connection = (ConversionServerConnection)
+	{
+		.server = server,
+		.slot = slot,
+		.fileDescriptor = clientFileDescriptor,
+	};
+
+	if (pthread_create(&thread, NULL, conversionServerServeConnection, connection) != 0)
+	{
+		fprintf(stderr, "Warning: Could not create a thread for a client.\n");
+
+		pthread_mutex_lock(&server->mutex);
+		server->clientFileDescriptors[slot] = -1;
+		server->numberOfActiveConnections--;
+		pthread_mutex_unlock(&server->mutex);
+
+		close(clientFileDescriptor);
+		free(connection);
+
+		return;
+	}
+	pthread_detach(thread);
+
+	return;
+}
+
+#endif /* kConversionServerHavePosix */
+
+CommonConstantReturnType
+conversionServerRun(const ConversionServerConfiguration *  configuration, ConversionServerReport *  report)
+{
+	memset(report, 0, sizeof(*report));
+
+#if kConversionServerHavePosix
+	ConversionServer	server = {0};
+	struct sockaddr_un	address = {0};
+	struct sigaction	stopAction = {0};
+	struct sigaction	previousInterruptAction;
+	struct sigaction	previousTerminateAction;
+	sigset_t		stopSignals;
+	sigset_t		previousSignalMask;
+	sigset_t		waitSignalMask;
+	int			listenFileDescriptor;
+	double			start;
+
+	if (!rawFrameHostIsLittleEndian())
+	{
+		fprintf(stderr, "Error: The conversion server can only run on little-endian hosts.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (strlen(configuration->socketPath) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "Error: The socket path \"%s\" is longer than %zu characters.\n", configuration->socketPath, sizeof(address.sun_path) - 1);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, configuration->socketPath);
+
+	listenFileDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFileDescriptor < 0)
+	{
+		fprintf(stderr, "Error: Could not create a socket (%s).\n", strerror(errno));
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	An existing socket path is not removed, since another server may be using it.
+	 */
+	if ((bind(listenFileDescriptor, (struct sockaddr *) &address, sizeof(address)) != 0) ||
+		(listen(listenFileDescriptor, kConversionServerMaximumConnections) != 0))
+	{
+		fprintf(stderr, "Error: Could not listen on \"%s\" (%s).\n", configuration->socketPath, strerror(errno));
+		close(listenFileDescriptor);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	server.configuration = configuration;
+	for (size_t i = 0; i < kConversionServerMaximumConnections; i++)
+	{
+		server.clientFileDescriptors[i] = -1;
+	}
+	pthread_mutex_init(&server.mutex, NULL);
+	pthread_cond_init(&server.condition, NULL);
+
+	/*
+	 *	A client that disconnects early must not terminate the server.
+	 */
+	signal(SIGPIPE, SIG_IGN);
+	conversionServerIsStopRequested = 0;
+	stopAction.sa_handler = conversionServerHandleStopSignal;
+	sigemptyset(&stopAction.sa_mask);
+	sigaction(SIGINT, &stopAction, &previousInterruptAction);
+	sigaction(SIGTERM, &stopAction, &previousTerminateAction);
+	sigemptyset(&stopSignals);
+	sigaddset(&stopSignals, SIGINT);
+	sigaddset(&stopSignals, SIGTERM);
+
+	/*
+	 *	The stop signals stay blocked except inside `pselect()`, which unblocks them
+	 *	atomically, so that a signal arriving after the flag is checked still wakes the
+	 *	wait instead of being lost until the next client connects. Client threads
+	 *	inherit the blocked mask, so the signals are always delivered to this thread.
+	 *	The listening socket is non-blocking so that a client which disconnects between
+	 *	`pselect()` and `accept()` cannot block the loop either.
+	 */
+	pthread_sigmask(SIG_BLOCK, &stopSignals, &previousSignalMask);
+	waitSignalMask = previousSignalMask;
+	sigdelset(&waitSignalMask, SIGINT);
+	sigdelset(&waitSignalMask, SIGTERM);
+	fcntl(listenFileDescriptor, F_SETFL, fcntl(listenFileDescriptor, F_GETFL) | O_NONBLOCK);
+
+	fprintf(stderr, "Conversion server listening on \"%s\" with %zu calibration profile(s).\n", configuration->socketPath, configuration->profiles->numberOfProfiles);
+
+	start = getMonotonicTimeInSeconds();
+
+	while (!conversionServerIsStopRequested)
+	{
+		fd_set	readFileDescriptors;
+		int	clientFileDescriptor;
+
+		FD_ZERO(&readFileDescriptors);
+		FD_SET(listenFileDescriptor, &readFileDescriptors);
+		if (pselect(listenFileDescriptor + 1, &readFileDescriptors, NULL, NULL, NULL, &waitSignalMask) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			fprintf(stderr, "Error: Could not wait for a client (%s).\n", strerror(errno));
+
+			break;
+		}
+
+		clientFileDescriptor = accept(listenFileDescriptor, NULL, NULL);
+		if (clientFileDescriptor < 0)
+		{
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR) || (errno == ECONNABORTED))
+			{
+				continue;
+			}
+
+			fprintf(stderr, "Error: Could not accept a client (%s).\n", strerror(errno));
+
+			break;
+		}
+
+		/*
+		 *	Some platforms let the accepted socket inherit `O_NONBLOCK`, but the
+		 *	connection threads rely on blocking reads and writes.
+		 */
+		fcntl(clientFileDescriptor, F_SETFL, fcntl(clientFileDescriptor, F_GETFL) & ~O_NONBLOCK);
+		conversionServerStartConnection(&server, clientFileDescriptor);
+	}
+
+	pthread_sigmask(SIG_SETMASK, &previousSignalMask, NULL);
+
+	close(listenFileDescriptor);
+	unlink(configuration->socketPath);
+
+	/*
+	 *	Wake the clients blocked in `read()`, and wait for them, since they use the profiles.
+	 */
+	pthread_mutex_lock(&server.mutex);
+	for (size_t i = 0; i < kConversionServerMaximumConnections; i++)
+	{
+		if (server.clientFileDescriptors[i] >= 0)
+		{
+			shutdown(server.clientFileDescriptors[i], SHUT_RDWR);
+		}
+	}
+	while (server.numberOfActiveConnections > 0)
+	{
+		pthread_cond_wait(&server.condition, &server.mutex);
+	}
+	pthread_mutex_unlock(&server.mutex);
+
+	sigaction(SIGINT, &previousInterruptAction, NULL);
+	sigaction(SIGTERM, &previousTerminateAction, NULL);
+
+	report->numberOfConnections = server.numberOfConnections;
+	report->numberOfRequests = server.numberOfRequests;
+	report->elapsedSeconds = getMonotonicTimeInSeconds() - start;
+
+	pthread_cond_destroy(&server.condition);
+	pthread_mutex_destroy(&server.mutex);
+
+	return conversionServerIsStopRequested ? kCommonConstantReturnTypeSuccess : kCommonConstantReturnTypeError;
+#else
+	(void) configuration;
+	fprintf(stderr, "Error: The conversion server is not supported on this platform.\n");
+
+	return kCommonConstantReturnTypeError;
+#endif
+}
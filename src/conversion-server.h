@@ -0,0 +1,150 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration-profile.h"
+
+/*
+ *	The `-srv` conversion server. It stays resident on a Unix-domain stream
+ *	socket and serves each client connection on its own thread, with the
+ *	calibration contexts of the loaded profiles built once at startup and the
+ *	buffers of a connection reused across its requests. A connection carries
+ *	any number of requests, each answered before the next is read. Every
+ *	message is a 16-byte little-endian header followed by its payload:
+ *
+ *		request:	magic "FAXQ", type (uint16), profile (uint16), count (uint32), width (uint32)
+ *		response:	magic "FAXR", type (uint16), status (uint16), count (uint32), 0 (uint32)
+ *
+ *	The payloads of the request types are:
+ *
+ *		values:		count float64 counts -> count float64 temperatures
+ *		frame:		count uint16 counts, `width` per row -> count float64 temperatures
+ *		monte-carlo:	one float64 count, or NaN for the default counts distribution, for count
+ *				iterations -> `kConversionServerMonteCarloValueIndexMax` float64 values
+ *
+ *	`count` must be non-zero, and for frames a multiple of `width`.
+ *	A response with a status other than `kConversionServerStatusSuccess` has no payload.
+ *	Monte Carlo requests with the same count and iterations get the same values,
+ *	since each request restarts the Philox streams at iteration zero.
+ */
+typedef enum
+{
+	kConversionServerRequestMagic		= 0x51584146,	/* "FAXQ" read as a little-endian uint32 */
+	kConversionServerResponseMagic		= 0x52584146,	/* "FAXR" read as a little-endian uint32 */
+	/*
+	 *	Most values or pixels of a request, so that one request cannot exhaust memory.
+	 */
+	kConversionServerMaximumCount		= 1 << 24,
+	/*
+	 *	Most clients served at once. Further clients are closed when accepted.
+	 */
+	kConversionServerMaximumConnections	= 64,
+} ConversionServerConstant;
+
+typedef enum
+{
+	kConversionServerRequestTypeValues	= 0,
+	kConversionServerRequestTypeFrame,
+	kConversionServerRequestTypeMonteCarlo,
+	kConversionServerRequestTypeMax,
+} ConversionServerRequestType;
+
+typedef enum
+{
+	kConversionServerStatusSuccess		= 0,
+	/*
+	 *	The header is malformed. The server closes the connection after answering,
+	 *	since it cannot find the next request.
+	 */
+	kConversionServerStatusBadRequest,
+	kConversionServerStatusUnknownProfile,
+	kConversionServerStatusConversionFailed,
+} ConversionServerStatus;
+
+typedef enum
+{
+	kConversionServerMonteCarloValueIndexMean	= 0,
+	kConversionServerMonteCarloValueIndexStandardDeviation,
+	kConversionServerMonteCarloValueIndexMinimum,
+	kConversionServerMonteCarloValueIndexMaximum,
+	/*
+	 *	The 0.05, 0.50 and 0.95 quantiles.
+	 */
+	kConversionServerMonteCarloValueIndexQuantiles,
+	kConversionServerMonteCarloValueIndexMax	= kConversionServerMonteCarloValueIndexQuantiles + 3,
+} ConversionServerMonteCarloValueIndex;
+
+typedef struct
+{
+	uint32_t	magic;
+	uint16_t	type;
+	uint16_t	profileIndex;
+	uint32_t	count;
+	uint32_t	width;
+} ConversionServerRequestHeader;
+
+typedef struct
+{
+	uint32_t	magic;
+	uint16_t	type;
+	uint16_t	status;
+	uint32_t	count;
+	uint32_t	reserved;
+} ConversionServerResponseHeader;
+
+typedef struct
+{
+	const char *			socketPath;
+	/*
+	 *	The profiles that requests name by number. They are only read while the server runs.
+	 */
+	const CalibrationProfileSet *	profiles;
+	/*
+	 *	Seed and worker threads of every Monte Carlo request, which draws pseudo-random
+	 *	numbers.
+	 */
+	uint64_t			seed;
+	size_t				numberOfThreads;
+} ConversionServerConfiguration;
+
+typedef struct
+{
+	size_t		numberOfConnections;
+	size_t		numberOfRequests;
+	double		elapsedSeconds;
+} ConversionServerReport;
+
+/**
+ *	@brief  Serves conversion requests on a Unix-domain socket until SIGINT or SIGTERM, then removes
+ *		the socket. Fails if the socket path already exists.
+ *
+ *	@param  configuration	: Pointer to the server configuration.
+ *	@param  report		: Pointer to the report to fill.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	conversionServerRun(const ConversionServerConfiguration *  configuration, ConversionServerReport *  report);
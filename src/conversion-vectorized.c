@@ -0,0 +1,679 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "common.h"
+#include "utilities-config.h"
+#include "calibration.h"
+#include "material-map.h"
+#include "conversion.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define kConversionVectorizedHaveX86Kernels	(1)
+#include <immintrin.h>
+#else
+#define kConversionVectorizedHaveX86Kernels	(0)
+#endif
+
+/*
+ *	Per-pixel scalar formula, shared by the tails and special-case lanes of the
+ *	vectorized kernels. It matches `convertRawCountsFrameToTemperature()`.
+ */
+static inline double
+convertCountsScalar(const CalibrationContext *  context, uint16_t counts)
+{
+	return	(
+			context->B /
+			log(context->R / ((context->countsGain * counts) - context->countsOffset) + context->F)
+		) - kAbsoluteZeroKelvinInCelsius;
+}
+
+#if kConversionVectorizedHaveX86Kernels
+/*
+ *	GCC contracts separate multiply and subtract intrinsics into FMAs by default
+ *	when the target has FMA. `countsGain * counts - countsOffset` cancels heavily
+ *	at low counts, so a fused version would no longer round like the scalar path.
+ */
+#pragma GCC push_options
+#pragma GCC optimize ("fp-contract=off")
+
+/*
+ *	Vectorized natural logarithm. This is the fdlibm `__ieee754_log()`
+ *	algorithm (argument reduction to [sqrt(2)/2, sqrt(2)) and a degree-14
+ *	minimax polynomial in s = f/(2+f)), evaluated lane-wise without branches.
+ *	fdlibm documents its error as less than 1 ULP. Lanes outside the normal
+ *	positive finite range are recomputed by the caller through libm.
+ */
+static const double	kLogLn2Hi	= 6.93147180369123816490e-01;
+static const double	kLogLn2Lo	= 1.90821492927058770002e-10;
+static const double	kLogLg1		= 6.666666666666735130e-01;
+static const double	kLogLg2		= 3.999999999940941908e-01;
+static const double	kLogLg3		= 2.857142874366239149e-01;
+static const double	kLogLg4		= 2.222219843214978396e-01;
+static const double	kLogLg5		= 1.818357216161805012e-01;
+static const double	kLogLg6		= 1.531383769920937332e-01;
+static const double	kLogLg7		= 1.479819860511658591e-01;
+static const double	kLogSqrt2	= 1.41421356237309504880;
+
+/*
+ *	Adding the bit pattern of 2^52 to a small non-negative integer held in
+ *	the low mantissa bits and subtracting 2^52 converts it to double
+ *	without needing AVX-512DQ.
+ */
+static const uint64_t	kLogTwoPow52Bits	= 0x4330000000000000ULL;
+static const double	kLogTwoPow52		= 4503599627370496.0;
+static const uint64_t	kLogMantissaMask	= 0x000FFFFFFFFFFFFFULL;
+static const uint64_t	kLogOneBits		= 0x3FF0000000000000ULL;
+static const double	kLogExponentBias	= 1023.0;
+
+__attribute__((target("avx2,fma")))
+static inline __m256d
+logAVX2(__m256d x)
+{
+	__m256i	bits = _mm256_castpd_si256(x);
+	__m256i	biasedExponent = _mm256_srli_epi64(bits, 52);
+	__m256d	k = _mm256_sub_pd(
+			_mm256_castsi256_pd(_mm256_or_si256(biasedExponent, _mm256_set1_epi64x(kLogTwoPow52Bits))),
+			_mm256_set1_pd(kLogTwoPow52 + kLogExponentBias));
+	__m256d	m = _mm256_castsi256_pd(
+			_mm256_or_si256(
+				_mm256_and_si256(bits, _mm256_set1_epi64x(kLogMantissaMask)),
+				_mm256_set1_epi64x(kLogOneBits)));
+	__m256d	isLarge = _mm256_cmp_pd(m, _mm256_set1_pd(kLogSqrt2), _CMP_GE_OQ);
+	__m256d	f;
+	__m256d	s;
+	__m256d	z;
+	__m256d	w;
+	__m256d	t1;
+	__m256d	t2;
+	__m256d	R;
+	__m256d	hfsq;
+
+	m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), isLarge);
+	k = _mm256_add_pd(k, _mm256_and_pd(isLarge, _mm256_set1_pd(1.0)));
+
+	f	= _mm256_sub_pd(m, _mm256_set1_pd(1.0));
+	s	= _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+	z	= _mm256_mul_pd(s, s);
+	w	= _mm256_mul_pd(z, z);
+	t1	= _mm256_mul_pd(w, _mm256_fmadd_pd(w, _mm256_fmadd_pd(w, _mm256_set1_pd(kLogLg6), _mm256_set1_pd(kLogLg4)), _mm256_set1_pd(kLogLg2)));
+	t2	= _mm256_mul_pd(
+			z,
+			_mm256_fmadd_pd(
+				w,
+				_mm256_fmadd_pd(w, _mm256_fmadd_pd(w, _mm256_set1_pd(kLogLg7), _mm256_set1_pd(kLogLg5)), _mm256_set1_pd(kLogLg3)),
+				_mm256_set1_pd(kLogLg1)));
+	R	= _mm256_add_pd(t2, t1);
+	hfsq	= _mm256_mul_pd(_mm256_set1_pd(0.5), _mm256_mul_pd(f, f));
+
+	/*
+	 *	k*ln2_hi - ((hfsq - (s*(hfsq+R) + k*ln2_lo)) - f)
+	 */
+	return _mm256_sub_pd(
+			_mm256_mul_pd(k, _mm256_set1_pd(kLogLn2Hi)),
+			_mm256_sub_pd(
+				_mm256_sub_pd(
+					hfsq,
+					_mm256_add_pd(
+						_mm256_mul_pd(s, _mm256_add_pd(hfsq, R)),
+						_mm256_mul_pd(k, _mm256_set1_pd(kLogLn2Lo)))),
+				f));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d
+logAVX512(__m512d x)
+{
+	__m512i		bits = _mm512_castpd_si512(x);
+	__m512i		biasedExponent = _mm512_srli_epi64(bits, 52);
+	__m512d		k = _mm512_sub_pd(
+				_mm512_castsi512_pd(_mm512_or_si512(biasedExponent, _mm512_set1_epi64(kLogTwoPow52Bits))),
+				_mm512_set1_pd(kLogTwoPow52 + kLogExponentBias));
+	__m512d		m = _mm512_castsi512_pd(
+				_mm512_or_si512(
+					_mm512_and_si512(bits, _mm512_set1_epi64(kLogMantissaMask)),
+					_mm512_set1_epi64(kLogOneBits)));
+	__mmask8	isLarge = _mm512_cmp_pd_mask(m, _mm512_set1_pd(kLogSqrt2), _CMP_GE_OQ);
+	__m512d		f;
+	__m512d		s;
+	__m512d		z;
+	__m512d		w;
+	__m512d		t1;
+	__m512d		t2;
+	__m512d		R;
+	__m512d		hfsq;
+
+	m = _mm512_mask_mul_pd(m, isLarge, m, _mm512_set1_pd(0.5));
+	k = _mm512_mask_add_pd(k, isLarge, k, _mm512_set1_pd(1.0));
+
+	f	= _mm512_sub_pd(m, _mm512_set1_pd(1.0));
+	s	= _mm512_div_pd(f, _mm512_add_pd(_mm512_set1_pd(2.0), f));
+	z	= _mm512_mul_pd(s, s);
+	w	= _mm512_mul_pd(z, z);
+	t1	= _mm512_mul_pd(w, _mm512_fmadd_pd(w, _mm512_fmadd_pd(w, _mm512_set1_pd(kLogLg6), _mm512_set1_pd(kLogLg4)), _mm512_set1_pd(kLogLg2)));
+	t2	= _mm512_mul_pd(
+			z,
+			_mm512_fmadd_pd(
+				w,
+				_mm512_fmadd_pd(w, _mm512_fmadd_pd(w, _mm512_set1_pd(kLogLg7), _mm512_set1_pd(kLogLg5)), _mm512_set1_pd(kLogLg3)),
+				_mm512_set1_pd(kLogLg1)));
+	R	= _mm512_add_pd(t2, t1);
+	hfsq	= _mm512_mul_pd(_mm512_set1_pd(0.5), _mm512_mul_pd(f, f));
+
+	return _mm512_sub_pd(
+			_mm512_mul_pd(k, _mm512_set1_pd(kLogLn2Hi)),
+			_mm512_sub_pd(
+				_mm512_sub_pd(
+					hfsq,
+					_mm512_add_pd(
+						_mm512_mul_pd(s, _mm512_add_pd(hfsq, R)),
+						_mm512_mul_pd(k, _mm512_set1_pd(kLogLn2Lo)))),
+				f));
+}
+
+__attribute__((target("avx2,fma")))
+static void
+convertRowAVX2(const CalibrationContext *  context, const uint16_t *  rawCounts, size_t width, double *  temperatures)
+{
+	const __m256d	gain = _mm256_set1_pd(context->countsGain);
+	const __m256d	offset = _mm256_set1_pd(context->countsOffset);
+	const __m256d	R = _mm256_set1_pd(context->R);
+	const __m256d	F = _mm256_set1_pd(context->F);
+	const __m256d	B = _mm256_set1_pd(context->B);
+	const __m256d	absoluteZero = _mm256_set1_pd(kAbsoluteZeroKelvinInCelsius);
+	const __m256d	smallestNormal = _mm256_set1_pd(DBL_MIN);
+	const __m256d	largestFinite = _mm256_set1_pd(DBL_MAX);
+	size_t		column = 0;
+
+	for (; column + 4 <= width; column += 4)
+	{
+		__m128i	counts16;
+		__m256d	counts;
+		__m256d	y;
+		__m256d	isNormal;
+
+		memcpy(&counts16, &rawCounts[column], 4 * sizeof(uint16_t));
+		counts = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(counts16));
+
+		/*
+		 *	Multiply and subtract are kept unfused to round exactly like the scalar path.
+		 */
+		y = _mm256_add_pd(_mm256_div_pd(R, _mm256_sub_pd(_mm256_mul_pd(gain, counts), offset)), F);
+		_mm256_storeu_pd(&temperatures[column], _mm256_sub_pd(_mm256_div_pd(B, logAVX2(y)), absoluteZero));
+
+		isNormal = _mm256_and_pd(
+				_mm256_cmp_pd(y, smallestNormal, _CMP_GE_OQ),
+				_mm256_cmp_pd(y, largestFinite, _CMP_LE_OQ));
+		if (_mm256_movemask_pd(isNormal) != 0xF)
+		{
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				temperatures[column + lane] = convertCountsScalar(context, rawCounts[column + lane]);
+			}
+		}
+	}
+
+	for (; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalar(context, rawCounts[column]);
+	}
+
+	return;
+}
+
+__attribute__((target("avx512f,avx2")))
+static void
+convertRowAVX512(const CalibrationContext *  context, const uint16_t *  rawCounts, size_t width, double *  temperatures)
+{
+	const __m512d	gain = _mm512_set1_pd(context->countsGain);
+	const __m512d	offset = _mm512_set1_pd(context->countsOffset);
+	const __m512d	R = _mm512_set1_pd(context->R);
+	const __m512d	F = _mm512_set1_pd(context->F);
+	const __m512d	B = _mm512_set1_pd(context->B);
+	const __m512d	absoluteZero = _mm512_set1_pd(kAbsoluteZeroKelvinInCelsius);
+	const __m512d	smallestNormal = _mm512_set1_pd(DBL_MIN);
+	const __m512d	largestFinite = _mm512_set1_pd(DBL_MAX);
+	size_t		column = 0;
+
+	for (; column + 8 <= width; column += 8)
+	{
+		__m512d		counts;
+		__m512d		y;
+		__mmask8	isNormal;
+
+		counts = _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &rawCounts[column])));
+		y = _mm512_add_pd(_mm512_div_pd(R, _mm512_sub_pd(_mm512_mul_pd(gain, counts), offset)), F);
+		_mm512_storeu_pd(&temperatures[column], _mm512_sub_pd(_mm512_div_pd(B, logAVX512(y)), absoluteZero));
+
+		isNormal = _mm512_cmp_pd_mask(y, smallestNormal, _CMP_GE_OQ) & _mm512_cmp_pd_mask(y, largestFinite, _CMP_LE_OQ);
+		if (isNormal != 0xFF)
+		{
+			for (size_t lane = 0; lane < 8; lane++)
+			{
+				temperatures[column + lane] = convertCountsScalar(context, rawCounts[column + lane]);
+			}
+		}
+	}
+
+	for (; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalar(context, rawCounts[column]);
+	}
+
+	return;
+}
+
+/*
+ *	Material kernels: the same formula, with each pixel's `countsGain` and `countsOffset`
+ *	taken from the material table by its slot. R, B and F belong to the camera,
+ *	so every slot shares them.
+ */
+__attribute__((target("avx2,fma")))
+static void
+convertMaterialRowAVX2(const MaterialTable *  table, const uint16_t *  rawCounts, const uint8_t *  slots, size_t width, double *  temperatures)
+{
+	const __m256d	R = _mm256_set1_pd(table->contexts[0].R);
+	const __m256d	F = _mm256_set1_pd(table->contexts[0].F);
+	const __m256d	B = _mm256_set1_pd(table->contexts[0].B);
+	const __m256d	absoluteZero = _mm256_set1_pd(kAbsoluteZeroKelvinInCelsius);
+	const __m256d	smallestNormal = _mm256_set1_pd(DBL_MIN);
+	const __m256d	largestFinite = _mm256_set1_pd(DBL_MAX);
+	size_t		column = 0;
+
+	for (; column + 4 <= width; column += 4)
+	{
+		__m128i	counts16;
+		int32_t	slots8;
+		__m128i	slotIndices;
+		__m256d	counts;
+		__m256d	gain;
+		__m256d	offset;
+		__m256d	y;
+		__m256d	isNormal;
+
+		memcpy(&counts16, &rawCounts[column], 4 * sizeof(uint16_t));
+		memcpy(&slots8, &slots[column], 4 * sizeof(uint8_t));
+		counts = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(counts16));
+		slotIndices = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(slots8));
+		gain = _mm256_i32gather_pd(table->countsGains, slotIndices, sizeof(double));
+		offset = _mm256_i32gather_pd(table->countsOffsets, slotIndices, sizeof(double));
+
+		y = _mm256_add_pd(_mm256_div_pd(R, _mm256_sub_pd(_mm256_mul_pd(gain, counts), offset)), F);
+		_mm256_storeu_pd(&temperatures[column], _mm256_sub_pd(_mm256_div_pd(B, logAVX2(y)), absoluteZero));
+
+		isNormal = _mm256_and_pd(
+				_mm256_cmp_pd(y, smallestNormal, _CMP_GE_OQ),
+				_mm256_cmp_pd(y, largestFinite, _CMP_LE_OQ));
+		if (_mm256_movemask_pd(isNormal) != 0xF)
+		{
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				temperatures[column + lane] = convertCountsScalar(&table->contexts[slots[column + lane]], rawCounts[column + lane]);
+			}
+		}
+	}
+
+	for (; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalar(&table->contexts[slots[column]], rawCounts[column]);
+	}
+
+	return;
+}
+
+/*
+ *	A scene of at most `kMaterialMapMaximumPermutedSlots` materials keeps the count terms
+ *	of its slots in pairs of registers, which a two-source permute indexes as cheaply as
+ *	a broadcast. Larger scenes gather them.
+ */
+__attribute__((target("avx512f,avx2")))
+static void
+convertMaterialRowAVX512(const MaterialTable *  table, const uint16_t *  rawCounts, const uint8_t *  slots, size_t width, double *  temperatures)
+{
+	const bool	isPermuted = (table->numberOfSlots <= kMaterialMapMaximumPermutedSlots);
+	const __m512d	gainsLow = _mm512_loadu_pd(&table->countsGains[0]);
+	const __m512d	gainsHigh = _mm512_loadu_pd(&table->countsGains[8]);
+	const __m512d	offsetsLow = _mm512_loadu_pd(&table->countsOffsets[0]);
+	const __m512d	offsetsHigh = _mm512_loadu_pd(&table->countsOffsets[8]);
+	const __m512d	R = _mm512_set1_pd(table->contexts[0].R);
+	const __m512d	F = _mm512_set1_pd(table->contexts[0].F);
+	const __m512d	B = _mm512_set1_pd(table->contexts[0].B);
+	const __m512d	absoluteZero = _mm512_set1_pd(kAbsoluteZeroKelvinInCelsius);
+	const __m512d	smallestNormal = _mm512_set1_pd(DBL_MIN);
+	const __m512d	largestFinite = _mm512_set1_pd(DBL_MAX);
+	size_t		column = 0;
+
+	for (; column + 8 <= width; column += 8)
+	{
+		__m128i		slots8;
+		__m512d		counts;
+		__m512d		gain;
+		__m512d		offset;
+		__m512d		y;
+		__mmask8	isNormal;
+
+		counts = _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &rawCounts[column])));
+		slots8 = _mm_loadl_epi64((const __m128i *) &slots[column]);
+		if (isPermuted)
+		{
+			__m512i	slotIndices = _mm512_cvtepu8_epi64(slots8);
+
+			gain = _mm512_permutex2var_pd(gainsLow, slotIndices, gainsHigh);
+			offset = _mm512_permutex2var_pd(offsetsLow, slotIndices, offsetsHigh);
+		}
+		else
+		{
+			__m256i	slotIndices = _mm256_cvtepu8_epi32(slots8);
+
+			gain = _mm512_i32gather_pd(slotIndices, table->countsGains, sizeof(double));
+			offset = _mm512_i32gather_pd(slotIndices, table->countsOffsets, sizeof(double));
+		}
+
+		y = _mm512_add_pd(_mm512_div_pd(R, _mm512_sub_pd(_mm512_mul_pd(gain, counts), offset)), F);
+		_mm512_storeu_pd(&temperatures[column], _mm512_sub_pd(_mm512_div_pd(B, logAVX512(y)), absoluteZero));
+
+		isNormal = _mm512_cmp_pd_mask(y, smallestNormal, _CMP_GE_OQ) & _mm512_cmp_pd_mask(y, largestFinite, _CMP_LE_OQ);
+		if (isNormal != 0xFF)
+		{
+			for (size_t lane = 0; lane < 8; lane++)
+			{
+				temperatures[column + lane] = convertCountsScalar(&table->contexts[slots[column + lane]], rawCounts[column + lane]);
+			}
+		}
+	}
+
+	for (; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalar(&table->contexts[slots[column]], rawCounts[column]);
+	}
+
+	return;
+}
+
+#pragma GCC pop_options
+#endif /* kConversionVectorizedHaveX86Kernels */
+
+static void
+convertRowScalar(const CalibrationContext *  context, const uint16_t *  rawCounts, size_t width, double *  temperatures)
+{
+	for (size_t column = 0; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalar(context, rawCounts[column]);
+	}
+
+	return;
+}
+
+static void
+convertMaterialRowScalar(const MaterialTable *  table, const uint16_t *  rawCounts, const uint8_t *  slots, size_t width, double *  temperatures)
+{
+	for (size_t column = 0; column < width; column++)
+	{
+		temperatures[column] = convertCountsScalar(&table->contexts[slots[column]], rawCounts[column]);
+	}
+
+	return;
+}
+
+typedef void (*ConvertRowFunction)(const CalibrationContext *  context, const uint16_t *  rawCounts, size_t width, double *  temperatures);
+typedef void (*ConvertMaterialRowFunction)(const MaterialTable *  table, const uint16_t *  rawCounts, const uint8_t *  slots, size_t width, double *  temperatures);
+
+#if kConversionVectorizedHaveX86Kernels
+/*
+ *	The kernel chosen by the first CPU check, or -1 before it. Threads that race on
+ *	the first check compute and store the same value.
+ */
+static int	vectorizedConversionSelectedKernel = -1;
+#endif
+
+/*
+ *	Checks the CPU once, since frames converted row by row or span by span (`-inc`)
+ *	select a kernel for every row or span.
+ */
+static VectorizedConversionKernel
+selectKernel(void)
+{
+#if kConversionVectorizedHaveX86Kernels
+	int	kernel = __atomic_load_n(&vectorizedConversionSelectedKernel, __ATOMIC_RELAXED);
+
+	if (kernel < 0)
+	{
+		kernel = kVectorizedConversionKernelScalar;
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2"))
+		{
+			kernel = kVectorizedConversionKernelAVX512;
+		}
+		else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		{
+			kernel = kVectorizedConversionKernelAVX2;
+		}
+		__atomic_store_n(&vectorizedConversionSelectedKernel, kernel, __ATOMIC_RELAXED);
+	}
+
+	return (VectorizedConversionKernel) kernel;
+#else
+	return kVectorizedConversionKernelScalar;
+#endif
+}
+
+static ConvertRowFunction
+selectRowKernel(void)
+{
+	switch (selectKernel())
+	{
+#if kConversionVectorizedHaveX86Kernels
+		case kVectorizedConversionKernelAVX512:
+			return convertRowAVX512;
+		case kVectorizedConversionKernelAVX2:
+			return convertRowAVX2;
+#endif
+		default:
+			return convertRowScalar;
+	}
+}
+
+/*
+ *	The material kernels use the same instruction sets as the plain ones.
+ */
+static ConvertMaterialRowFunction
+selectMaterialRowKernel(void)
+{
+	switch (selectKernel())
+	{
+#if kConversionVectorizedHaveX86Kernels
+		case kVectorizedConversionKernelAVX512:
+			return convertMaterialRowAVX512;
+		case kVectorizedConversionKernelAVX2:
+			return convertMaterialRowAVX2;
+#endif
+		default:
+			return convertMaterialRowScalar;
+	}
+}
+
+VectorizedConversionKernel
+getVectorizedConversionKernel(void)
+{
+	return selectKernel();
+}
+
+const char *
+getVectorizedConversionKernelName(VectorizedConversionKernel kernel)
+{
+	switch (kernel)
+	{
+		case kVectorizedConversionKernelAVX512:
+			return "AVX-512";
+		case kVectorizedConversionKernelAVX2:
+			return "AVX2";
+		default:
+			return "scalar";
+	}
+}
+
+CommonConstantReturnType
+convertRawCountsFrameToTemperatureVectorized(
+	const CalibrationContext *	context,
+	const uint16_t *		rawCounts,
+	size_t				width,
+	size_t				height,
+	size_t				strideInPixels,
+	double *			temperatures)
+{
+	ConvertRowFunction	convertRow;
+
+	if ((context == NULL) || (rawCounts == NULL) || (temperatures == NULL))
+	{
+		fprintf(stderr, "Error: Frame conversion called with a NULL context or frame pointer.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (strideInPixels < width)
+	{
+		fprintf(stderr, "Error: Frame stride (%zu pixels) is smaller than the frame width (%zu pixels).\n", strideInPixels, width);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	convertRow = selectRowKernel();
+
+	for (size_t row = 0; row < height; row++)
+	{
+		convertRow(context, &rawCounts[row * strideInPixels], width, &temperatures[row * width]);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+convertRawCountsFrameToTemperatureWithMaterials(
+	const MaterialTable *		table,
+	const uint16_t *		rawCounts,
+	const uint8_t *			slots,
+	size_t				width,
+	size_t				height,
+	size_t				strideInPixels,
+	double *			temperatures)
+{
+	ConvertMaterialRowFunction	convertRow;
+
+	if ((table == NULL) || (rawCounts == NULL) || (slots == NULL) || (temperatures == NULL))
+	{
+		fprintf(stderr, "Error: Material frame conversion called with a NULL table, slot or frame pointer.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (strideInPixels < width)
+	{
+		fprintf(stderr, "Error: Frame stride (%zu pixels) is smaller than the frame width (%zu pixels).\n", strideInPixels, width);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	convertRow = selectMaterialRowKernel();
+
+	for (size_t row = 0; row < height; row++)
+	{
+		convertRow(table, &rawCounts[row * strideInPixels], &slots[row * width], width, &temperatures[row * width]);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Distance in units in the last place between two doubles, counting
+ *	representable values between them. NaNs compare equal to each other.
+ */
+static uint64_t
+ulpDistance(double a, double b)
+{
+	int64_t	ia;
+	int64_t	ib;
+
+	if (isnan(a) || isnan(b))
+	{
+		return (isnan(a) && isnan(b)) ? 0 : UINT64_MAX;
+	}
+
+	memcpy(&ia, &a, sizeof(ia));
+	memcpy(&ib, &b, sizeof(ib));
+
+	/*
+	 *	Map the sign-magnitude representation to a monotonic integer line.
+	 */
+	ia = (ia < 0) ? (int64_t)(0x8000000000000000ULL - (uint64_t) ia) : ia;
+	ib = (ib < 0) ? (int64_t)(0x8000000000000000ULL - (uint64_t) ib) : ib;
+
+	return (ia > ib) ? (uint64_t)(ia - ib) : (uint64_t)(ib - ia);
+}
+
+uint64_t
+measureVectorizedConversionMaximumUlpDifference(const CalibrationContext *  context)
+{
+	enum
+	{
+		kAllCounts = 65536,
+	};
+	uint16_t *	allCounts = (uint16_t *) checkedMalloc(kAllCounts * sizeof(uint16_t), __FILE__, __LINE__);
+	double *	scalarTemperatures = (double *) checkedMalloc(kAllCounts * sizeof(double), __FILE__, __LINE__);
+	double *	vectorizedTemperatures = (double *) checkedMalloc(kAllCounts * sizeof(double), __FILE__, __LINE__);
+	uint64_t	maximumUlpDifference = 0;
+
+	for (size_t i = 0; i < kAllCounts; i++)
+	{
+		allCounts[i] = (uint16_t) i;
+	}
+
+	convertRawCountsFrameToTemperature(context, allCounts, kAllCounts, 1, kAllCounts, scalarTemperatures);
+	convertRawCountsFrameToTemperatureVectorized(context, allCounts, kAllCounts, 1, kAllCounts, vectorizedTemperatures);
+
+	for (size_t i = 0; i < kAllCounts; i++)
+	{
+		/*
+		 *	Compare on the absolute scale: near the zero of the Celsius-shifted
+		 *	output, cancellation makes ULPs of the shifted value meaningless.
+		 */
+		uint64_t	difference = ulpDistance(
+						scalarTemperatures[i] + kAbsoluteZeroKelvinInCelsius,
+						vectorizedTemperatures[i] + kAbsoluteZeroKelvinInCelsius);
+
+		if (difference > maximumUlpDifference)
+		{
+			maximumUlpDifference = difference;
+		}
+	}
+
+	free(allCounts);
+	free(scalarTemperatures);
+	free(vectorizedTemperatures);
+
+	return maximumUlpDifference;
+}
@@ -0,0 +1,72 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "utilities-config.h"
+#include "conversion.h"
+
+CommonConstantReturnType
+convertRawCountsFrameToTemperature(
+	const CalibrationContext *	context,
+	const uint16_t *		rawCounts,
+	size_t				width,
+	size_t				height,
+	size_t				strideInPixels,
+	double *			temperatures)
+{
+	if ((context == NULL) || (rawCounts == NULL) || (temperatures == NULL))
+	{
+		fprintf(stderr, "Error: Frame conversion called with a NULL context or frame pointer.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (strideInPixels < width)
+	{
+		fprintf(stderr, "Error: Frame stride (%zu pixels) is smaller than the frame width (%zu pixels).\n", strideInPixels, width);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t row = 0; row < height; row++)
+	{
+		const uint16_t *	rawCountsRow = &rawCounts[row * strideInPixels];
+		double *		temperaturesRow = &temperatures[row * width];
+
+		for (size_t column = 0; column < width; column++)
+		{
+			temperaturesRow[column] =	(
+								context->B /
+								log(
+									context->R /
+									((context->countsGain * rawCountsRow[column]) - context->countsOffset) +
+									context->F)
+							) - kAbsoluteZeroKelvinInCelsius;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,240 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "utilities-config.h"
+#include "calibration.h"
+#include "delta-method.h"
+
+/*
+ *	Pseudo radiance P(T) = R / (exp(B / T) - F) of a source at temperature T, and
+ *	its partial derivatives with respect to T, B and F.
+ */
+typedef struct
+{
+	double	value;
+	double	derivativeT;
+	double	derivativeB;
+	double	derivativeF;
+} PseudoRadiance;
+
+static PseudoRadiance
+pseudoRadiance(double R, double B, double F, double T)
+{
+	double		exponential = exp(B / T);
+	double		denominator = exponential - F;
+	PseudoRadiance	radiance;
+
+	radiance.value		= R / denominator;
+	radiance.derivativeT	= R * exponential * B / (T * T * denominator * denominator);
+	radiance.derivativeB	= -R * exponential / (T * denominator * denominator);
+	radiance.derivativeF	= R / (denominator * denominator);
+
+	return radiance;
+}
+
+void
+deltaMethodContextInit(
+	DeltaMethodContext *		deltaMethodContext,
+	const CalibrationParameters *	nominalParameters,
+	const CalibrationParameters *	parameterHalfWidths)
+{
+	const double *	p = nominalParameters->values;
+	double *	offsets = deltaMethodContext->denominatorDerivativeOffsets;
+	double *	slopes = deltaMethodContext->denominatorDerivativeSlopes;
+	double		Emiss = p[kCalibrationParameterIndexEmiss];
+	double		Tau = p[kCalibrationParameterIndexTau];
+	double		TransmissionExtOptics = p[kCalibrationParameterIndexTransmissionExtOptics];
+	double		R = p[kCalibrationParameterIndexR];
+	double		B = p[kCalibrationParameterIndexB];
+	double		F = p[kCalibrationParameterIndexF];
+	double		J0 = p[kCalibrationParameterIndexJ0];
+	double		J1 = p[kCalibrationParameterIndexJ1];
+	double		K1;
+	double		a1;
+	double		a2;
+	double		a3;
+	PseudoRadiance	P1;
+	PseudoRadiance	P2;
+	PseudoRadiance	P3;
+
+	deltaMethodContext->context = (CalibrationContext) {0};
+	calibrationContextUpdate(&deltaMethodContext->context, nominalParameters);
+	K1 = deltaMethodContext->context.K1;
+
+	for (size_t i = 0; i < kCalibrationParameterIndexMax; i++)
+	{
+		deltaMethodContext->parameterVariances[i] = parameterHalfWidths->values[i] * parameterHalfWidths->values[i] / 3;
+	}
+
+	/*
+	 *	K2 = a1 * P1 + a2 * P2 + a3 * P3, for the reflected environment, the
+	 *	atmosphere and the external optics, as in `calibrationContextUpdate()`.
+	 */
+	a1 = (1 - Emiss) / Emiss;
+	a2 = (1 - Tau) / (Emiss * Tau);
+	a3 = (1 - TransmissionExtOptics) / (Emiss * Tau * TransmissionExtOptics);
+	P1 = pseudoRadiance(R, B, F, p[kCalibrationParameterIndexTRefl]);
+	P2 = pseudoRadiance(R, B, F, p[kCalibrationParameterIndexTAtmC] + kAbsoluteZeroKelvinInCelsius);
+	P3 = pseudoRadiance(R, B, F, p[kCalibrationParameterIndexTExtOptics]);
+
+	/*
+	 *	dD/dx = (dK1/dx) * signal + K1 * (dsignal/dx) - dK2/dx, with
+	 *	signal = counts / J1 - J0 / J1. Terms in `signal` split into an offset
+	 *	and a slope per count.
+	 */
+	for (size_t i = 0; i < kDeltaMethodInputIndexMax; i++)
+	{
+		offsets[i] = 0;
+		slopes[i] = 0;
+	}
+
+	/*
+	 *	dK1/dEmiss = -K1 / Emiss, and likewise for Tau and TransmissionExtOptics.
+	 */
+	offsets[kCalibrationParameterIndexEmiss]	= (K1 / Emiss) * (J0 / J1) + P1.value / (Emiss * Emiss) + (a2 * P2.value + a3 * P3.value) / Emiss;
+	slopes[kCalibrationParameterIndexEmiss]		= -(K1 / Emiss) / J1;
+
+	offsets[kCalibrationParameterIndexTau]		= (K1 / Tau) * (J0 / J1) + P2.value / (Emiss * Tau * Tau) + a3 * P3.value / Tau;
+	slopes[kCalibrationParameterIndexTau]		= -(K1 / Tau) / J1;
+
+	offsets[kCalibrationParameterIndexTransmissionExtOptics]	=	(K1 / TransmissionExtOptics) * (J0 / J1) +
+										P3.value / (Emiss * Tau * TransmissionExtOptics * TransmissionExtOptics);
+	slopes[kCalibrationParameterIndexTransmissionExtOptics]		= -(K1 / TransmissionExtOptics) / J1;
+
+	offsets[kCalibrationParameterIndexTRefl]	= -a1 * P1.derivativeT;
+	offsets[kCalibrationParameterIndexTAtmC]	= -a2 * P2.derivativeT;
+	offsets[kCalibrationParameterIndexTExtOptics]	= -a3 * P3.derivativeT;
+
+	offsets[kCalibrationParameterIndexR]		= -(a1 * P1.value + a2 * P2.value + a3 * P3.value) / R;
+	offsets[kCalibrationParameterIndexB]		= -(a1 * P1.derivativeB + a2 * P2.derivativeB + a3 * P3.derivativeB);
+	offsets[kCalibrationParameterIndexF]		= -(a1 * P1.derivativeF + a2 * P2.derivativeF + a3 * P3.derivativeF);
+
+	/*
+	 *	dsignal/dJ0 = -1 / J1 and dsignal/dJ1 = -signal / J1.
+	 */
+	offsets[kCalibrationParameterIndexJ0]		= -K1 / J1;
+	offsets[kCalibrationParameterIndexJ1]		= K1 * J0 / (J1 * J1);
+	slopes[kCalibrationParameterIndexJ1]		= -K1 / (J1 * J1);
+
+	offsets[kDeltaMethodInputIndexCounts]		= K1 / J1;
+
+	return;
+}
+
+void
+deltaMethodPropagate(
+	const DeltaMethodContext *	deltaMethodContext,
+	double				countsMean,
+	double				countsVariance,
+	DeltaMethodResult *		result)
+{
+	const CalibrationContext *	context = &deltaMethodContext->context;
+	double				D = (context->countsGain * countsMean) - context->countsOffset;
+	double				u = context->R / D + context->F;
+	double				logU = log(u);
+	double				dTdu = -context->B / (u * logU * logU);
+	double				dTdD = -dTdu * context->R / (D * D);
+	double				variance = 0;
+
+	for (size_t i = 0; i < kDeltaMethodInputIndexMax; i++)
+	{
+		double	derivative =	dTdD * (
+						deltaMethodContext->denominatorDerivativeOffsets[i] +
+						deltaMethodContext->denominatorDerivativeSlopes[i] * countsMean);
+		double	inputVariance = (i == kDeltaMethodInputIndexCounts) ? countsVariance : deltaMethodContext->parameterVariances[i];
+
+		/*
+		 *	R, B and F also appear in T = B / log(R / D + F) outside of D.
+		 */
+		switch (i)
+		{
+			case kCalibrationParameterIndexR:
+				derivative += dTdu / D;
+				break;
+			case kCalibrationParameterIndexB:
+				derivative += 1 / logU;
+				break;
+			case kCalibrationParameterIndexF:
+				derivative += dTdu;
+				break;
+			default:
+				break;
+		}
+
+		result->varianceContributions[i] = derivative * derivative * inputVariance;
+		variance += result->varianceContributions[i];
+	}
+
+	result->mean = context->B / logU - kAbsoluteZeroKelvinInCelsius;
+	result->standardDeviation = sqrt(variance);
+
+	return;
+}
+
+CommonConstantReturnType
+deltaMethodPropagateFrame(
+	const DeltaMethodContext *	deltaMethodContext,
+	const uint16_t *		rawCounts,
+	size_t				width,
+	size_t				height,
+	size_t				strideInPixels,
+	double				countsVariance,
+	double *			standardDeviations)
+{
+	DeltaMethodResult	result;
+
+	if ((deltaMethodContext == NULL) || (rawCounts == NULL) || (standardDeviations == NULL))
+	{
+		fprintf(stderr, "Error: Frame propagation called with a NULL context or frame pointer.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (strideInPixels < width)
+	{
+		fprintf(stderr, "Error: Frame stride (%zu pixels) is smaller than the frame width (%zu pixels).\n", strideInPixels, width);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t row = 0; row < height; row++)
+	{
+		for (size_t column = 0; column < width; column++)
+		{
+			deltaMethodPropagate(deltaMethodContext, rawCounts[row * strideInPixels + column], countsVariance, &result);
+			standardDeviations[row * width + column] = result.standardDeviation;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+const char *
+deltaMethodGetInputName(DeltaMethodInputIndex inputIndex)
+{
+	return (inputIndex == kDeltaMethodInputIndexCounts) ? "counts" : calibrationParameterGetName((CalibrationParameterIndex)inputIndex);
+}
@@ -0,0 +1,134 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration.h"
+
+/*
+ *	Inputs of the first-order propagation: the calibration parameters,
+ *	followed by the sensor counts.
+ */
+typedef enum
+{
+	kDeltaMethodInputIndexCounts		= kCalibrationParameterIndexMax,
+	kDeltaMethodInputIndexMax,
+} DeltaMethodInputIndex;
+
+typedef enum
+{
+	/*
+	 *	Number of Monte Carlo iterations the analytic result is compared
+	 *	against, unless `-M` gives another number.
+	 */
+	kDeltaMethodDefaultComparisonIterations	= 100000,
+} DeltaMethodConstant;
+
+/*
+ *	Count-independent terms of the first-order propagation. The temperature is
+ *	T = B / log(R / D + F) - 273.15, with D = K1 * (counts - J0) / J1 - K2.
+ *	D is linear in `counts`, so its partial derivative with respect to each
+ *	input is stored as `offset + slope * counts`.
+ */
+typedef struct
+{
+	CalibrationContext	context;
+	double			parameterVariances[kCalibrationParameterIndexMax];
+	double			denominatorDerivativeOffsets[kDeltaMethodInputIndexMax];
+	double			denominatorDerivativeSlopes[kDeltaMethodInputIndexMax];
+} DeltaMethodContext;
+
+typedef struct
+{
+	double	mean;
+	double	standardDeviation;
+	/*
+	 *	Contribution of each input to the variance, (dT/dx)^2 * Var(x).
+	 */
+	double	varianceContributions[kDeltaMethodInputIndexMax];
+} DeltaMethodResult;
+
+/**
+ *	@brief  Builds the count-independent terms of the first-order propagation around the
+ *		nominal calibration parameters. Each parameter is uniform with the given half-width,
+ *		so its variance is halfWidth^2 / 3.
+ *
+ *	@param  deltaMethodContext	: Pointer to the context to build.
+ *	@param  nominalParameters	: The nominal (mean) calibration parameters.
+ *	@param  parameterHalfWidths	: The half-widths of the calibration parameter distributions.
+ */
+void	deltaMethodContextInit(
+		DeltaMethodContext *		deltaMethodContext,
+		const CalibrationParameters *	nominalParameters,
+		const CalibrationParameters *	parameterHalfWidths);
+
+/**
+ *	@brief  Propagates the input variances to the temperature to first order, from the analytic
+ *		partial derivatives of the conversion at the nominal parameters and `countsMean`.
+ *		Costs about as much as two direct conversions.
+ *
+ *	@param  deltaMethodContext	: Pointer to a built context.
+ *	@param  countsMean		: Mean of the sensor counts.
+ *	@param  countsVariance		: Variance of the sensor counts.
+ *	@param  result			: Pointer to the result to fill.
+ */
+void	deltaMethodPropagate(
+		const DeltaMethodContext *	deltaMethodContext,
+		double				countsMean,
+		double				countsVariance,
+		DeltaMethodResult *		result);
+
+/**
+ *	@brief  Computes the first-order standard deviation of every pixel of a frame of raw counts.
+ *		Arguments are as for `convertRawCountsFrameToTemperature()`.
+ *
+ *	@param  deltaMethodContext	: Pointer to a built context.
+ *	@param  rawCounts		: Pointer to the first pixel of the frame of raw 16-bit counts.
+ *	@param  width			: Number of pixels per row.
+ *	@param  height			: Number of rows.
+ *	@param  strideInPixels		: Distance, in pixels, between the starts of consecutive rows of `rawCounts`.
+ *	@param  countsVariance		: Variance of each count, e.g. 1/12 for quantization alone.
+ *	@param  standardDeviations	: Output array of `width * height` standard deviations, row by row.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	deltaMethodPropagateFrame(
+					const DeltaMethodContext *	deltaMethodContext,
+					const uint16_t *		rawCounts,
+					size_t				width,
+					size_t				height,
+					size_t				strideInPixels,
+					double				countsVariance,
+					double *			standardDeviations);
+
+/**
+ *	@brief  Returns a printable name for an input of the first-order propagation.
+ *
+ *	@param  inputIndex		: The input.
+ *
+ *	@return				: The name of the input, as in the FLIR reference formula.
+ */
+const char *	deltaMethodGetInputName(DeltaMethodInputIndex inputIndex);
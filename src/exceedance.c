@@ -0,0 +1,189 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "exceedance.h"
+#include "timing.h"
+
+/*
+ *	Maps a double to an unsigned key with the same order: negative values have
+ *	all bits flipped, positive values only the sign bit. Every NaN maps to the
+ *	largest key.
+ */
+static inline uint64_t
+exceedanceKeyFromDouble(double value)
+{
+	uint64_t	bits;
+
+	if (isnan(value))
+	{
+		return UINT64_MAX;
+	}
+
+	memcpy(&bits, &value, sizeof(bits));
+
+	return (bits >> 63) ? ~bits : (bits | (1ULL << 63));
+}
+
+static inline double
+exceedanceDoubleFromKey(uint64_t key)
+{
+	uint64_t	bits = (key >> 63) ? (key & ~(1ULL << 63)) : ~key;
+	double		value;
+
+	memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+CommonConstantReturnType
+exceedanceTableBuild(ExceedanceTable *  table, const double *  samples, size_t numberOfSamples)
+{
+	uint64_t *	keys;
+	uint64_t *	scratch;
+	size_t *	bucketStarts;
+	double		start = getMonotonicTimeInSeconds();
+
+	keys = (uint64_t *) checkedMalloc((numberOfSamples + 1) * sizeof(uint64_t), __FILE__, __LINE__);
+	scratch = (uint64_t *) checkedMalloc((numberOfSamples + 1) * sizeof(uint64_t), __FILE__, __LINE__);
+	bucketStarts = (size_t *) checkedMalloc(kExceedanceRadixBuckets * sizeof(size_t), __FILE__, __LINE__);
+
+	for (size_t i = 0; i < numberOfSamples; i++)
+	{
+		keys[i] = exceedanceKeyFromDouble(samples[i]);
+	}
+
+	for (int shift = 0; shift < 64; shift += kExceedanceRadixBits)
+	{
+		uint64_t *	swap;
+		size_t		position = 0;
+
+		memset(bucketStarts, 0, kExceedanceRadixBuckets * sizeof(size_t));
+
+		for (size_t i = 0; i < numberOfSamples; i++)
+		{
+			bucketStarts[(keys[i] >> shift) & (kExceedanceRadixBuckets - 1)]++;
+		}
+
+		/*
+		 *	Samples of a narrow distribution share their high bits, so passes
+		 *	with a single non-empty bucket are skipped.
+		 */
+		if ((numberOfSamples == 0) || (bucketStarts[(keys[0] >> shift) & (kExceedanceRadixBuckets - 1)] == numberOfSamples))
+		{
+			continue;
+		}
+
+		for (size_t bucket = 0; bucket < kExceedanceRadixBuckets; bucket++)
+		{
+			size_t	bucketSize = bucketStarts[bucket];
+
+			bucketStarts[bucket] = position;
+			position += bucketSize;
+		}
+
+		for (size_t i = 0; i < numberOfSamples; i++)
+		{
+			scratch[bucketStarts[(keys[i] >> shift) & (kExceedanceRadixBuckets - 1)]++] = keys[i];
+		}
+
+		swap = keys;
+		keys = scratch;
+		scratch = swap;
+	}
+
+	/*
+	 *	The keys are converted back in place.
+	 */
+	for (size_t i = 0; i < numberOfSamples; i++)
+	{
+		double	value = exceedanceDoubleFromKey(keys[i]);
+
+		memcpy(&keys[i], &value, sizeof(value));
+	}
+
+	table->sortedSamples = (double *) keys;
+
+	table->numberOfSamples = numberOfSamples;
+	table->numberOfOrderedSamples = numberOfSamples;
+	while ((table->numberOfOrderedSamples > 0) && isnan(table->sortedSamples[table->numberOfOrderedSamples - 1]))
+	{
+		table->numberOfOrderedSamples--;
+	}
+
+	free(bucketStarts);
+	free(scratch);
+
+	table->buildTimeSeconds = getMonotonicTimeInSeconds() - start;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+exceedanceTableFree(ExceedanceTable *  table)
+{
+	free(table->sortedSamples);
+	table->sortedSamples = NULL;
+	table->numberOfSamples = 0;
+	table->numberOfOrderedSamples = 0;
+
+	return;
+}
+
+double
+exceedanceTableProbabilityGT(const ExceedanceTable *  table, double threshold)
+{
+	size_t	low = 0;
+	size_t	high = table->numberOfOrderedSamples;
+
+	if (table->numberOfSamples == 0)
+	{
+		return NAN;
+	}
+
+	/*
+	 *	Find the first sample greater than `threshold` among those before the NaN
+	 *	samples, so that, as in the per-pixel maps of `monteCarloRunFrame()`, a NaN
+	 *	(below-range) sample never counts as exceeding a threshold. A NaN threshold
+	 *	is exceeded by no sample.
+	 */
+	while (low < high)
+	{
+		size_t	middle = low + (high - low) / 2;
+
+		if (!(table->sortedSamples[middle] > threshold))
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return (double) (table->numberOfOrderedSamples - low) / (double) table->numberOfSamples;
+}
@@ -0,0 +1,87 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+
+typedef enum
+{
+	/*
+	 *	Most alarm thresholds accepted by `-pt`.
+	 */
+	kExceedanceMaximumThresholds	= 16,
+	/*
+	 *	The radix sort orders the 64-bit keys of the samples by this many bits per pass.
+	 */
+	kExceedanceRadixBits		= 16,
+	kExceedanceRadixBuckets		= 1 << kExceedanceRadixBits,
+} ExceedanceConstant;
+
+/*
+ *	The output samples of a Monte Carlo run, sorted once so that the probability
+ *	of exceeding any threshold is a binary search.
+ */
+typedef struct
+{
+	double *	sortedSamples;
+	size_t		numberOfSamples;
+	/*
+	 *	The samples that are not NaN, which come first.
+	 */
+	size_t		numberOfOrderedSamples;
+	double		buildTimeSeconds;
+} ExceedanceTable;
+
+/**
+ *	@brief  Builds an exceedance table from a copy of the samples, sorted with an LSD radix
+ *		sort in O(N). NaN samples sort above +infinity.
+ *
+ *	@param  table		: Pointer to the table to build. Free with `exceedanceTableFree()`.
+ *	@param  samples		: The samples.
+ *	@param  numberOfSamples	: Number of samples.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	exceedanceTableBuild(ExceedanceTable *  table, const double *  samples, size_t numberOfSamples);
+
+/**
+ *	@brief  Frees the memory held by a table built with `exceedanceTableBuild()`.
+ *
+ *	@param  table		: Pointer to the table.
+ */
+void	exceedanceTableFree(ExceedanceTable *  table);
+
+/**
+ *	@brief  Returns the fraction of the samples greater than a threshold, in O(log N).
+ *		The native counterpart of `UxHwDoubleProbabilityGT()`. As with `>`, NaN samples
+ *		exceed no threshold, though they count towards the number of samples.
+ *
+ *	@param  table		: Pointer to a built table.
+ *	@param  threshold	: The threshold.
+ *
+ *	@return			: The probability of exceeding `threshold`, or NAN for an empty table.
+ */
+double	exceedanceTableProbabilityGT(const ExceedanceTable *  table, double threshold);
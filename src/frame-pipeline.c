@@ -0,0 +1,538 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include "common.h"
+#include "conversion.h"
+#include "lookup-table.h"
+#include "raw-frames.h"
+#include "streaming-statistics.h"
+#include "timing.h"
+#include "stream-io.h"
+#include "frame-pipeline.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#define kFramePipelineHavePosix	(1)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#else
+#define kFramePipelineHavePosix	(0)
+#endif
+
+/*
+ *	Latency percentiles reported by `framePipelinePrintReport()`.
+ */
+static const double	kFramePipelineLatencyPercentileProbabilities[] = {0.50, 0.90, 0.99, 0.999};
+enum
+{
+	kFramePipelineNumberOfLatencyPercentiles	= sizeof(kFramePipelineLatencyPercentileProbabilities) / sizeof(kFramePipelineLatencyPercentileProbabilities[0]),
+};
+
+#if kFramePipelineHavePosix
+
+typedef enum
+{
+	kFramePipelineBufferStateFree		= 0,
+	kFramePipelineBufferStateRead,
+	kFramePipelineBufferStateConverted,
+} FramePipelineBufferState;
+
+typedef struct
+{
+	uint16_t *			rawCounts;
+	/*
+	 *	`double` or `float` temperatures, as the configured precision.
+	 */
+	void *				temperatures;
+	double				arrivalTime;
+	FramePipelineBufferState	state;
+} FramePipelineBuffer;
+
+typedef struct
+{
+	const FramePipelineConfiguration *	configuration;
+	FramePipelineReport *			report;
+	int					inputFileDescriptor;
+	int					outputFileDescriptor;
+	size_t					pixelsPerFrame;
+	size_t					bytesPerTemperature;
+	FramePipelineBuffer			buffers[kFramePipelineNumberOfBuffers];
+	/*
+	 *	The reader fills this spare buffer and swaps it with a free pipeline
+	 *	buffer, so a frame is only dropped if no buffer is free once it has
+	 *	been read in full.
+	 */
+	uint16_t *				readerRawCounts;
+	size_t					numberOfFramesQueued;
+	size_t					numberOfFramesConverted;
+	bool					isInputFinished;
+	bool					isConversionFinished;
+	bool					isAborted;
+	pthread_mutex_t				mutex;
+	pthread_cond_t				condition;
+} FramePipeline;
+
+static void *
+framePipelineReader(void *  argument)
+{
+	FramePipeline *	pipeline = (FramePipeline *) argument;
+	size_t		frameBytes = pipeline->pixelsPerFrame * sizeof(uint16_t);
+
+	for (;;)
+	{
+		ssize_t			count = streamReadFully(
+							pipeline->inputFileDescriptor,
+							pipeline->readerRawCounts,
+							frameBytes);
+		double			arrivalTime = getMonotonicTimeInSeconds();
+		FramePipelineBuffer *	buffer;
+		uint16_t *		swap;
+
+		if (count != (ssize_t) frameBytes)
+		{
+			pthread_mutex_lock(&pipeline->mutex);
+			if (count < 0)
+			{
+				fprintf(stderr, "Error: Could not read from the frame stream.\n");
+				pipeline->isAborted = true;
+			}
+			pipeline->report->hasTruncatedFrame = (count > 0);
+			pthread_mutex_unlock(&pipeline->mutex);
+
+			break;
+		}
+
+		pthread_mutex_lock(&pipeline->mutex);
+		pipeline->report->numberOfFramesRead++;
+		buffer = &pipeline->buffers[pipeline->numberOfFramesQueued % kFramePipelineNumberOfBuffers];
+
+		while (!pipeline->configuration->isRealTime && (buffer->state != kFramePipelineBufferStateFree) && !pipeline->isAborted)
+		{
+			pthread_cond_wait(&pipeline->condition, &pipeline->mutex);
+		}
+
+		if (pipeline->isAborted)
+		{
+			pthread_mutex_unlock(&pipeline->mutex);
+
+			break;
+		}
+
+		if (buffer->state != kFramePipelineBufferStateFree)
+		{
+			pipeline->report->numberOfFramesDropped++;
+			pthread_mutex_unlock(&pipeline->mutex);
+
+			continue;
+		}
+
+		swap = buffer->rawCounts;
+		buffer->rawCounts = pipeline->readerRawCounts;
+		pipeline->readerRawCounts = swap;
+		buffer->arrivalTime = arrivalTime;
+		buffer->state = kFramePipelineBufferStateRead;
+		pipeline->numberOfFramesQueued++;
+		pthread_cond_broadcast(&pipeline->condition);
+		pthread_mutex_unlock(&pipeline->mutex);
+	}
+
+	pthread_mutex_lock(&pipeline->mutex);
+	pipeline->isInputFinished = true;
+	pthread_cond_broadcast(&pipeline->condition);
+	pthread_mutex_unlock(&pipeline->mutex);
+
+	return NULL;
+}
+
+static void *
+framePipelineConverter(void *  argument)
+{
+	FramePipeline *				pipeline = (FramePipeline *) argument;
+	const FramePipelineConfiguration *	configuration = pipeline->configuration;
+
+	for (size_t frameIndex = 0; ; frameIndex++)
+	{
+		FramePipelineBuffer *		buffer = &pipeline->buffers[frameIndex % kFramePipelineNumberOfBuffers];
+		CommonConstantReturnType	ret;
+
+		pthread_mutex_lock(&pipeline->mutex);
+		while ((buffer->state != kFramePipelineBufferStateRead) &&
+			!(pipeline->isInputFinished && (pipeline->numberOfFramesQueued == frameIndex)) &&
+			!pipeline->isAborted)
+		{
+			pthread_cond_wait(&pipeline->condition, &pipeline->mutex);
+		}
+
+		if (buffer->state != kFramePipelineBufferStateRead)
+		{
+			pthread_mutex_unlock(&pipeline->mutex);
+
+			break;
+		}
+		pthread_mutex_unlock(&pipeline->mutex);
+
+		if (configuration->lookupTable != NULL)
+		{
+			ret = convertRawCountsFrameToTemperatureViaLookupTable(
+				configuration->lookupTable,
+				buffer->rawCounts,
+				pipeline->report->width,
+				pipeline->report->height,
+				pipeline->report->width,
+				buffer->temperatures);
+		}
+		else if (configuration->precision == kConversionPrecisionFloat32)
+		{
+			ret = convertRawCountsFrameToTemperatureFloat32(
+				configuration->context,
+				buffer->rawCounts,
+				pipeline->report->width,
+				pipeline->report->height,
+				pipeline->report->width,
+				(float *) buffer->temperatures);
+		}
+		else
+		{
+			ret = convertRawCountsFrameToTemperatureVectorized(
+				configuration->context,
+				buffer->rawCounts,
+				pipeline->report->width,
+				pipeline->report->height,
+				pipeline->report->width,
+				(double *) buffer->temperatures);
+		}
+
+		pthread_mutex_lock(&pipeline->mutex);
+		if (ret != kCommonConstantReturnTypeSuccess)
+		{
+			pipeline->isAborted = true;
+		}
+		buffer->state = kFramePipelineBufferStateConverted;
+		pipeline->numberOfFramesConverted++;
+		pthread_cond_broadcast(&pipeline->condition);
+		pthread_mutex_unlock(&pipeline->mutex);
+	}
+
+	pthread_mutex_lock(&pipeline->mutex);
+	pipeline->isConversionFinished = true;
+	pthread_cond_broadcast(&pipeline->condition);
+	pthread_mutex_unlock(&pipeline->mutex);
+
+	return NULL;
+}
+
+/*
+ *	The writer runs on the calling thread.
+ */
+static CommonConstantReturnType
+framePipelineWriter(FramePipeline *  pipeline)
+{
+	size_t	frameBytes = pipeline->pixelsPerFrame * pipeline->bytesPerTemperature;
+
+	for (size_t frameIndex = 0; ; frameIndex++)
+	{
+		FramePipelineBuffer *	buffer = &pipeline->buffers[frameIndex % kFramePipelineNumberOfBuffers];
+		double			latency;
+
+		pthread_mutex_lock(&pipeline->mutex);
+		while ((buffer->state != kFramePipelineBufferStateConverted) &&
+			!(pipeline->isConversionFinished && (pipeline->numberOfFramesConverted == frameIndex)) &&
+			!pipeline->isAborted)
+		{
+			pthread_cond_wait(&pipeline->condition, &pipeline->mutex);
+		}
+
+		if ((buffer->state != kFramePipelineBufferStateConverted) || pipeline->isAborted)
+		{
+			pthread_mutex_unlock(&pipeline->mutex);
+
+			break;
+		}
+		pthread_mutex_unlock(&pipeline->mutex);
+
+		if (streamWriteFully(pipeline->outputFileDescriptor, buffer->temperatures, frameBytes) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: Could not write frame %zu to the output stream.\n", frameIndex);
+
+			pthread_mutex_lock(&pipeline->mutex);
+			pipeline->isAborted = true;
+			pthread_cond_broadcast(&pipeline->condition);
+			pthread_mutex_unlock(&pipeline->mutex);
+
+			break;
+		}
+
+		latency = getMonotonicTimeInSeconds() - buffer->arrivalTime;
+		streamingStatisticsAdd(&pipeline->report->latencySeconds, &latency, 1);
+
+		pthread_mutex_lock(&pipeline->mutex);
+		pipeline->report->numberOfFramesWritten++;
+		buffer->state = kFramePipelineBufferStateFree;
+		pthread_cond_broadcast(&pipeline->condition);
+		pthread_mutex_unlock(&pipeline->mutex);
+	}
+
+	return pipeline->isAborted ? kCommonConstantReturnTypeError : kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Reads and checks the input stream header, and writes the output stream header.
+ */
+static CommonConstantReturnType
+framePipelineExchangeHeaders(FramePipeline *  pipeline)
+{
+	RawFrameFileHeader	header;
+
+	if (streamReadFully(pipeline->inputFileDescriptor, &header, sizeof(header)) != (ssize_t) sizeof(header))
+	{
+		fprintf(stderr, "Error: The frame stream ended before its header.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((header.magic != kRawFrameFileMagic) || (header.width == 0) || (header.height == 0))
+	{
+		fprintf(stderr, "Error: The frame stream does not start with a valid raw frame header.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	pipeline->report->width = header.width;
+	pipeline->report->height = header.height;
+
+	/*
+	 *	The output header is written before any frame, so that a consumer can
+	 *	size its buffers while the first frame is converted.
+	 */
+	header.magic = (pipeline->configuration->precision == kConversionPrecisionFloat32) ? kRawTemperatureFileFloat32Magic : kRawTemperatureFileMagic;
+	header.frameCount = 0;
+	if (streamWriteFully(pipeline->outputFileDescriptor, &header, sizeof(header)) != kCommonConstantReturnTypeSuccess)
+	{
+		fprintf(stderr, "Error: Could not write the output stream header.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	pipeline->pixelsPerFrame = (size_t) header.width * header.height;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+static void
+framePipelineCloseStreams(FramePipeline *  pipeline)
+{
+	if ((pipeline->configuration->inputPath != NULL) && (pipeline->inputFileDescriptor >= 0))
+	{
+		close(pipeline->inputFileDescriptor);
+	}
+
+	if ((pipeline->configuration->outputPath != NULL) && (pipeline->outputFileDescriptor >= 0))
+	{
+		close(pipeline->outputFileDescriptor);
+	}
+
+	return;
+}
+
+#endif /* kFramePipelineHavePosix */
+
+CommonConstantReturnType
+framePipelineRun(const FramePipelineConfiguration *  configuration, FramePipelineReport *  report)
+{
+	memset(report, 0, sizeof(*report));
+	streamingStatisticsInit(&report->latencySeconds);
+
+#if kFramePipelineHavePosix
+	FramePipeline			pipeline = {0};
+	CommonConstantReturnType	ret;
+	pthread_t			readerThread;
+	pthread_t			converterThread;
+	double				start;
+
+	if (!rawFrameHostIsLittleEndian())
+	{
+		fprintf(stderr, "Error: Raw frame streams can only be converted on little-endian hosts.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	pipeline.configuration = configuration;
+	pipeline.report = report;
+	pipeline.bytesPerTemperature = (configuration->precision == kConversionPrecisionFloat32) ? sizeof(float) : sizeof(double);
+	pipeline.inputFileDescriptor = (configuration->inputPath != NULL) ? open(configuration->inputPath, O_RDONLY) : STDIN_FILENO;
+	pipeline.outputFileDescriptor = (configuration->outputPath != NULL) ? open(configuration->outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+
+	if ((pipeline.inputFileDescriptor < 0) || (pipeline.outputFileDescriptor < 0))
+	{
+		fprintf(
+			stderr,
+			"Error: Could not open %s \"%s\".\n",
+			(pipeline.inputFileDescriptor < 0) ? "input stream" : "output stream",
+			(pipeline.inputFileDescriptor < 0) ? configuration->inputPath : configuration->outputPath);
+		framePipelineCloseStreams(&pipeline);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (framePipelineExchangeHeaders(&pipeline) != kCommonConstantReturnTypeSuccess)
+	{
+		framePipelineCloseStreams(&pipeline);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	pipeline.readerRawCounts = (uint16_t *) checkedMalloc(pipeline.pixelsPerFrame * sizeof(uint16_t), __FILE__, __LINE__);
+	for (size_t i = 0; i < kFramePipelineNumberOfBuffers; i++)
+	{
+		pipeline.buffers[i].rawCounts = (uint16_t *) checkedMalloc(pipeline.pixelsPerFrame * sizeof(uint16_t), __FILE__, __LINE__);
+		pipeline.buffers[i].temperatures = checkedMalloc(pipeline.pixelsPerFrame * pipeline.bytesPerTemperature, __FILE__, __LINE__);
+	}
+	pthread_mutex_init(&pipeline.mutex, NULL);
+	pthread_cond_init(&pipeline.condition, NULL);
+
+	start = getMonotonicTimeInSeconds();
+
+	if (pthread_create(&readerThread, NULL, framePipelineReader, &pipeline) != 0)
+	{
+		fprintf(stderr, "Error: Could not create the frame reader thread.\n");
+		ret = kCommonConstantReturnTypeError;
+	}
+	else
+	{
+		if (pthread_create(&converterThread, NULL, framePipelineConverter, &pipeline) != 0)
+		{
+			fprintf(stderr, "Error: Could not create the frame conversion thread.\n");
+
+			pthread_mutex_lock(&pipeline.mutex);
+			pipeline.isAborted = true;
+			pthread_cond_broadcast(&pipeline.condition);
+			pthread_mutex_unlock(&pipeline.mutex);
+
+			ret = kCommonConstantReturnTypeError;
+		}
+		else
+		{
+			ret = framePipelineWriter(&pipeline);
+			pthread_join(converterThread, NULL);
+		}
+
+		/*
+		 *	If the pipeline was aborted while the reader is blocked in `read()`,
+		 *	the reader exits once the producer writes or closes the stream.
+		 */
+		pthread_join(readerThread, NULL);
+	}
+
+	report->elapsedSeconds = getMonotonicTimeInSeconds() - start;
+
+	if (pipeline.isAborted)
+	{
+		ret = kCommonConstantReturnTypeError;
+	}
+
+	pthread_cond_destroy(&pipeline.condition);
+	pthread_mutex_destroy(&pipeline.mutex);
+	for (size_t i = 0; i < kFramePipelineNumberOfBuffers; i++)
+	{
+		free(pipeline.buffers[i].temperatures);
+		free(pipeline.buffers[i].rawCounts);
+	}
+	free(pipeline.readerRawCounts);
+	framePipelineCloseStreams(&pipeline);
+
+	return ret;
+#else
+	(void) configuration;
+	fprintf(stderr, "Error: The streaming frame pipeline is not supported on this platform.\n");
+
+	return kCommonConstantReturnTypeError;
+#endif
+}
+
+void
+framePipelineReportFree(FramePipelineReport *  report)
+{
+	streamingStatisticsFree(&report->latencySeconds);
+
+	return;
+}
+
+void
+framePipelinePrintReport(FILE *  stream, const FramePipelineReport *  report, const char *  kernelName)
+{
+	double	latencyPercentiles[kFramePipelineNumberOfLatencyPercentiles];
+
+	fprintf(
+		stream,
+		"Frame stream: %" PRIu32 "x%" PRIu32 " pixels, %zu frames read, %zu written, %zu dropped, via %s.\n",
+		report->width,
+		report->height,
+		report->numberOfFramesRead,
+		report->numberOfFramesWritten,
+		report->numberOfFramesDropped,
+		kernelName);
+
+	if (report->hasTruncatedFrame)
+	{
+		fprintf(stream, "\tThe stream ended part-way through a frame, which was discarded.\n");
+	}
+
+	if (report->elapsedSeconds > 0)
+	{
+		fprintf(
+			stream,
+			"\tThroughput: %.1lf frames/s over %.3lf seconds\n",
+			report->numberOfFramesWritten / report->elapsedSeconds,
+			report->elapsedSeconds);
+	}
+
+	if (report->latencySeconds.moments.count == 0)
+	{
+		return;
+	}
+
+	streamingStatisticsQuantiles(
+		&report->latencySeconds,
+		kFramePipelineLatencyPercentileProbabilities,
+		kFramePipelineNumberOfLatencyPercentiles,
+		latencyPercentiles);
+
+	for (size_t i = 0; i < kFramePipelineNumberOfLatencyPercentiles; i++)
+	{
+		fprintf(
+			stream,
+			"\tLatency percentile %g%%: %.3lf ms\n",
+			100 * kFramePipelineLatencyPercentileProbabilities[i],
+			1e3 * latencyPercentiles[i]);
+	}
+	fprintf(stream, "\tLatency maximum: %.3lf ms\n", 1e3 * report->latencySeconds.moments.maximum);
+
+	return;
+}
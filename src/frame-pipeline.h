@@ -0,0 +1,124 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "calibration.h"
+#include "conversion.h"
+#include "lookup-table.h"
+#include "streaming-statistics.h"
+
+/*
+ *	The streaming pipeline reads a raw frame stream: the header of
+ *	`raw-frames.h`, followed by uint16 frames until the end of the stream. A
+ *	`frameCount` of zero in the header means that the number of frames is not
+ *	known in advance. The output stream carries the raw temperature file header
+ *	with a `frameCount` of zero, followed by one float64 (or, with
+ *	`kConversionPrecisionFloat32`, float32) frame per converted frame.
+ */
+typedef enum
+{
+	/*
+	 *	Frame N+1 is read while frame N is converted and frame N-1 is written.
+	 */
+	kFramePipelineNumberOfBuffers	= 3,
+} FramePipelineConstant;
+
+typedef struct
+{
+	/*
+	 *	Paths of the input and output streams, e.g. FIFOs. NULL selects
+	 *	stdin and stdout respectively.
+	 */
+	const char *			inputPath;
+	const char *			outputPath;
+	/*
+	 *	If `true`, a frame that arrives while all buffers are busy is dropped
+	 *	instead of blocking the producer. If `false`, the pipeline is lossless
+	 *	and applies back-pressure.
+	 */
+	bool				isRealTime;
+	const CalibrationContext *	context;
+	/*
+	 *	If non-NULL, frames are converted through this table instead of the
+	 *	vectorized frame kernel.
+	 */
+	const CountsLookupTable *	lookupTable;
+	/*
+	 *	Precision of the vectorized frame kernel, and of the output frames.
+	 *	The lookup table is float64 only.
+	 */
+	ConversionPrecision		precision;
+} FramePipelineConfiguration;
+
+typedef struct
+{
+	uint32_t		width;
+	uint32_t		height;
+	size_t			numberOfFramesRead;
+	size_t			numberOfFramesWritten;
+	size_t			numberOfFramesDropped;
+	/*
+	 *	`true` if the stream ended part-way through a frame.
+	 */
+	bool			hasTruncatedFrame;
+	/*
+	 *	Time from a frame being fully read to its temperatures being fully written.
+	 */
+	StreamingStatistics	latencySeconds;
+	double			elapsedSeconds;
+} FramePipelineReport;
+
+/**
+ *	@brief  Runs the streaming pipeline until the end of the input stream. A reader thread,
+ *		a conversion thread and the calling thread (the writer) hand frames to each other
+ *		through `kFramePipelineNumberOfBuffers` buffers.
+ *
+ *	@param  configuration	: Pointer to the pipeline configuration.
+ *	@param  report		: Pointer to the report to fill. Free with `framePipelineReportFree()`,
+ *				  also when the pipeline fails.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	framePipelineRun(const FramePipelineConfiguration *  configuration, FramePipelineReport *  report);
+
+/**
+ *	@brief  Frees the memory held by a pipeline report.
+ *
+ *	@param  report		: Pointer to the report.
+ */
+void	framePipelineReportFree(FramePipelineReport *  report);
+
+/**
+ *	@brief  Prints a pipeline report (frame counts, throughput and latency percentiles) to a stream.
+ *
+ *	@param  stream		: The stream to print to.
+ *	@param  report		: Pointer to the report.
+ *	@param  kernelName	: A string naming the conversion kernel used.
+ */
+void	framePipelinePrintReport(FILE *  stream, const FramePipelineReport *  report, const char *  kernelName);
@@ -0,0 +1,134 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "incremental-conversion.h"
+
+/*
+ *	An exact comparison is a `memcmp()`, which the C library vectorizes. With a
+ *	tolerance, the largest absolute difference is a branch-free reduction that
+ *	the compiler vectorizes into saturating subtractions and maxima.
+ */
+static bool
+incrementalConversionIsTileChanged(const uint16_t *  referenceCounts, const uint16_t *  rawCounts, size_t numberOfPixels, uint16_t countTolerance)
+{
+	uint16_t	largestDifference = 0;
+
+	if (countTolerance == 0)
+	{
+		return memcmp(referenceCounts, rawCounts, numberOfPixels * sizeof(uint16_t)) != 0;
+	}
+
+	for (size_t i = 0; i < numberOfPixels; i++)
+	{
+		uint16_t	difference = (rawCounts[i] > referenceCounts[i]) ? (rawCounts[i] - referenceCounts[i]) : (referenceCounts[i] - rawCounts[i]);
+
+		largestDifference = (difference > largestDifference) ? difference : largestDifference;
+	}
+
+	return largestDifference > countTolerance;
+}
+
+void
+incrementalConversionInit(IncrementalConversion *  incremental, size_t width, size_t height, uint16_t countTolerance)
+{
+	size_t	tilesPerRow = (width + kIncrementalConversionTileWidth - 1) / kIncrementalConversionTileWidth;
+
+	incremental->width = width;
+	incremental->height = height;
+	incremental->countTolerance = countTolerance;
+	incremental->referenceCounts = (uint16_t *) checkedMalloc(width * height * sizeof(uint16_t), __FILE__, __LINE__);
+	incremental->hasReferenceCounts = false;
+	incremental->spans = (IncrementalConversionSpan *) checkedMalloc(tilesPerRow * height * sizeof(IncrementalConversionSpan), __FILE__, __LINE__);
+	incremental->numberOfSpans = 0;
+	incremental->numberOfChangedPixels = 0;
+
+	return;
+}
+
+void
+incrementalConversionInvalidate(IncrementalConversion *  incremental)
+{
+	incremental->hasReferenceCounts = false;
+
+	return;
+}
+
+void
+incrementalConversionFindChanges(IncrementalConversion *  incremental, const uint16_t *  rawCounts, size_t strideInPixels)
+{
+	size_t	width = incremental->width;
+
+	incremental->numberOfSpans = 0;
+	incremental->numberOfChangedPixels = 0;
+
+	for (size_t row = 0; row < incremental->height; row++)
+	{
+		const uint16_t *		rowCounts = &rawCounts[row * strideInPixels];
+		uint16_t *			rowReferenceCounts = &incremental->referenceCounts[row * width];
+		IncrementalConversionSpan *	span = NULL;
+
+		for (size_t column = 0; column < width; column += kIncrementalConversionTileWidth)
+		{
+			size_t	tileWidth = (width - column < kIncrementalConversionTileWidth) ? (width - column) : kIncrementalConversionTileWidth;
+
+			if (incremental->hasReferenceCounts &&
+				!incrementalConversionIsTileChanged(&rowReferenceCounts[column], &rowCounts[column], tileWidth, incremental->countTolerance))
+			{
+				span = NULL;
+
+				continue;
+			}
+
+			memcpy(&rowReferenceCounts[column], &rowCounts[column], tileWidth * sizeof(uint16_t));
+			if (span == NULL)
+			{
+				span = &incremental->spans[incremental->numberOfSpans++];
+				span->row = row;
+				span->column = column;
+				span->numberOfPixels = 0;
+			}
+			span->numberOfPixels += tileWidth;
+			incremental->numberOfChangedPixels += tileWidth;
+		}
+	}
+
+	incremental->hasReferenceCounts = true;
+
+	return;
+}
+
+void
+incrementalConversionFree(IncrementalConversion *  incremental)
+{
+	free(incremental->spans);
+	free(incremental->referenceCounts);
+	incremental->spans = NULL;
+	incremental->referenceCounts = NULL;
+
+	return;
+}
@@ -0,0 +1,107 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+
+/*
+ *	Incremental conversion of a sequence of frames from a fixed camera. Each row
+ *	is split into tiles, and a tile is converted again only if one of its counts
+ *	differs by more than a tolerance from the counts its current temperatures
+ *	were converted from. Consecutive changed tiles of a row form one span, so
+ *	the frame kernels still run on long runs of pixels.
+ */
+typedef enum
+{
+	/*
+	 *	Pixels per tile: one 64-byte cache line of uint16 counts.
+	 */
+	kIncrementalConversionTileWidth	= 32,
+} IncrementalConversionConstant;
+
+typedef struct
+{
+	size_t	row;
+	size_t	column;
+	size_t	numberOfPixels;
+} IncrementalConversionSpan;
+
+typedef struct
+{
+	size_t				width;
+	size_t				height;
+	uint16_t			countTolerance;
+	/*
+	 *	The counts that the current result of each pixel was converted from,
+	 *	valid once `hasReferenceCounts` is set.
+	 */
+	uint16_t *			referenceCounts;
+	bool				hasReferenceCounts;
+	/*
+	 *	The spans of the last frame to convert, at most one per tile, and the
+	 *	number of pixels they cover.
+	 */
+	IncrementalConversionSpan *	spans;
+	size_t				numberOfSpans;
+	size_t				numberOfChangedPixels;
+} IncrementalConversion;
+
+/**
+ *	@brief  Initializes incremental conversion for frames of a given size. The first frame is
+ *		converted in full.
+ *
+ *	@param  incremental	: Pointer to the state to initialize. Free with `incrementalConversionFree()`.
+ *	@param  width		: Frame width in pixels.
+ *	@param  height		: Frame height in pixels.
+ *	@param  countTolerance	: Largest change of a count, from the counts of its current result, that
+ *				  does not convert it again. Zero converts every changed pixel's tile.
+ */
+void	incrementalConversionInit(IncrementalConversion *  incremental, size_t width, size_t height, uint16_t countTolerance);
+
+/**
+ *	@brief  Makes the next frame convert in full, e.g. when its calibration differs from that of
+ *		the current results.
+ *
+ *	@param  incremental	: Pointer to the state.
+ */
+void	incrementalConversionInvalidate(IncrementalConversion *  incremental);
+
+/**
+ *	@brief  Compares a frame with the reference counts, tile by tile, and sets the spans of the
+ *		tiles to convert again. The reference counts of those tiles become the frame's.
+ *
+ *	@param  incremental	: Pointer to the state.
+ *	@param  rawCounts	: Pointer to the first pixel of the frame of raw 16-bit counts.
+ *	@param  strideInPixels	: Distance, in pixels, between the starts of consecutive rows of `rawCounts`.
+ */
+void	incrementalConversionFindChanges(IncrementalConversion *  incremental, const uint16_t *  rawCounts, size_t strideInPixels);
+
+/**
+ *	@brief  Frees the reference counts and spans.
+ *
+ *	@param  incremental	: Pointer to the state.
+ */
+void	incrementalConversionFree(IncrementalConversion *  incremental);
@@ -0,0 +1,154 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include "instrumentation.h"
+
+typedef enum
+{
+	kInstrumentationClockOverheadReads	= 1000,
+} InstrumentationClockConstant;
+
+static InstrumentationCounters	processCounters;
+
+static const char *		kInstrumentationStageNames[kInstrumentationStageMax] =
+				{
+					[kInstrumentationStageInputSampling]	= "Input sampling",
+					[kInstrumentationStageRadianceTerms]	= "Radiance terms (K1, K2)",
+					[kInstrumentationStageLogarithm]	= "Conversion (log)",
+					[kInstrumentationStageStatistics]	= "Mean and variance",
+					[kInstrumentationStageOutput]		= "Output writing",
+					[kInstrumentationStageSerialization]	= "JSON serialization",
+				};
+
+InstrumentationCounters *
+instrumentationGetProcessCounters(void)
+{
+	return &processCounters;
+}
+
+void
+instrumentationMerge(InstrumentationCounters *  destination, const InstrumentationCounters *  source)
+{
+	for (int stage = 0; stage < kInstrumentationStageMax; stage++)
+	{
+		destination->calls[stage] += source->calls[stage];
+		destination->timedCalls[stage] += source->timedCalls[stage];
+		destination->timedSeconds[stage] += source->timedSeconds[stage];
+		destination->timedIntervals[stage] += source->timedIntervals[stage];
+		destination->bytes[stage] += source->bytes[stage];
+	}
+
+	return;
+}
+
+/*
+ *	The smallest difference between two consecutive clock reads, which every
+ *	timed interval includes once.
+ */
+static double
+instrumentationClockOverheadSeconds(void)
+{
+	static double	overhead = -1;
+
+	if (overhead < 0)
+	{
+		double	previous = getMonotonicTimeInSeconds();
+
+		overhead = INFINITY;
+		for (int i = 0; i < kInstrumentationClockOverheadReads; i++)
+		{
+			double	now = getMonotonicTimeInSeconds();
+
+			if (now - previous < overhead)
+			{
+				overhead = now - previous;
+			}
+
+			previous = now;
+		}
+	}
+
+	return overhead;
+}
+
+double
+instrumentationEstimatedSeconds(const InstrumentationCounters *  counters, InstrumentationStage stage)
+{
+	double	seconds;
+
+	if (counters->timedCalls[stage] == 0)
+	{
+		return 0;
+	}
+
+	seconds = counters->timedSeconds[stage] - counters->timedIntervals[stage] * instrumentationClockOverheadSeconds();
+
+	return ((seconds > 0) ? seconds : 0) * ((double) counters->calls[stage] / (double) counters->timedCalls[stage]);
+}
+
+const char *
+instrumentationGetStageName(InstrumentationStage stage)
+{
+	return kInstrumentationStageNames[stage];
+}
+
+void
+instrumentationPrintReport(FILE *  stream, const InstrumentationCounters *  counters)
+{
+	fprintf(stream, "\nStage timings (wall-clock, summed over threads):\n");
+
+	for (int stage = 0; stage < kInstrumentationStageMax; stage++)
+	{
+		double	seconds = instrumentationEstimatedSeconds(counters, (InstrumentationStage) stage);
+
+		if (counters->calls[stage] == 0)
+		{
+			continue;
+		}
+
+		fprintf(
+			stream,
+			"\t%-24s %12" PRIu64 " calls  %12.6lf seconds  (%.1lf ns/call%s)\n",
+			kInstrumentationStageNames[stage],
+			counters->calls[stage],
+			seconds,
+			1e9 * seconds / (double) counters->calls[stage],
+			(counters->timedCalls[stage] < counters->calls[stage]) ? ", sampled" : "");
+
+		if (counters->bytes[stage] > 0)
+		{
+			fprintf(
+				stream,
+				"\t%-24s %12" PRIu64 " bytes  %12.1lf MB/s\n",
+				"",
+				counters->bytes[stage],
+				(seconds > 0) ? counters->bytes[stage] / seconds / 1e6 : 0.0);
+		}
+	}
+
+	return;
+}
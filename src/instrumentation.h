@@ -0,0 +1,245 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "timing.h"
+
+/*
+ *	Per-stage counters and timers for the hot paths. They are compiled in by
+ *	default; build with `-DkInstrumentationEnabled=0` to remove them, in which
+ *	case the inline helpers below fold to nothing.
+ */
+#ifndef kInstrumentationEnabled
+#define kInstrumentationEnabled	(1)
+#endif
+
+typedef enum
+{
+	/*
+	 *	Drawing the inputs: `setInputDistributionsViaUxHwCall()`, or the
+	 *	Philox uniforms of the Monte Carlo engine.
+	 */
+	kInstrumentationStageInputSampling	= 0,
+	/*
+	 *	The count-independent terms: `K1` and the `K2` radiance terms.
+	 */
+	kInstrumentationStageRadianceTerms,
+	/*
+	 *	The per-count conversion, dominated by the final `log`.
+	 */
+	kInstrumentationStageLogarithm,
+	/*
+	 *	Mean and variance of the output samples.
+	 */
+	kInstrumentationStageStatistics,
+	/*
+	 *	Writing `data.out` and output files.
+	 */
+	kInstrumentationStageOutput,
+	/*
+	 *	Formatting and writing the values of the JSON output.
+	 */
+	kInstrumentationStageSerialization,
+	kInstrumentationStageMax,
+} InstrumentationStage;
+
+typedef enum
+{
+	/*
+	 *	Per-iteration stages of the Monte Carlo engine take tens of nanoseconds,
+	 *	about as long as reading the clock, so only one iteration in this many
+	 *	is timed. All iterations are counted.
+	 */
+	kInstrumentationSamplingInterval	= 64,
+} InstrumentationConstant;
+
+typedef struct
+{
+	/*
+	 *	Units of work (e.g., samples) processed by each stage.
+	 */
+	uint64_t	calls[kInstrumentationStageMax];
+	/*
+	 *	Units of work whose time is included in `timedSeconds`.
+	 */
+	uint64_t	timedCalls[kInstrumentationStageMax];
+	double		timedSeconds[kInstrumentationStageMax];
+	/*
+	 *	Number of timed intervals, each of which includes one read of the clock.
+	 */
+	uint64_t	timedIntervals[kInstrumentationStageMax];
+	/*
+	 *	Bytes produced by each stage, for the stages that write output.
+	 */
+	uint64_t	bytes[kInstrumentationStageMax];
+} InstrumentationCounters;
+
+/**
+ *	@brief  Reads the clock for a stage timer. Returns zero when instrumentation is compiled out.
+ *
+ *	@return			: The monotonic time in seconds.
+ */
+static inline double
+instrumentationNow(void)
+{
+	return kInstrumentationEnabled ? getMonotonicTimeInSeconds() : 0;
+}
+
+/**
+ *	@brief  Adds units of work to a stage without timing them.
+ *
+ *	@param  counters	: Pointer to the counters to update.
+ *	@param  stage		: The stage.
+ *	@param  calls		: Units of work processed.
+ */
+static inline void
+instrumentationAddCalls(InstrumentationCounters *  counters, InstrumentationStage stage, uint64_t calls)
+{
+	if (kInstrumentationEnabled)
+	{
+		counters->calls[stage] += calls;
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Adds bytes produced by a stage.
+ *
+ *	@param  counters	: Pointer to the counters to update.
+ *	@param  stage		: The stage.
+ *	@param  bytes		: Bytes produced.
+ */
+static inline void
+instrumentationAddBytes(InstrumentationCounters *  counters, InstrumentationStage stage, uint64_t bytes)
+{
+	if (kInstrumentationEnabled)
+	{
+		counters->bytes[stage] += bytes;
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Adds a timed sample of a stage, without counting its units of work as calls.
+ *
+ *	@param  counters	: Pointer to the counters to update.
+ *	@param  stage		: The stage.
+ *	@param  timedCalls	: Units of work processed in `seconds`.
+ *	@param  seconds		: The time taken.
+ */
+static inline void
+instrumentationAddTime(InstrumentationCounters *  counters, InstrumentationStage stage, uint64_t timedCalls, double seconds)
+{
+	if (kInstrumentationEnabled)
+	{
+		counters->timedCalls[stage] += timedCalls;
+		counters->timedSeconds[stage] += seconds;
+		counters->timedIntervals[stage]++;
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Counts and times units of work of a stage that started at `start`.
+ *
+ *	@param  counters	: Pointer to the counters to update.
+ *	@param  stage		: The stage.
+ *	@param  calls		: Units of work processed since `start`.
+ *	@param  start		: The value of `instrumentationNow()` when the stage started.
+ */
+static inline void
+instrumentationStop(InstrumentationCounters *  counters, InstrumentationStage stage, uint64_t calls, double start)
+{
+	if (kInstrumentationEnabled)
+	{
+		instrumentationAddCalls(counters, stage, calls);
+		instrumentationAddTime(counters, stage, calls, instrumentationNow() - start);
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Tells whether a per-iteration stage is timed for this iteration.
+ *
+ *	@param  iteration	: Index of the iteration.
+ *
+ *	@return			: `true` for one iteration in `kInstrumentationSamplingInterval`.
+ */
+static inline bool
+instrumentationIsSampledIteration(size_t iteration)
+{
+	return kInstrumentationEnabled && (iteration % kInstrumentationSamplingInterval == 0);
+}
+
+/**
+ *	@brief  Returns the counters of the process. Only the main thread updates them; worker
+ *		threads keep their own counters, which are merged after they are joined.
+ *
+ *	@return			: Pointer to the process-wide counters.
+ */
+InstrumentationCounters *	instrumentationGetProcessCounters(void);
+
+/**
+ *	@brief  Adds `source` to `destination`.
+ *
+ *	@param  destination	: Pointer to the counters to update.
+ *	@param  source		: Pointer to the counters to add.
+ */
+void	instrumentationMerge(InstrumentationCounters *  destination, const InstrumentationCounters *  source);
+
+/**
+ *	@brief  Estimates the total time of a stage, scaling the timed samples to all of its calls
+ *		after subtracting the cost of reading the clock.
+ *
+ *	@param  counters	: Pointer to the counters.
+ *	@param  stage		: The stage.
+ *
+ *	@return			: The estimated time, in seconds.
+ */
+double	instrumentationEstimatedSeconds(const InstrumentationCounters *  counters, InstrumentationStage stage);
+
+/**
+ *	@brief  Returns a human-readable name of a stage.
+ *
+ *	@param  stage		: The stage.
+ *
+ *	@return			: The name.
+ */
+const char *	instrumentationGetStageName(InstrumentationStage stage);
+
+/**
+ *	@brief  Prints the calls, estimated time and time per call of every stage that ran, and
+ *		the throughput of the stages that count bytes.
+ *
+ *	@param  stream		: The stream to print to.
+ *	@param  counters	: Pointer to the counters.
+ */
+void	instrumentationPrintReport(FILE *  stream, const InstrumentationCounters *  counters);
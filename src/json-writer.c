@@ -0,0 +1,647 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "json-writer.h"
+
+typedef enum
+{
+	/*
+	 *	Digits that the fast path can hold exactly in a double, and the
+	 *	largest power of ten that is exact in a double.
+	 */
+	kJSONWriterMaximumFastPathDigits	= 15,
+	kJSONWriterMaximumExactPowerOfTen	= 22,
+	/*
+	 *	Decimal exponents written in fixed rather than scientific notation,
+	 *	as in JavaScript's `Number.prototype.toString()`.
+	 */
+	kJSONWriterMinimumFixedExponent		= -6,
+	kJSONWriterMaximumFixedExponent		= 20,
+} JSONWriterFormatConstant;
+
+static const double	kJSONWriterPowersOfTen[kJSONWriterMaximumExactPowerOfTen + 1] =
+			{
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+			};
+
+/*
+ *	Writes the decimal digits `digits` (the first of which is non-zero), with
+ *	the first digit in the 10^exponent place, in fixed or scientific notation.
+ */
+static size_t
+jsonWriterLayoutDigits(const char *  digits, int numberOfDigits, int exponent, bool isNegative, char *  buffer)
+{
+	size_t	length = 0;
+
+	/*
+	 *	Trailing zeros are not significant.
+	 */
+	while ((numberOfDigits > 1) && (digits[numberOfDigits - 1] == '0'))
+	{
+		numberOfDigits--;
+	}
+
+	if (isNegative)
+	{
+		buffer[length++] = '-';
+	}
+
+	if ((exponent >= 0) && (exponent <= kJSONWriterMaximumFixedExponent))
+	{
+		for (int i = 0; i <= exponent; i++)
+		{
+			buffer[length++] = (i < numberOfDigits) ? digits[i] : '0';
+		}
+
+		if (numberOfDigits > exponent + 1)
+		{
+			buffer[length++] = '.';
+			memcpy(&buffer[length], &digits[exponent + 1], numberOfDigits - exponent - 1);
+			length += numberOfDigits - exponent - 1;
+		}
+	}
+	else if ((exponent < 0) && (exponent >= kJSONWriterMinimumFixedExponent))
+	{
+		buffer[length++] = '0';
+		buffer[length++] = '.';
+
+		for (int i = -1; i > exponent; i--)
+		{
+			buffer[length++] = '0';
+		}
+
+		memcpy(&buffer[length], digits, numberOfDigits);
+		length += numberOfDigits;
+	}
+	else
+	{
+		int	exponentMagnitude = abs(exponent);
+
+		buffer[length++] = digits[0];
+
+		if (numberOfDigits > 1)
+		{
+			buffer[length++] = '.';
+			memcpy(&buffer[length], &digits[1], numberOfDigits - 1);
+			length += numberOfDigits - 1;
+		}
+
+		buffer[length++] = 'e';
+
+		if (exponent < 0)
+		{
+			buffer[length++] = '-';
+		}
+
+		if (exponentMagnitude >= 100)
+		{
+			buffer[length++] = (char) ('0' + exponentMagnitude / 100);
+		}
+
+		if (exponentMagnitude >= 10)
+		{
+			buffer[length++] = (char) ('0' + (exponentMagnitude / 10) % 10);
+		}
+
+		buffer[length++] = (char) ('0' + exponentMagnitude % 10);
+	}
+
+	return length;
+}
+
+/*
+ *	Writes the `numberOfDigits` decimal digits of the integer `digits` as for
+ *	`jsonWriterLayoutDigits()`.
+ */
+static size_t
+jsonWriterLayoutInteger(uint64_t digits, int numberOfDigits, int exponent, bool isNegative, char *  buffer)
+{
+	char	digitCharacters[kJSONWriterRoundTripDigits];
+
+	for (int i = numberOfDigits - 1; i >= 0; i--)
+	{
+		digitCharacters[i] = (char) ('0' + digits % 10);
+		digits /= 10;
+	}
+
+	return jsonWriterLayoutDigits(digitCharacters, numberOfDigits, exponent, isNegative, buffer);
+}
+
+/*
+ *	Rounds `magnitude` (positive and finite) correctly to `numberOfDigits`
+ *	significant digits with one multiplication or division by an exact power of
+ *	ten, and tells whether the result reads back as exactly `magnitude`. The read back is
+ *	exact because the digits and the power of ten are both exact doubles, so
+ *	the one operation is correctly rounded. Returns false if the power of ten
+ *	needed is not exact.
+ */
+static bool
+jsonWriterFastPathDigits(
+	double		magnitude,
+	int		numberOfDigits,
+	int		decimalExponent,
+	uint64_t *	digits,
+	int *		exponent,
+	bool *		isRoundTrip)
+{
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		int	scale = numberOfDigits - 1 - decimalExponent;
+		double	product;
+		double	scaled;
+		double	readBack;
+
+		if (abs(scale) > kJSONWriterMaximumExactPowerOfTen)
+		{
+			return false;
+		}
+
+		product = (scale >= 0) ? magnitude * kJSONWriterPowersOfTen[scale] : magnitude / kJSONWriterPowersOfTen[-scale];
+		scaled = nearbyint(product);
+
+		/*
+		 *	The product is rounded before `nearbyint()`, which only matters when it
+		 *	rounds onto a tie: its ULP is at most 1/8 below 1e15, so no other product
+		 *	can cross one. The exact residual of the operation then breaks the tie.
+		 */
+		if (fabs(product - scaled) == 0.5)
+		{
+			double	residual = (scale >= 0) ?
+						fma(magnitude, kJSONWriterPowersOfTen[scale], -product) :
+						-fma(product, kJSONWriterPowersOfTen[-scale], -magnitude);
+
+			if (residual != 0)
+			{
+				scaled = (residual > 0) ? ceil(product) : floor(product);
+			}
+		}
+
+		/*
+		 *	`log10()` can be one off next to powers of ten, and rounding can
+		 *	carry into a new digit, so the exponent is corrected once.
+		 */
+		if (scaled >= kJSONWriterPowersOfTen[numberOfDigits])
+		{
+			decimalExponent++;
+
+			continue;
+		}
+
+		if (scaled < kJSONWriterPowersOfTen[numberOfDigits - 1])
+		{
+			decimalExponent--;
+
+			continue;
+		}
+
+		readBack = (scale >= 0) ? scaled / kJSONWriterPowersOfTen[scale] : scaled * kJSONWriterPowersOfTen[-scale];
+
+		*digits = (uint64_t) scaled;
+		*exponent = decimalExponent;
+		*isRoundTrip = (readBack == magnitude);
+
+		return true;
+	}
+
+	return false;
+}
+
+#if defined(__SIZEOF_INT128__)
+static const unsigned __int128	kJSONWriterIntegerPowersOfTen[kJSONWriterMaximumExactPowerOfTen + 1] =
+				{
+					1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+					100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+					10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+					100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+					(unsigned __int128) 10000000000000000000ULL * 10,
+					(unsigned __int128) 10000000000000000000ULL * 100,
+					(unsigned __int128) 10000000000000000000ULL * 1000,
+				};
+
+/*
+ *	Rounds `magnitude` to `numberOfDigits` significant digits exactly, in
+ *	128-bit integer arithmetic, for the 16 and 17 digits that the fast path
+ *	cannot hold. With `magnitude` = m * 2^-shift, the digits D of scale s read
+ *	back as `magnitude` if D * 10^-s is closer to it than half a unit in the
+ *	last place, i.e., if 2 * |D * 2^shift - m * 10^s| < 10^s. Returns false
+ *	outside [1e-6, 2^53), and for powers of two, whose gap to the next smaller
+ *	double is half as wide.
+ */
+static bool
+jsonWriterExactDigits(
+	double		magnitude,
+	int		numberOfDigits,
+	int		decimalExponent,
+	uint64_t *	digits,
+	int *		exponent,
+	bool *		isRoundTrip)
+{
+	uint64_t	bits;
+	uint64_t	mantissa;
+	int		shift;
+
+	memcpy(&bits, &magnitude, sizeof(bits));
+
+	mantissa = (bits & ((1ULL << 52) - 1)) | (1ULL << 52);
+	shift = 1075 - (int) (bits >> 52);
+
+	if ((mantissa == (1ULL << 52)) || (shift < 1) || (shift > 69))
+	{
+		return false;
+	}
+
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		int			scale = numberOfDigits - 1 - decimalExponent;
+		unsigned __int128	scaled;
+		unsigned __int128	rounded;
+		unsigned __int128	readBack;
+
+		if ((scale < 0) || (scale > kJSONWriterMaximumExactPowerOfTen))
+		{
+			return false;
+		}
+
+		scaled = (unsigned __int128) mantissa * kJSONWriterIntegerPowersOfTen[scale];
+		rounded = (scaled + ((unsigned __int128) 1 << (shift - 1))) >> shift;
+
+		if (rounded >= kJSONWriterIntegerPowersOfTen[numberOfDigits])
+		{
+			decimalExponent++;
+
+			continue;
+		}
+
+		if (rounded < kJSONWriterIntegerPowersOfTen[numberOfDigits - 1])
+		{
+			decimalExponent--;
+
+			continue;
+		}
+
+		readBack = rounded << shift;
+
+		*digits = (uint64_t) rounded;
+		*exponent = decimalExponent;
+		*isRoundTrip = (2 * ((readBack > scaled) ? readBack - scaled : scaled - readBack) < kJSONWriterIntegerPowersOfTen[scale]);
+
+		return true;
+	}
+
+	return false;
+}
+#endif
+
+/*
+ *	Formats `magnitude` with `numberOfDigits` significant digits through
+ *	`snprintf()`, for the digits and exponents that the fast path cannot handle.
+ */
+static int
+jsonWriterSlowPathDigits(double magnitude, int numberOfDigits, char *  digits, int *  exponent)
+{
+	char	text[kJSONWriterMaximumDoubleLength + 8];
+	int	length = 0;
+	char *	position;
+
+	snprintf(text, sizeof(text), "%.*e", numberOfDigits - 1, magnitude);
+
+	for (position = text; *position != 'e'; position++)
+	{
+		if ((*position >= '0') && (*position <= '9'))
+		{
+			digits[length++] = *position;
+		}
+	}
+
+	*exponent = (int) strtol(position + 1, NULL, 10);
+
+	return length;
+}
+
+/*
+ *	Tells whether `magnitude` rounded to `numberOfDigits` significant digits
+ *	reads back as exactly `magnitude`.
+ */
+static bool
+jsonWriterSlowPathIsRoundTrip(double magnitude, int numberOfDigits)
+{
+	char	text[kJSONWriterMaximumDoubleLength + 8];
+
+	snprintf(text, sizeof(text), "%.*e", numberOfDigits - 1, magnitude);
+
+	return strtod(text, NULL) == magnitude;
+}
+
+size_t
+jsonWriterFormatDouble(double value, int significantDigits, char *  buffer)
+{
+	double		magnitude = fabs(value);
+	bool		isShortest = (significantDigits <= kJSONWriterShortestRoundTrip) || (significantDigits >= kJSONWriterRoundTripDigits);
+	int		maximumDigits = isShortest ? kJSONWriterRoundTripDigits : significantDigits;
+	int		fastPathDigits = (maximumDigits < kJSONWriterMaximumFastPathDigits) ? maximumDigits : kJSONWriterMaximumFastPathDigits;
+	int		decimalExponent;
+	int		numberOfDigits;
+	char		digitCharacters[kJSONWriterRoundTripDigits + 8];
+	uint64_t	digits;
+	int		exponent;
+	bool		isRoundTrip;
+	bool		isFastPathAvailable;
+
+	if (!isfinite(value))
+	{
+		memcpy(buffer, "null", 4);
+
+		return 4;
+	}
+
+	if (magnitude == 0)
+	{
+		return jsonWriterLayoutDigits("0", 1, 0, signbit(value), buffer);
+	}
+
+	decimalExponent = (int) floor(log10(magnitude));
+
+	isFastPathAvailable = jsonWriterFastPathDigits(magnitude, fastPathDigits, decimalExponent, &digits, &exponent, &isRoundTrip);
+
+	if (isFastPathAvailable && (isRoundTrip || (maximumDigits <= kJSONWriterMaximumFastPathDigits)))
+	{
+		/*
+		 *	If `fastPathDigits` digits read back exactly, so do the digits of
+		 *	every longer rounding, so the shortest is found by bisection.
+		 */
+		if (isShortest)
+		{
+			int		low = 1;
+			int		high = fastPathDigits;
+			uint64_t	highDigits = digits;
+			int		highExponent = exponent;
+
+			while (low < high)
+			{
+				int		middle = (low + high) / 2;
+				uint64_t	middleDigits;
+				int		middleExponent;
+				bool		isMiddleRoundTrip;
+
+				if (jsonWriterFastPathDigits(magnitude, middle, exponent, &middleDigits, &middleExponent, &isMiddleRoundTrip) && isMiddleRoundTrip)
+				{
+					high = middle;
+					highDigits = middleDigits;
+					highExponent = middleExponent;
+				}
+				else
+				{
+					low = middle + 1;
+				}
+			}
+
+			fastPathDigits = high;
+			digits = highDigits;
+			exponent = highExponent;
+		}
+
+		return jsonWriterLayoutInteger(digits, fastPathDigits, exponent, signbit(value), buffer);
+	}
+
+#if defined(__SIZEOF_INT128__)
+	if (isFastPathAvailable)
+	{
+		for (int numberOfExactDigits = isShortest ? kJSONWriterMaximumFastPathDigits + 1 : maximumDigits; numberOfExactDigits <= maximumDigits; numberOfExactDigits++)
+		{
+			if (!jsonWriterExactDigits(magnitude, numberOfExactDigits, decimalExponent, &digits, &exponent, &isRoundTrip))
+			{
+				break;
+			}
+
+			if (isRoundTrip || (numberOfExactDigits == maximumDigits))
+			{
+				return jsonWriterLayoutInteger(digits, numberOfExactDigits, exponent, signbit(value), buffer);
+			}
+		}
+	}
+#endif
+
+	/*
+	 *	Seventeen digits are enough for every double. When the fast path ran,
+	 *	fifteen were not enough.
+	 */
+	if (isShortest)
+	{
+		int	low = isFastPathAvailable ? kJSONWriterMaximumFastPathDigits + 1 : 1;
+		int	high = kJSONWriterRoundTripDigits;
+
+		while (low < high)
+		{
+			int	middle = (low + high) / 2;
+
+			if (jsonWriterSlowPathIsRoundTrip(magnitude, middle))
+			{
+				high = middle;
+			}
+			else
+			{
+				low = middle + 1;
+			}
+		}
+
+		maximumDigits = high;
+	}
+
+	numberOfDigits = jsonWriterSlowPathDigits(magnitude, maximumDigits, digitCharacters, &exponent);
+
+	return jsonWriterLayoutDigits(digitCharacters, numberOfDigits, exponent, signbit(value), buffer);
+}
+
+void
+jsonWriterFlush(JSONWriter *  writer)
+{
+	if ((writer->bufferUsed > 0) && !writer->isWriteFailed)
+	{
+		writer->isWriteFailed = (fwrite(writer->buffer, 1, writer->bufferUsed, writer->stream) != writer->bufferUsed);
+		writer->bytesWritten += writer->bufferUsed;
+	}
+
+	writer->bufferUsed = 0;
+
+	return;
+}
+
+/*
+ *	Makes room for `length` more bytes in the buffer.
+ */
+static inline char *
+jsonWriterReserve(JSONWriter *  writer, size_t length)
+{
+	if (writer->bufferUsed + length > kJSONWriterBufferSize)
+	{
+		jsonWriterFlush(writer);
+	}
+
+	return &writer->buffer[writer->bufferUsed];
+}
+
+static void
+jsonWriterAppendText(JSONWriter *  writer, const char *  text)
+{
+	for (size_t length = strlen(text); length > 0; )
+	{
+		size_t	chunkLength = (length < kJSONWriterBufferSize) ? length : kJSONWriterBufferSize;
+
+		memcpy(jsonWriterReserve(writer, chunkLength), text, chunkLength);
+		writer->bufferUsed += chunkLength;
+		text += chunkLength;
+		length -= chunkLength;
+	}
+
+	return;
+}
+
+/*
+ *	Appends `text` as a quoted JSON string, escaping quotes, backslashes and
+ *	control characters.
+ */
+static void
+jsonWriterAppendString(JSONWriter *  writer, const char *  text)
+{
+	jsonWriterAppendText(writer, "\"");
+
+	for (const unsigned char *  character = (const unsigned char *) text; *character != '\0'; character++)
+	{
+		char *	buffer = jsonWriterReserve(writer, 6);
+
+		if ((*character == '"') || (*character == '\\'))
+		{
+			buffer[0] = '\\';
+			buffer[1] = (char) *character;
+			writer->bufferUsed += 2;
+		}
+		else if (*character < 0x20)
+		{
+			writer->bufferUsed += (size_t) snprintf(buffer, 7, "\\u%04x", *character);
+		}
+		else
+		{
+			buffer[0] = (char) *character;
+			writer->bufferUsed++;
+		}
+	}
+
+	jsonWriterAppendText(writer, "\"");
+
+	return;
+}
+
+void
+jsonWriterBeginDocument(JSONWriter *  writer, FILE *  stream, const char *  title)
+{
+	*writer = (JSONWriter)
+	{
+		.stream = stream,
+		.buffer = (char *) checkedMalloc(kJSONWriterBufferSize, __FILE__, __LINE__),
+	};
+
+	jsonWriterAppendText(writer, "{\n\t\"description\": ");
+	jsonWriterAppendString(writer, title);
+	jsonWriterAppendText(writer, ",\n\t\"results\": [\n");
+
+	return;
+}
+
+void
+jsonWriterAppendVariable(
+	JSONWriter *		writer,
+	const JSONVariable *	variable,
+	size_t			maximumValues,
+	int			significantDigits)
+{
+	size_t	numberOfValues = ((maximumValues > 0) && (maximumValues < variable->size)) ? maximumValues : variable->size;
+	/*
+	 *	Value `i` of a downsampled variable is `variable->values[i * size / numberOfValues]`.
+	 */
+	size_t	stride = variable->size / ((numberOfValues > 0) ? numberOfValues : 1);
+	size_t	strideRemainder = variable->size % ((numberOfValues > 0) ? numberOfValues : 1);
+	size_t	index = 0;
+	size_t	remainder = 0;
+
+	jsonWriterAppendText(writer, (writer->numberOfVariablesWritten > 0) ? ",\n\t\t{\n\t\t\t\"variableID\": " : "\t\t{\n\t\t\t\"variableID\": ");
+	jsonWriterAppendString(writer, variable->variableSymbol);
+	jsonWriterAppendText(writer, ",\n\t\t\t\"variableDescription\": ");
+	jsonWriterAppendString(writer, variable->variableDescription);
+	jsonWriterAppendText(writer, ",\n\t\t\t\"values\": [");
+
+	for (size_t i = 0; i < numberOfValues; i++)
+	{
+		char *	buffer = jsonWriterReserve(writer, kJSONWriterMaximumDoubleLength + 2);
+
+		if (i > 0)
+		{
+			*buffer++ = ',';
+			*buffer++ = ' ';
+			writer->bufferUsed += 2;
+		}
+
+		writer->bufferUsed += jsonWriterFormatDouble(variable->values.asDouble[index], significantDigits, buffer);
+
+		index += stride;
+		remainder += strideRemainder;
+		if (remainder >= numberOfValues)
+		{
+			index++;
+			remainder -= numberOfValues;
+		}
+	}
+
+	jsonWriterAppendText(writer, "]\n\t\t}");
+
+	writer->valuesWritten += numberOfValues;
+	writer->numberOfVariablesWritten++;
+
+	return;
+}
+
+CommonConstantReturnType
+jsonWriterFinish(JSONWriter *  writer)
+{
+	jsonWriterAppendText(writer, "\n\t]\n}\n");
+	jsonWriterFlush(writer);
+
+	free(writer->buffer);
+	writer->buffer = NULL;
+
+	if (writer->isWriteFailed || (fflush(writer->stream) != 0))
+	{
+		fprintf(stderr, "Error: Could not write the JSON output.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,124 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+
+/*
+ *	A buffered JSON writer for large arrays of native (Monte Carlo) doubles. Values
+ *	are formatted straight into a chunk buffer, which is written to the stream
+ *	with one `fwrite()` whenever it fills up. It writes the same document as
+ *	`printJSONVariables()`: a "description" and a "results" array of objects with
+ *	a "variableID", a "variableDescription" and a "values" array.
+ */
+typedef enum
+{
+	kJSONWriterBufferSize			= 1 << 16,
+	/*
+	 *	Longest formatted double, e.g., "-2.2250738585072014e-308".
+	 */
+	kJSONWriterMaximumDoubleLength		= 32,
+	/*
+	 *	Significant digits that always round-trip a double.
+	 */
+	kJSONWriterRoundTripDigits		= 17,
+	/*
+	 *	`jsonWriterFormatDouble()` significant digits for the shortest
+	 *	representation that reads back as the same double.
+	 */
+	kJSONWriterShortestRoundTrip		= 0,
+} JSONWriterConstant;
+
+typedef struct
+{
+	FILE *		stream;
+	char *		buffer;
+	size_t		bufferUsed;
+	/*
+	 *	Bytes handed to the stream so far, and the values formatted.
+	 */
+	uint64_t	bytesWritten;
+	uint64_t	valuesWritten;
+	bool		isWriteFailed;
+	size_t		numberOfVariablesWritten;
+} JSONWriter;
+
+/**
+ *	@brief  Formats a double as a JSON number. Non-finite values, which JSON cannot
+ *		represent, are formatted as `null`.
+ *
+ *	@param  value			: The value to format.
+ *	@param  significantDigits	: Maximum number of significant digits, from 1 to 17, or
+ *					  `kJSONWriterShortestRoundTrip` for the fewest digits
+ *					  that read back as exactly `value`.
+ *	@param  buffer			: Output buffer of at least `kJSONWriterMaximumDoubleLength` bytes.
+ *					  The result is not NUL-terminated.
+ *
+ *	@return				: The number of characters written to `buffer`.
+ */
+size_t	jsonWriterFormatDouble(double value, int significantDigits, char *  buffer);
+
+/**
+ *	@brief  Starts a JSON document on a stream.
+ *
+ *	@param  writer		: Pointer to the writer to initialize. Finish it with `jsonWriterFinish()`.
+ *	@param  stream		: The stream to write to.
+ *	@param  title		: The document's "description".
+ */
+void	jsonWriterBeginDocument(JSONWriter *  writer, FILE *  stream, const char *  title);
+
+/**
+ *	@brief  Appends a variable to the "results" of the document.
+ *
+ *	@param  writer			: Pointer to the writer.
+ *	@param  variable		: The variable. Only `kJSONVariableTypeDouble` values are supported.
+ *	@param  maximumValues		: If non-zero and smaller than `variable->size`, only this many
+ *					  evenly spaced values are written.
+ *	@param  significantDigits	: As for `jsonWriterFormatDouble()`.
+ */
+void	jsonWriterAppendVariable(
+		JSONWriter *		writer,
+		const JSONVariable *	variable,
+		size_t			maximumValues,
+		int			significantDigits);
+
+/**
+ *	@brief  Writes out the buffered part of the document.
+ *
+ *	@param  writer		: Pointer to the writer.
+ */
+void	jsonWriterFlush(JSONWriter *  writer);
+
+/**
+ *	@brief  Closes the document, writes it out and frees the writer's buffer.
+ *
+ *	@param  writer		: Pointer to the writer.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if the whole document was written,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	jsonWriterFinish(JSONWriter *  writer);
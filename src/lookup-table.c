@@ -0,0 +1,159 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration.h"
+#include "conversion.h"
+#include "lookup-table.h"
+#include "timing.h"
+
+CommonConstantReturnType
+countsLookupTableBuild(CountsLookupTable *  table, const CalibrationContext *  context)
+{
+	uint16_t *	allCounts;
+	double		start;
+
+	start = getMonotonicTimeInSeconds();
+
+	table->temperatures = (double *) checkedMalloc(kCountsLookupTableEntries * sizeof(double), __FILE__, __LINE__);
+	allCounts = (uint16_t *) checkedMalloc(kCountsLookupTableEntries * sizeof(uint16_t), __FILE__, __LINE__);
+
+	for (size_t i = 0; i < kCountsLookupTableEntries; i++)
+	{
+		allCounts[i] = (uint16_t) i;
+	}
+
+	/*
+	 *	Fill the table with the frame kernel itself, treating all counts as a
+	 *	single-row frame, so that table lookups match frame conversion exactly.
+	 */
+	if (convertRawCountsFrameToTemperature(
+		context,
+		allCounts,
+		kCountsLookupTableEntries,
+		1,
+		kCountsLookupTableEntries,
+		table->temperatures) != kCommonConstantReturnTypeSuccess)
+	{
+		free(allCounts);
+		countsLookupTableFree(table);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	free(allCounts);
+
+	table->buildTimeSeconds = getMonotonicTimeInSeconds() - start;
+	table->memoryFootprintBytes = kCountsLookupTableEntries * sizeof(double);
+
+	/*
+	 *	Accuracy check against the direct formula. This is not part of the
+	 *	build time reported above.
+	 */
+	table->maximumAbsoluteDeviation = 0;
+	table->numberOfUndefinedEntries = 0;
+
+	for (size_t i = 0; i < kCountsLookupTableEntries; i++)
+	{
+		double	direct = calibrationContextConvertCounts(context, (double) i);
+		double	deviation;
+
+		if (isnan(direct) || isnan(table->temperatures[i]))
+		{
+			table->numberOfUndefinedEntries++;
+
+			continue;
+		}
+
+		deviation = fabs(table->temperatures[i] - direct);
+		if (deviation > table->maximumAbsoluteDeviation)
+		{
+			table->maximumAbsoluteDeviation = deviation;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+countsLookupTableFree(CountsLookupTable *  table)
+{
+	free(table->temperatures);
+	table->temperatures = NULL;
+
+	return;
+}
+
+CommonConstantReturnType
+convertRawCountsFrameToTemperatureViaLookupTable(
+	const CountsLookupTable *	table,
+	const uint16_t *		rawCounts,
+	size_t				width,
+	size_t				height,
+	size_t				strideInPixels,
+	double *			temperatures)
+{
+	if ((table == NULL) || (table->temperatures == NULL) || (rawCounts == NULL) || (temperatures == NULL))
+	{
+		fprintf(stderr, "Error: Lookup table frame conversion called with a NULL table or frame pointer.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (strideInPixels < width)
+	{
+		fprintf(stderr, "Error: Frame stride (%zu pixels) is smaller than the frame width (%zu pixels).\n", strideInPixels, width);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t row = 0; row < height; row++)
+	{
+		const uint16_t *	rawCountsRow = &rawCounts[row * strideInPixels];
+		double *		temperaturesRow = &temperatures[row * width];
+
+		for (size_t column = 0; column < width; column++)
+		{
+			temperaturesRow[column] = table->temperatures[rawCountsRow[column]];
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+countsLookupTablePrintReport(const CountsLookupTable *  table)
+{
+	printf("\nCounts lookup table:\n");
+	printf("\tEntries: %d\n", kCountsLookupTableEntries);
+	printf("\tMemory footprint: %zu bytes\n", table->memoryFootprintBytes);
+	printf("\tBuild time: %lf seconds\n", table->buildTimeSeconds);
+	printf("\tMaximum absolute deviation from direct formula: %.3e\n", table->maximumAbsoluteDeviation);
+	printf("\tCounts outside the valid range of the calibration: %zu\n", table->numberOfUndefinedEntries);
+
+	return;
+}
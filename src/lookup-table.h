@@ -0,0 +1,102 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration.h"
+
+typedef enum
+{
+	/*
+	 *	The Ax5 ADC output is 16-bit, so this covers every possible count.
+	 */
+	kCountsLookupTableEntries	= 65536,
+} CountsLookupTableConstant;
+
+typedef struct
+{
+	double *	temperatures;
+	/*
+	 *	Largest absolute difference between a table entry and the direct
+	 *	formula of `calibrationContextConvertCounts()`, over entries where
+	 *	the formula is defined.
+	 */
+	double		maximumAbsoluteDeviation;
+	/*
+	 *	Number of counts for which the formula is undefined (NaN), i.e.,
+	 *	counts below the valid radiometric range of the calibration.
+	 */
+	size_t		numberOfUndefinedEntries;
+	double		buildTimeSeconds;
+	size_t		memoryFootprintBytes;
+} CountsLookupTable;
+
+/**
+ *	@brief  Builds the table of temperatures for every possible 16-bit count from a calibration
+ *		context, and measures its deviation from the direct formula.
+ *
+ *	@param  table		: Pointer to the table to build. Free with `countsLookupTableFree()`.
+ *	@param  context		: Pointer to a built calibration context.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	countsLookupTableBuild(CountsLookupTable *  table, const CalibrationContext *  context);
+
+/**
+ *	@brief  Frees the memory held by a table built with `countsLookupTableBuild()`.
+ *
+ *	@param  table		: Pointer to the table.
+ */
+void	countsLookupTableFree(CountsLookupTable *  table);
+
+/**
+ *	@brief  Converts a frame of raw counts to temperatures by gathering from the table.
+ *		Arguments are as for `convertRawCountsFrameToTemperature()`.
+ *
+ *	@param  table			: Pointer to a built lookup table.
+ *	@param  rawCounts		: Pointer to the first pixel of the frame of raw 16-bit counts.
+ *	@param  width			: Number of pixels per row.
+ *	@param  height			: Number of rows.
+ *	@param  strideInPixels		: Distance, in pixels, between the starts of consecutive rows of `rawCounts`.
+ *	@param  temperatures		: Output array of `width * height` values, written densely row by row.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	convertRawCountsFrameToTemperatureViaLookupTable(
+					const CountsLookupTable *	table,
+					const uint16_t *		rawCounts,
+					size_t				width,
+					size_t				height,
+					size_t				strideInPixels,
+					double *			temperatures);
+
+/**
+ *	@brief  Prints the build time, memory footprint and accuracy of a lookup table.
+ *
+ *	@param  table		: Pointer to a built lookup table.
+ */
+void	countsLookupTablePrintReport(const CountsLookupTable *  table);
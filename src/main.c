@@ -30,6 +30,23 @@
 #include <inttypes.h>
 #include <uxhw.h>
 #include "utilities.h"
+#include "calibration.h"
+#include "calibration-profile.h"
+#include "material-map.h"
+#include "lookup-table.h"
+#include "monte-carlo.h"
+#include "conversion.h"
+#include "raw-frames.h"
+#include "frame-pipeline.h"
+#include "delta-method.h"
+#include "incremental-conversion.h"
+#include "region-statistics.h"
+#include "alarm-thresholds.h"
+#include "conversion-server.h"
+#include "timing.h"
+#include "instrumentation.h"
+#include "sample-file.h"
+#include "exceedance.h"
 
 /**
  *	@brief  Sets the Input Distributions via call to UxHw Parametric function.
@@ -51,112 +68,1619 @@ setInputDistributionsViaUxHwCall(double *  inputDistributions)
  *	@brief  Sensor calibration routine.
  *
  *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  calibrationContext	: Pointer to the calibration context holding the count-independent terms.
  *	@param  inputDistributions	: The array of input distributions used in the calculation.
  * 	@param  outputDistributions	: An array of of output distributions. Writes the result to `outputDistributions[outputSelectValue]`.
  *
  *	@return	double			: Returns the distributional value calculated.
  */
 static double
-calculateSensorOutput(CommandLineArguments *  arguments, double *  inputDistributions, double *  outputDistributions)
+calculateSensorOutput(
+	CommandLineArguments *		arguments,
+	const CalibrationContext *	calibrationContext,
+	double *			inputDistributions,
+	double *			outputDistributions)
 {
-	/*
-	 *	These parameter names purposefully mimic the names used in the
-	 *	reference example by FLIR. As a result, the parameter names do
-	 *	not follow our usual coding convention.
-	 */
-	double	K1;
-	double	K2;
-	double	r1;
-	double	r2;
-	double	r3;
-	double	signal;
 	double	calibratedValue;
 	double	counts;
 
-	if (isnan(arguments->countValueReadFromArgvToOverrideDefaultDistribution))
+	if (isnan(arguments->countValueReadFromArgvToOverrideDefaultDistribution))
+	{
+		counts = inputDistributions[kInputDistributionIndexSensorCounts];
+	}
+	else
+	{
+		counts = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
+	}
+
+	calibratedValue = calibrationContextConvertCounts(calibrationContext, counts);
+
+	outputDistributions[kOutputDistributionIndexCalibratedSensorOutput] = calibratedValue;
+
+	return	calibratedValue;
+}
+
+/**
+ *	@brief  Deterministic sensor calibration routine through the counts lookup table.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  countsLookupTable	: Pointer to the table to build. The caller frees it.
+ * 	@param  outputDistributions	: An array of of output distributions. Writes the result to `outputDistributions[outputSelectValue]`.
+ *
+ *	@return	double			: Returns the value calculated, or NAN if the table could not be built.
+ */
+static double
+calculateSensorOutputViaLookupTable(
+	CommandLineArguments *	arguments,
+	CountsLookupTable *	countsLookupTable,
+	double *		outputDistributions)
+{
+	double	calibratedValue;
+
+	if (countsLookupTableBuild(countsLookupTable, &arguments->calibrationProfile->nominalContext) != kCommonConstantReturnTypeSuccess)
+	{
+		return NAN;
+	}
+
+	calibratedValue = countsLookupTable->temperatures[(uint16_t) arguments->countValueReadFromArgvToOverrideDefaultDistribution];
+
+	outputDistributions[kOutputDistributionIndexCalibratedSensorOutput] = calibratedValue;
+
+	return	calibratedValue;
+}
+
+/**
+ *	@brief  Names the frame conversion that `-i` and `-fs` use, for their reports.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *
+ *	@return				: The name, e.g., "AVX2 float32".
+ */
+static const char *
+getFrameConversionName(const CommandLineArguments *  arguments)
+{
+	static char	name[32];
+
+	if (arguments->isLookupTableMode)
+	{
+		return "the counts lookup table";
+	}
+
+	snprintf(
+		name,
+		sizeof(name),
+		"%s%s%s",
+		getVectorizedConversionKernelName(getVectorizedConversionKernel()),
+		(arguments->precision == kConversionPrecisionFloat32) ? " float32" : "",
+		(arguments->materialMapPath != NULL) ? " with materials" : "");
+
+	return name;
+}
+
+/**
+ *	@brief  Returns the calibration profile of a frame of `-i`. Each frame of a camera-tagged file
+ *		names its profile, whose nominal context was built when the profiles were loaded.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  rawFrameFile		: The raw frame file.
+ *	@param  frameIndex		: The frame.
+ *
+ *	@return				: The profile, or NULL if the frame names a profile that is not loaded.
+ */
+static const CalibrationProfile *
+getRawFrameProfile(const CommandLineArguments *  arguments, const RawFrameFile *  rawFrameFile, size_t frameIndex)
+{
+	const CalibrationProfile *	profile;
+	uint32_t			profileIndex;
+
+	if (!rawFrameFile->hasProfileIndices)
+	{
+		return arguments->calibrationProfile;
+	}
+
+	profileIndex = rawFrameFileGetProfileIndex(rawFrameFile, frameIndex);
+	profile = calibrationProfileSetGet(&arguments->calibrationProfiles, profileIndex);
+	if (profile == NULL)
+	{
+		fprintf(
+			stderr,
+			"Error: Frame %zu names calibration profile %" PRIu32 ", but only %zu profiles are loaded.\n",
+			frameIndex,
+			profileIndex,
+			arguments->calibrationProfiles.numberOfProfiles);
+	}
+
+	return profile;
+}
+
+/**
+ *	@brief  Converts rows of a frame with the kernel of `-i`: vectorized float64, float32 with `-f32`,
+ *		per-pixel materials, or the counts lookup table with `-lut`. With `-dm`, also propagates
+ *		the quantization of the counts to per-pixel standard deviations. The rows are consecutive
+ *		in the frame, and the frame loop passes one row, or one span of a row, at a time.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  profile			: The calibration profile of the frame.
+ *	@param  countsLookupTable	: The table of `-lut`.
+ *	@param  materialTable		: The material table built for `profile`, or NULL.
+ *	@param  deltaMethodContext	: The first-order context of `profile`, with `-dm`.
+ *	@param  rawCounts		: Pointer to the first count of the region.
+ *	@param  materialSlots		: Pointer to the material slot of the first pixel of the region, or NULL.
+ *	@param  width			: Number of pixels per row of the region.
+ *	@param  height			: Number of rows of the region.
+ *	@param  temperatures		: Output temperatures of the region, unless float32.
+ *	@param  temperaturesFloat32	: Output float32 temperatures of the region, with `-f32`.
+ *	@param  standardDeviations	: Output standard deviations of the region, with `-dm`.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+convertRawFrameRegion(
+	const CommandLineArguments *	arguments,
+	const CalibrationProfile *	profile,
+	const CountsLookupTable *	countsLookupTable,
+	const MaterialTable *		materialTable,
+	const DeltaMethodContext *	deltaMethodContext,
+	const uint16_t *		rawCounts,
+	const uint8_t *			materialSlots,
+	size_t				width,
+	size_t				height,
+	double *			temperatures,
+	float *				temperaturesFloat32,
+	double *			standardDeviations)
+{
+	CommonConstantReturnType	ret;
+
+	if (arguments->isLookupTableMode)
+	{
+		ret = convertRawCountsFrameToTemperatureViaLookupTable(countsLookupTable, rawCounts, width, height, width, temperatures);
+	}
+	else if (materialTable != NULL)
+	{
+		ret = convertRawCountsFrameToTemperatureWithMaterials(materialTable, rawCounts, materialSlots, width, height, width, temperatures);
+	}
+	else if (temperaturesFloat32 != NULL)
+	{
+		ret = convertRawCountsFrameToTemperatureFloat32(&profile->nominalContext, rawCounts, width, height, width, temperaturesFloat32);
+	}
+	else
+	{
+		ret = convertRawCountsFrameToTemperatureVectorized(&profile->nominalContext, rawCounts, width, height, width, temperatures);
+	}
+
+	/*
+	 *	Each count carries the variance of its quantization, 1/12.
+	 */
+	if ((ret == kCommonConstantReturnTypeSuccess) && arguments->isDeltaMethodMode)
+	{
+		ret = deltaMethodPropagateFrame(deltaMethodContext, rawCounts, width, height, width, 1.0 / 12, standardDeviations);
+	}
+
+	return ret;
+}
+
+/**
+ *	@brief  Converts every frame of a memory-mapped raw frame file with the nominal calibration,
+ *		either through the vectorized frame kernel (float64, float32 with `-f32`, or with the
+ *		per-pixel materials of `-mt` and `-mm`) or, with `-lut`, through the counts lookup table. Frames are read in place from the mapping.
+ *		Prints the mean, minimum and maximum of each frame and, with `-o`, writes the
+ *		temperature frames to a raw temperature file. With `-inc`, only the tiles whose counts
+ *		changed since the previous frame are converted, and each frame reports the fraction
+ *		of its pixels converted. With `-roi` or `-roim`, the statistics of each region of interest
+ *		accumulate row by row during the conversion, and are reported for each frame.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  variableDescription	: A string decribing the converted variable.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the converted variable.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+convertRawFrameFileInput(
+	CommandLineArguments *	arguments,
+	const char *		variableDescription,
+	const char *		unitsOfMeasurement)
+{
+	RawFrameFile			rawFrameFile;
+	const CalibrationProfile *	profile = arguments->calibrationProfile;
+	const CalibrationProfile *	deltaMethodProfile = NULL;
+	const CalibrationProfile *	materialProfile = NULL;
+	const CalibrationProfile *	incrementalProfile = NULL;
+	MaterialTable *			materialTable = NULL;
+	MaterialMap			materialMap = {0};
+	CountsLookupTable		countsLookupTable = {0};
+	CommonConstantReturnType	ret = kCommonConstantReturnTypeSuccess;
+	FILE *				outputFile = NULL;
+	double *			temperatures = NULL;
+	float *				temperaturesFloat32 = NULL;
+	double *			frameMeans;
+	double *			frameMinima;
+	double *			frameMaxima;
+	double *			standardDeviations = NULL;
+	double *			frameMeanStandardDeviations = NULL;
+	double *			frameMeanSpreads = NULL;
+	double *			pixelExceedanceProbabilities = NULL;
+	double *			frameMaximumExceedanceProbabilities = NULL;
+	double *			frameAlarmPixelCounts = NULL;
+	double *			frameConvertedFractions = NULL;
+	size_t				numberOfExceedanceThresholds = arguments->numberOfExceedanceThresholds;
+	DeltaMethodContext		deltaMethodContext;
+	MonteCarloConfiguration		monteCarloConfiguration;
+	IncrementalConversion		incrementalConversion = {0};
+	RegionStatistics		regionStatistics = {0};
+	double *			regionRowTemperatures = NULL;
+	double				overallMean = 0.0;
+	double				start;
+	double				elapsedSeconds;
+	size_t				frameCount;
+	size_t				pixelsPerFrame;
+	bool				hasUndefinedFrameStatistics = false;
+	/*
+	 *	Monte Carlo frames are per-pixel float64 statistics, whatever the precision of their conversion.
+	 */
+	bool				isFloat32Frames = (arguments->precision == kConversionPrecisionFloat32) && !arguments->common.isMonteCarloMode;
+
+	if (rawFrameFileOpen(&rawFrameFile, arguments->common.inputFilePath) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	frameCount = rawFrameFile.header.frameCount;
+	pixelsPerFrame = rawFrameFile.pixelsPerFrame;
+
+	/*
+	 *	The material contexts are built from each frame's profile, before its conversion.
+	 */
+	if (arguments->materialMapPath != NULL)
+	{
+		materialTable = (MaterialTable *) checkedMalloc(sizeof(MaterialTable), __FILE__, __LINE__);
+
+		if ((materialTableLoad(materialTable, arguments->materialTablePath) != kCommonConstantReturnTypeSuccess) ||
+			(materialMapLoad(&materialMap, arguments->materialMapPath) != kCommonConstantReturnTypeSuccess) ||
+			(materialMap.width != rawFrameFile.header.width) || (materialMap.height != rawFrameFile.header.height))
+		{
+			if (materialMap.slots != NULL)
+			{
+				fprintf(
+					stderr,
+					"Error: The material map is %" PRIu32 "x%" PRIu32 " pixels, but the frames are %" PRIu32 "x%" PRIu32 ".\n",
+					materialMap.width,
+					materialMap.height,
+					rawFrameFile.header.width,
+					rawFrameFile.header.height);
+			}
+			materialMapFree(&materialMap);
+			free(materialTable);
+			rawFrameFileClose(&rawFrameFile);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (arguments->isLookupTableMode && rawFrameFile.hasProfileIndices)
+	{
+		fprintf(stderr, "Error: The counts lookup table (-lut) holds a single calibration, so it cannot convert camera-tagged frames.\n");
+		rawFrameFileClose(&rawFrameFile);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->isLookupTableMode && (countsLookupTableBuild(&countsLookupTable, &profile->nominalContext) != kCommonConstantReturnTypeSuccess))
+	{
+		rawFrameFileClose(&rawFrameFile);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (((arguments->regionsOfInterestPath != NULL) || (arguments->regionMaskPath != NULL)) &&
+		(regionStatisticsInit(
+			&regionStatistics,
+			arguments->regionsOfInterestPath,
+			arguments->regionMaskPath,
+			rawFrameFile.header.width,
+			rawFrameFile.header.height,
+			frameCount) != kCommonConstantReturnTypeSuccess))
+	{
+		countsLookupTableFree(&countsLookupTable);
+		materialMapFree(&materialMap);
+		free(materialTable);
+		rawFrameFileClose(&rawFrameFile);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isWriteToFileEnabled)
+	{
+		/*
+		 *	Monte Carlo output files hold 2 + (number of thresholds) maps per input frame,
+		 *	which must fit the header's 32-bit frame count. The threshold count is
+		 *	bounded first, so that the 64-bit product cannot wrap around either.
+		 */
+		uint64_t	outputFrameCount = rawFrameFile.header.frameCount;
+
+		if (arguments->common.isMonteCarloMode)
+		{
+			if ((numberOfExceedanceThresholds > UINT32_MAX) ||
+				((2 + (uint64_t) numberOfExceedanceThresholds) * rawFrameFile.header.frameCount > UINT32_MAX))
+			{
+				fprintf(
+					stderr,
+					"Error: %" PRIu32 " frames with %zu exceedance threshold(s) need more output frames than a raw temperature file can hold (%" PRIu32 ").\n",
+					rawFrameFile.header.frameCount,
+					numberOfExceedanceThresholds,
+					UINT32_MAX);
+				regionStatisticsFree(&regionStatistics);
+				countsLookupTableFree(&countsLookupTable);
+				materialMapFree(&materialMap);
+				free(materialTable);
+				rawFrameFileClose(&rawFrameFile);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			outputFrameCount = (2 + (uint64_t) numberOfExceedanceThresholds) * rawFrameFile.header.frameCount;
+		}
+
+		outputFile = fopen(arguments->common.outputFilePath, "wb");
+
+		if ((outputFile == NULL) ||
+			(rawTemperatureFileWriteHeader(
+				outputFile,
+				rawFrameFile.header.width,
+				rawFrameFile.header.height,
+				(uint32_t) outputFrameCount,
+				isFloat32Frames) != kCommonConstantReturnTypeSuccess))
+		{
+			fprintf(stderr, "Error: Could not write output file \"%s\".\n", arguments->common.outputFilePath);
+
+			if (outputFile != NULL)
+			{
+				fclose(outputFile);
+			}
+			regionStatisticsFree(&regionStatistics);
+			countsLookupTableFree(&countsLookupTable);
+			materialMapFree(&materialMap);
+			free(materialTable);
+			rawFrameFileClose(&rawFrameFile);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	One frame of temperatures is reused for the whole file, so memory use
+	 *	does not grow with the length of the archive.
+	 */
+	if (isFloat32Frames)
+	{
+		temperaturesFloat32 = (float *) checkedMalloc(pixelsPerFrame * sizeof(float), __FILE__, __LINE__);
+	}
+	else
+	{
+		temperatures = (double *) checkedMalloc(pixelsPerFrame * sizeof(double), __FILE__, __LINE__);
+	}
+	frameMeans = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+	frameMinima = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+	frameMaxima = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+
+	if (arguments->common.isMonteCarloMode)
+	{
+		monteCarloConfigurationSetDefaults(&monteCarloConfiguration);
+		monteCarloConfiguration.seed = arguments->randomSeed;
+		monteCarloConfiguration.numberOfThreads = arguments->numberOfThreads;
+		monteCarloConfiguration.samplingMethod = arguments->samplingMethod;
+		monteCarloConfiguration.numberOfDesignPoints = arguments->common.numberOfMonteCarloIterations;
+		monteCarloConfiguration.precision = arguments->precision;
+		frameMeanSpreads = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+	}
+
+	/*
+	 *	One probability map per threshold, and for each frame and threshold, the largest
+	 *	probability and the number of pixels more likely than not to exceed it.
+	 */
+	if (numberOfExceedanceThresholds > 0)
+	{
+		pixelExceedanceProbabilities = (double *) checkedMalloc(numberOfExceedanceThresholds * pixelsPerFrame * sizeof(double), __FILE__, __LINE__);
+		frameMaximumExceedanceProbabilities = (double *) checkedMalloc((frameCount * numberOfExceedanceThresholds + 1) * sizeof(double), __FILE__, __LINE__);
+		frameAlarmPixelCounts = (double *) checkedMalloc((frameCount * numberOfExceedanceThresholds + 1) * sizeof(double), __FILE__, __LINE__);
+	}
+
+	if (arguments->isDeltaMethodMode || arguments->common.isMonteCarloMode)
+	{
+		standardDeviations = (double *) checkedMalloc(pixelsPerFrame * sizeof(double), __FILE__, __LINE__);
+		frameMeanStandardDeviations = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+	}
+
+	/*
+	 *	The temperatures (and standard deviations) of one frame are the starting point
+	 *	of the next, which only converts its changed tiles.
+	 */
+	if (arguments->isIncrementalMode)
+	{
+		incrementalConversionInit(&incrementalConversion, rawFrameFile.header.width, rawFrameFile.header.height, arguments->incrementalCountTolerance);
+		frameConvertedFractions = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+	}
+
+	/*
+	 *	The regions take float64 rows, so float32 rows are widened one at a time.
+	 */
+	if ((regionStatistics.numberOfRegions > 0) && isFloat32Frames)
+	{
+		regionRowTemperatures = (double *) checkedMalloc(rawFrameFile.header.width * sizeof(double), __FILE__, __LINE__);
+	}
+
+	start = getMonotonicTimeInSeconds();
+
+	for (size_t frameIndex = 0; frameIndex < frameCount; frameIndex++)
+	{
+		const uint16_t *	rawCounts = rawFrameFileGetFrame(&rawFrameFile, frameIndex);
+		size_t			width = rawFrameFile.header.width;
+		size_t			spanIndex = 0;
+		double			sum = 0.0;
+		size_t			numberOfFinitePixels = 0;
+		double			minimum = INFINITY;
+		double			maximum = -INFINITY;
+		double			standardDeviationSum = 0.0;
+
+		profile = getRawFrameProfile(arguments, &rawFrameFile, frameIndex);
+		if (profile == NULL)
+		{
+			ret = kCommonConstantReturnTypeError;
+
+			break;
+		}
+
+		if ((materialTable != NULL) && (profile != materialProfile))
+		{
+			ret = materialTableBuild(materialTable, &materialMap, &profile->nominalParameters);
+			if (ret != kCommonConstantReturnTypeSuccess)
+			{
+				break;
+			}
+			materialProfile = profile;
+		}
+
+		if (arguments->isDeltaMethodMode && (profile != deltaMethodProfile))
+		{
+			deltaMethodContextInit(&deltaMethodContext, &profile->nominalParameters, &profile->parameterHalfWidths);
+			deltaMethodProfile = profile;
+		}
+
+		if (arguments->common.isMonteCarloMode)
+		{
+			/*
+			 *	The same calibration draws apply to every pixel, and to every frame of a camera.
+			 */
+			MonteCarloFrame		frame =
+						{
+							.rawCounts = rawCounts,
+							.width = rawFrameFile.header.width,
+							.height = rawFrameFile.header.height,
+							.strideInPixels = rawFrameFile.header.width,
+						};
+			MonteCarloFrameResult	monteCarloFrameResult =
+						{
+							.pixelMeans = temperatures,
+							.pixelStandardDeviations = standardDeviations,
+							.exceedanceThresholds = arguments->exceedanceThresholds,
+							.numberOfExceedanceThresholds = numberOfExceedanceThresholds,
+							.pixelExceedanceProbabilities = pixelExceedanceProbabilities,
+						};
+
+			monteCarloConfiguration.nominalParameters = profile->nominalParameters;
+			monteCarloConfiguration.parameterHalfWidths = profile->parameterHalfWidths;
+			streamingStatisticsInit(&monteCarloFrameResult.frameMeans);
+			ret = monteCarloRunFrame(
+				&monteCarloConfiguration,
+				0,
+				arguments->common.numberOfMonteCarloIterations,
+				&frame,
+				&monteCarloFrameResult);
+			frameMeanSpreads[frameIndex] = sqrt(streamingStatisticsVariance(&monteCarloFrameResult.frameMeans));
+			streamingStatisticsFree(&monteCarloFrameResult.frameMeans);
+		}
+		else if (arguments->isIncrementalMode)
+		{
+			/*
+			 *	A calibration other than that of the current results converts the whole frame.
+			 */
+			if (profile != incrementalProfile)
+			{
+				incrementalConversionInvalidate(&incrementalConversion);
+				incrementalProfile = profile;
+			}
+
+			incrementalConversionFindChanges(&incrementalConversion, rawCounts, width);
+			frameConvertedFractions[frameIndex] = (double) incrementalConversion.numberOfChangedPixels / pixelsPerFrame;
+		}
+
+		if (ret != kCommonConstantReturnTypeSuccess)
+		{
+			break;
+		}
+
+		if (regionStatistics.numberOfRegions > 0)
+		{
+			regionStatisticsBeginFrame(&regionStatistics, standardDeviations != NULL);
+		}
+
+		/*
+		 *	Each row is converted (unless Monte Carlo converted the whole frame) and then,
+		 *	while it is still in cache, added to the statistics of the frame and of its regions.
+		 *	The incremental spans are in row order.
+		 */
+		for (size_t row = 0; row < rawFrameFile.header.height; row++)
+		{
+			size_t	offset = row * width;
+
+			if (arguments->common.isMonteCarloMode)
+			{
+				/*
+				 *	Already converted.
+				 */
+			}
+			else if (arguments->isIncrementalMode)
+			{
+				for (; (spanIndex < incrementalConversion.numberOfSpans) && (incrementalConversion.spans[spanIndex].row == row) &&
+					(ret == kCommonConstantReturnTypeSuccess); spanIndex++)
+				{
+					const IncrementalConversionSpan *	span = &incrementalConversion.spans[spanIndex];
+					size_t					spanOffset = offset + span->column;
+
+					ret = convertRawFrameRegion(
+						arguments,
+						profile,
+						&countsLookupTable,
+						materialTable,
+						&deltaMethodContext,
+						&rawCounts[spanOffset],
+						(materialTable != NULL) ? &materialMap.slots[spanOffset] : NULL,
+						span->numberOfPixels,
+						1,
+						isFloat32Frames ? NULL : &temperatures[spanOffset],
+						isFloat32Frames ? &temperaturesFloat32[spanOffset] : NULL,
+						arguments->isDeltaMethodMode ? &standardDeviations[spanOffset] : NULL);
+				}
+			}
+			else
+			{
+				ret = convertRawFrameRegion(
+					arguments,
+					profile,
+					&countsLookupTable,
+					materialTable,
+					&deltaMethodContext,
+					&rawCounts[offset],
+					(materialTable != NULL) ? &materialMap.slots[offset] : NULL,
+					width,
+					1,
+					isFloat32Frames ? NULL : &temperatures[offset],
+					isFloat32Frames ? &temperaturesFloat32[offset] : NULL,
+					arguments->isDeltaMethodMode ? &standardDeviations[offset] : NULL);
+			}
+
+			if (ret != kCommonConstantReturnTypeSuccess)
+			{
+				break;
+			}
+
+			for (size_t i = offset; i < offset + width; i++)
+			{
+				double	temperature = isFloat32Frames ? temperaturesFloat32[i] : temperatures[i];
+
+				if (!isfinite(temperature))
+				{
+					continue;
+				}
+
+				sum += temperature;
+				numberOfFinitePixels++;
+				minimum = fmin(minimum, temperature);
+				maximum = fmax(maximum, temperature);
+			}
+
+			if (standardDeviations != NULL)
+			{
+				for (size_t i = offset; i < offset + width; i++)
+				{
+					standardDeviationSum += standardDeviations[i];
+				}
+			}
+
+			if (regionStatistics.numberOfRegions > 0)
+			{
+				if (isFloat32Frames)
+				{
+					for (size_t i = 0; i < width; i++)
+					{
+						regionRowTemperatures[i] = temperaturesFloat32[offset + i];
+					}
+				}
+
+				regionStatisticsAddRow(
+					&regionStatistics,
+					row,
+					isFloat32Frames ? regionRowTemperatures : &temperatures[offset],
+					(standardDeviations != NULL) ? &standardDeviations[offset] : NULL);
+			}
+		}
+
+		if (regionStatistics.numberOfRegions > 0)
+		{
+			regionStatisticsEndFrame(&regionStatistics, frameIndex);
+		}
+
+		if (ret != kCommonConstantReturnTypeSuccess)
+		{
+			break;
+		}
+
+		if (standardDeviations != NULL)
+		{
+			frameMeanStandardDeviations[frameIndex] = standardDeviationSum / pixelsPerFrame;
+		}
+
+		for (size_t k = 0; k < numberOfExceedanceThresholds; k++)
+		{
+			const double *	probabilities = &pixelExceedanceProbabilities[k * pixelsPerFrame];
+			double		maximumProbability = 0.0;
+			size_t		alarmPixels = 0;
+
+			for (size_t i = 0; i < pixelsPerFrame; i++)
+			{
+				maximumProbability = fmax(maximumProbability, probabilities[i]);
+				alarmPixels += (probabilities[i] >= 0.5);
+			}
+
+			frameMaximumExceedanceProbabilities[frameIndex * numberOfExceedanceThresholds + k] = maximumProbability;
+			frameAlarmPixelCounts[frameIndex * numberOfExceedanceThresholds + k] = (double) alarmPixels;
+		}
+
+		/*
+		 *	The frame statistics cover the finite pixels only, since counts below the
+		 *	calibrated range (such as a dead pixel reading 0) convert to NaN. A frame
+		 *	without finite pixels has undefined statistics.
+		 */
+		if (numberOfFinitePixels > 0)
+		{
+			frameMeans[frameIndex] = sum / numberOfFinitePixels;
+			frameMinima[frameIndex] = minimum;
+			frameMaxima[frameIndex] = maximum;
+		}
+		else
+		{
+			frameMeans[frameIndex] = NAN;
+			frameMinima[frameIndex] = NAN;
+			frameMaxima[frameIndex] = NAN;
+			hasUndefinedFrameStatistics = true;
+		}
+		overallMean += frameMeans[frameIndex] / frameCount;
+
+		/*
+		 *	In Monte Carlo mode, each frame's mean temperatures are followed by its standard deviations,
+		 *	and then by one exceedance probability map per threshold.
+		 */
+		if ((outputFile != NULL) &&
+			((isFloat32Frames && (fwrite(temperaturesFloat32, sizeof(float), pixelsPerFrame, outputFile) != pixelsPerFrame)) ||
+			(!isFloat32Frames && (fwrite(temperatures, sizeof(double), pixelsPerFrame, outputFile) != pixelsPerFrame)) ||
+			(arguments->common.isMonteCarloMode && (fwrite(standardDeviations, sizeof(double), pixelsPerFrame, outputFile) != pixelsPerFrame)) ||
+			((numberOfExceedanceThresholds > 0) && fwrite(pixelExceedanceProbabilities, sizeof(double), numberOfExceedanceThresholds * pixelsPerFrame, outputFile) != numberOfExceedanceThresholds * pixelsPerFrame)))
+		{
+			fprintf(stderr, "Error: Could not write frame %zu to output file \"%s\".\n", frameIndex, arguments->common.outputFilePath);
+			ret = kCommonConstantReturnTypeError;
+
+			break;
+		}
+	}
+
+	elapsedSeconds = getMonotonicTimeInSeconds() - start;
+
+	if ((outputFile != NULL) && (fclose(outputFile) != 0))
+	{
+		fprintf(stderr, "Error: Could not close output file \"%s\".\n", arguments->common.outputFilePath);
+		ret = kCommonConstantReturnTypeError;
+	}
+
+	if (ret != kCommonConstantReturnTypeSuccess)
+	{
+		/*
+		 *	Nothing to report.
+		 */
+	}
+	else if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %" PRIu64 "\n", overallMean, (uint64_t)(elapsedSeconds*1000000));
+	}
+	else if (arguments->common.isOutputJSONMode)
+	{
+		/*
+		 *	The (at most nine) variables of the modes in use, followed by one per region of interest.
+		 */
+		JSONVariable *	variables = (JSONVariable *) checkedMalloc((9 + regionStatistics.numberOfRegions) * sizeof(JSONVariable), __FILE__, __LINE__);
+		size_t		numberOfVariables = 0;
+
+		variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameMeans", .variableDescription = "Mean of the finite pixels of each frame (null if none are)", .values = (JSONVariablePointer){ .asDouble = frameMeans }, .type = kJSONVariableTypeDouble, .size = frameCount };
+		variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameMinima", .variableDescription = "Minimum of the finite pixels of each frame (null if none are)", .values = (JSONVariablePointer){ .asDouble = frameMinima }, .type = kJSONVariableTypeDouble, .size = frameCount };
+		variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameMaxima", .variableDescription = "Maximum of the finite pixels of each frame (null if none are)", .values = (JSONVariablePointer){ .asDouble = frameMaxima }, .type = kJSONVariableTypeDouble, .size = frameCount };
+
+		if (standardDeviations != NULL)
+		{
+			variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameMeanStandardDeviations", .variableDescription = "Standard deviation, averaged over the pixels of each frame", .values = (JSONVariablePointer){ .asDouble = frameMeanStandardDeviations }, .type = kJSONVariableTypeDouble, .size = frameCount };
+		}
+
+		if (arguments->common.isMonteCarloMode)
+		{
+			variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameMeanSpreads", .variableDescription = "Monte Carlo standard deviation of the mean of each frame", .values = (JSONVariablePointer){ .asDouble = frameMeanSpreads }, .type = kJSONVariableTypeDouble, .size = frameCount };
+		}
+
+		if (numberOfExceedanceThresholds > 0)
+		{
+			variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "exceedanceThresholds", .variableDescription = "Alarm thresholds", .values = (JSONVariablePointer){ .asDouble = arguments->exceedanceThresholds }, .type = kJSONVariableTypeDouble, .size = numberOfExceedanceThresholds };
+			variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameMaximumExceedanceProbabilities", .variableDescription = "Largest pixel probability of exceeding each threshold, for each frame", .values = (JSONVariablePointer){ .asDouble = frameMaximumExceedanceProbabilities }, .type = kJSONVariableTypeDouble, .size = frameCount * numberOfExceedanceThresholds };
+			variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameAlarmPixelCounts", .variableDescription = "Number of pixels with probability of at least 0.5 of exceeding each threshold, for each frame", .values = (JSONVariablePointer){ .asDouble = frameAlarmPixelCounts }, .type = kJSONVariableTypeDouble, .size = frameCount * numberOfExceedanceThresholds };
+		}
+
+		if (arguments->isIncrementalMode)
+		{
+			variables[numberOfVariables++] = (JSONVariable){ .variableSymbol = "frameConvertedFractions", .variableDescription = "Fraction of the pixels of each frame converted by the incremental mode", .values = (JSONVariablePointer){ .asDouble = frameConvertedFractions }, .type = kJSONVariableTypeDouble, .size = frameCount };
+		}
+
+		for (size_t r = 0; r < regionStatistics.numberOfRegions; r++)
+		{
+			JSONVariable *	variable = &variables[numberOfVariables++];
+
+			*variable = (JSONVariable){ .values = (JSONVariablePointer){ .asDouble = (double *) regionStatisticsGetValues(&regionStatistics, r, 0) }, .type = kJSONVariableTypeDouble, .size = frameCount * kRegionStatisticsValueIndexMax };
+			snprintf(variable->variableSymbol, sizeof(variable->variableSymbol), "%s", regionStatistics.regions[r].name);
+			snprintf(
+				variable->variableDescription,
+				sizeof(variable->variableDescription),
+				"For each frame, the mean, minimum, maximum and standard error of the mean of the region, its %g, %g and %g quantiles, their standard errors, and its mean standard deviation (null without -dm or -M)",
+				kRegionStatisticsQuantileProbabilities[0],
+				kRegionStatisticsQuantileProbabilities[1],
+				kRegionStatisticsQuantileProbabilities[2]);
+		}
+
+		/*
+		 *	Region values can be undefined (the mean standard deviation without per-pixel
+		 *	standard deviations, or the standard errors of a one-pixel region), as can the
+		 *	statistics of a frame without finite pixels, which only the JSON writer turns
+		 *	into `null`.
+		 */
+		if ((regionStatistics.numberOfRegions > 0) || hasUndefinedFrameStatistics)
+		{
+			printJSONVariablesWithNulls(variables, numberOfVariables, "Lepton FLIR Sensor Calibration");
+		}
+		else
+		{
+			printJSONVariables(variables, numberOfVariables, "Lepton FLIR Sensor Calibration");
+		}
+		free(variables);
+	}
+	else
+	{
+		printf(
+			"%s: %.2lf %s (mean of %zu frames of %" PRIu32 "x%" PRIu32 " pixels, via %s).\n",
+			variableDescription,
+			overallMean,
+			unitsOfMeasurement,
+			frameCount,
+			rawFrameFile.header.width,
+			rawFrameFile.header.height,
+			getFrameConversionName(arguments));
+		printf("\n");
+
+		for (size_t frameIndex = 0; frameIndex < frameCount; frameIndex++)
+		{
+			/*
+			 *	Frames of camera-tagged files are labelled with the name of their profile.
+			 */
+			if (rawFrameFile.hasProfileIndices)
+			{
+				printf(
+					"\tFrame %zu (%s):",
+					frameIndex,
+					calibrationProfileSetGet(&arguments->calibrationProfiles, rawFrameFileGetProfileIndex(&rawFrameFile, frameIndex))->name);
+			}
+			else
+			{
+				printf("\tFrame %zu:", frameIndex);
+			}
+
+			printf(
+				" mean %.2lf, minimum %.2lf, maximum %.2lf %s\n",
+				frameMeans[frameIndex],
+				frameMinima[frameIndex],
+				frameMaxima[frameIndex],
+				unitsOfMeasurement);
+
+			if (arguments->isIncrementalMode)
+			{
+				printf("\t\tConverted %.2lf%% of the pixels\n", 100 * frameConvertedFractions[frameIndex]);
+			}
+
+			if (arguments->isDeltaMethodMode)
+			{
+				printf("\t\tMean first-order standard deviation: %.4lf %s\n", frameMeanStandardDeviations[frameIndex], unitsOfMeasurement);
+			}
+			else if (arguments->common.isMonteCarloMode)
+			{
+				printf(
+					"\t\tMean Monte Carlo standard deviation: %.4lf %s, standard deviation of the frame mean: %.4lf %s\n",
+					frameMeanStandardDeviations[frameIndex],
+					unitsOfMeasurement,
+					frameMeanSpreads[frameIndex],
+					unitsOfMeasurement);
+			}
+
+			for (size_t k = 0; k < numberOfExceedanceThresholds; k++)
+			{
+				printf(
+					"\t\tAbove %.2lf %s: largest pixel probability %.6lf, %.0lf pixels with probability of at least 0.5\n",
+					arguments->exceedanceThresholds[k],
+					unitsOfMeasurement,
+					frameMaximumExceedanceProbabilities[frameIndex * numberOfExceedanceThresholds + k],
+					frameAlarmPixelCounts[frameIndex * numberOfExceedanceThresholds + k]);
+			}
+
+			for (size_t r = 0; r < regionStatistics.numberOfRegions; r++)
+			{
+				const double *	values = regionStatisticsGetValues(&regionStatistics, r, frameIndex);
+
+				printf(
+					"\t\tRegion %s: mean %.2lf (standard error %.4lf), minimum %.2lf, maximum %.2lf, median %.2lf (standard error %.4lf) %s\n",
+					regionStatistics.regions[r].name,
+					values[kRegionStatisticsValueIndexMean],
+					values[kRegionStatisticsValueIndexMeanStandardError],
+					values[kRegionStatisticsValueIndexMinimum],
+					values[kRegionStatisticsValueIndexMaximum],
+					values[kRegionStatisticsValueIndexQuantiles + 1],
+					values[kRegionStatisticsValueIndexQuantileStandardErrors + 1],
+					unitsOfMeasurement);
+			}
+		}
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf(
+				"\nWall-clock time used: %lf seconds (%.1lf Mpixels/s)\n",
+				elapsedSeconds,
+				(elapsedSeconds > 0) ? (frameCount * pixelsPerFrame) / elapsedSeconds / 1e6 : 0.0);
+		}
+	}
+
+	free(regionRowTemperatures);
+	regionStatisticsFree(&regionStatistics);
+	free(frameConvertedFractions);
+	free(frameAlarmPixelCounts);
+	free(frameMaximumExceedanceProbabilities);
+	free(pixelExceedanceProbabilities);
+	free(frameMeanSpreads);
+	free(frameMeanStandardDeviations);
+	free(standardDeviations);
+	free(frameMaxima);
+	free(frameMinima);
+	free(frameMeans);
+	free(temperatures);
+	free(temperaturesFloat32);
+	incrementalConversionFree(&incrementalConversion);
+	materialMapFree(&materialMap);
+	free(materialTable);
+	countsLookupTableFree(&countsLookupTable);
+	rawFrameFileClose(&rawFrameFile);
+
+	return ret;
+}
+
+/**
+ *	@brief  Checks every frame of a memory-mapped raw frame file against the `-at` alarm thresholds
+ *		without converting it: each threshold, and the edges of its uncertainty band, are
+ *		mapped to the first raw count above them, and the pixels above each are counted with
+ *		integer comparisons. Only the pixels above the lowest threshold are converted, for the
+ *		mean and maximum of each frame's flagged pixels and, with `-o`, for temperature frames
+ *		that are NAN at every other pixel.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  variableDescription	: A string decribing the converted variable.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the converted variable.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runFrameAlarms(
+	CommandLineArguments *	arguments,
+	const char *		variableDescription,
+	const char *		unitsOfMeasurement)
+{
+	RawFrameFile			rawFrameFile;
+	const CalibrationProfile *	profile = arguments->calibrationProfile;
+	const CalibrationProfile *	thresholdProfile = NULL;
+	DeltaMethodContext		deltaMethodContext;
+	AlarmThreshold			thresholds[kAlarmThresholdsMaximum];
+	AlarmThreshold			reportedThresholds[kAlarmThresholdsMaximum];
+	size_t				numberOfThresholds = arguments->numberOfAlarmThresholds;
+	uint32_t			lowestFirstCount = 0;
+	CommonConstantReturnType	ret = kCommonConstantReturnTypeSuccess;
+	FILE *				outputFile = NULL;
+	double *			temperatures = NULL;
+	double *			alarmThresholdCounts;
+	double *			frameBandPixelCounts[kAlarmThresholdBandMax];
+	double *			frameFlaggedPixelCounts;
+	double *			frameFlaggedMeans;
+	double *			frameFlaggedMaxima;
+	double				overallFlaggedFraction = 0.0;
+	double				start;
+	double				elapsedSeconds;
+	size_t				frameCount;
+	size_t				pixelsPerFrame;
+
+	if (rawFrameFileOpen(&rawFrameFile, arguments->common.inputFilePath) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	frameCount = rawFrameFile.header.frameCount;
+	pixelsPerFrame = rawFrameFile.pixelsPerFrame;
+
+	if (arguments->common.isWriteToFileEnabled)
+	{
+		outputFile = fopen(arguments->common.outputFilePath, "wb");
+
+		if ((outputFile == NULL) ||
+			(rawTemperatureFileWriteHeader(outputFile, rawFrameFile.header.width, rawFrameFile.header.height, frameCount, false) != kCommonConstantReturnTypeSuccess))
+		{
+			fprintf(stderr, "Error: Could not write output file \"%s\".\n", arguments->common.outputFilePath);
+
+			if (outputFile != NULL)
+			{
+				fclose(outputFile);
+			}
+			rawFrameFileClose(&rawFrameFile);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		temperatures = (double *) checkedMalloc(pixelsPerFrame * sizeof(double), __FILE__, __LINE__);
+	}
+
+	/*
+	 *	The thresholds of the `-cn` profile, and for each frame, the pixels above
+	 *	each band edge of each threshold, and the mean and maximum of the pixels converted.
+	 */
+	alarmThresholdCounts = (double *) checkedMalloc(numberOfThresholds * kAlarmThresholdBandMax * sizeof(double), __FILE__, __LINE__);
+	for (size_t band = 0; band < kAlarmThresholdBandMax; band++)
+	{
+		frameBandPixelCounts[band] = (double *) checkedMalloc((frameCount * numberOfThresholds + 1) * sizeof(double), __FILE__, __LINE__);
+	}
+	frameFlaggedPixelCounts = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+	frameFlaggedMeans = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+	frameFlaggedMaxima = (double *) checkedMalloc((frameCount + 1) * sizeof(double), __FILE__, __LINE__);
+
+	deltaMethodContextInit(&deltaMethodContext, &profile->nominalParameters, &profile->parameterHalfWidths);
+	for (size_t k = 0; k < numberOfThresholds; k++)
+	{
+		alarmThresholdBuild(&reportedThresholds[k], &deltaMethodContext, arguments->alarmThresholds[k]);
+		for (size_t band = 0; band < kAlarmThresholdBandMax; band++)
+		{
+			alarmThresholdCounts[k * kAlarmThresholdBandMax + band] = reportedThresholds[k].firstCounts[band];
+		}
+	}
+
+	start = getMonotonicTimeInSeconds();
+
+	for (size_t frameIndex = 0; frameIndex < frameCount; frameIndex++)
+	{
+		const uint16_t *	rawCounts = rawFrameFileGetFrame(&rawFrameFile, frameIndex);
+		size_t			width = rawFrameFile.header.width;
+		size_t			bandPixelCounts[kAlarmThresholdsMaximum * kAlarmThresholdBandMax] = {0};
+		size_t			flaggedPixels = 0;
+		double			flaggedSum = 0.0;
+		double			flaggedMaximum = -INFINITY;
+
+		profile = getRawFrameProfile(arguments, &rawFrameFile, frameIndex);
+		if (profile == NULL)
+		{
+			ret = kCommonConstantReturnTypeError;
+
+			break;
+		}
+
+		/*
+		 *	Pixels below every threshold are not converted.
+		 */
+		if (profile != thresholdProfile)
+		{
+			deltaMethodContextInit(&deltaMethodContext, &profile->nominalParameters, &profile->parameterHalfWidths);
+			lowestFirstCount = kAlarmThresholdNumberOfCounts;
+			for (size_t k = 0; k < numberOfThresholds; k++)
+			{
+				alarmThresholdBuild(&thresholds[k], &deltaMethodContext, arguments->alarmThresholds[k]);
+				if (thresholds[k].firstCounts[kAlarmThresholdBandCentral] < lowestFirstCount)
+				{
+					lowestFirstCount = thresholds[k].firstCounts[kAlarmThresholdBandCentral];
+				}
+			}
+			thresholdProfile = profile;
+		}
+
+		for (size_t row = 0; row < rawFrameFile.header.height; row++)
+		{
+			const uint16_t *	rowCounts = &rawCounts[row * width];
+
+			alarmThresholdsCountRow(thresholds, numberOfThresholds, rowCounts, width, bandPixelCounts);
+
+			for (size_t i = 0; i < width; i++)
+			{
+				double	temperature = NAN;
+
+				if (rowCounts[i] >= lowestFirstCount)
+				{
+					temperature = calibrationContextConvertCounts(&profile->nominalContext, rowCounts[i]);
+					flaggedSum += temperature;
+					flaggedMaximum = fmax(flaggedMaximum, temperature);
+					flaggedPixels++;
+				}
+
+				if (temperatures != NULL)
+				{
+					temperatures[row * width + i] = temperature;
+				}
+			}
+		}
+
+		for (size_t k = 0; k < numberOfThresholds; k++)
+		{
+			for (size_t band = 0; band < kAlarmThresholdBandMax; band++)
+			{
+				frameBandPixelCounts[band][frameIndex * numberOfThresholds + k] = (double) bandPixelCounts[k * kAlarmThresholdBandMax + band];
+			}
+		}
+
+		frameFlaggedPixelCounts[frameIndex] = (double) flaggedPixels;
+		frameFlaggedMeans[frameIndex] = (flaggedPixels > 0) ? flaggedSum / flaggedPixels : NAN;
+		frameFlaggedMaxima[frameIndex] = (flaggedPixels > 0) ? flaggedMaximum : NAN;
+		overallFlaggedFraction += (double) flaggedPixels / pixelsPerFrame / frameCount;
+
+		if ((outputFile != NULL) && (fwrite(temperatures, sizeof(double), pixelsPerFrame, outputFile) != pixelsPerFrame))
+		{
+			fprintf(stderr, "Error: Could not write frame %zu to output file \"%s\".\n", frameIndex, arguments->common.outputFilePath);
+			ret = kCommonConstantReturnTypeError;
+
+			break;
+		}
+	}
+
+	elapsedSeconds = getMonotonicTimeInSeconds() - start;
+
+	if ((outputFile != NULL) && (fclose(outputFile) != 0))
+	{
+		fprintf(stderr, "Error: Could not close output file \"%s\".\n", arguments->common.outputFilePath);
+		ret = kCommonConstantReturnTypeError;
+	}
+
+	if (ret != kCommonConstantReturnTypeSuccess)
+	{
+		/*
+		 *	Nothing to report.
+		 */
+	}
+	else if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %" PRIu64 "\n", overallFlaggedFraction, (uint64_t)(elapsedSeconds*1000000));
+	}
+	else if (arguments->common.isOutputJSONMode)
+	{
+		JSONVariable	variables[] =
+		{
+			{ .variableSymbol = "alarmThresholds", .variableDescription = "Alarm thresholds", .values = (JSONVariablePointer){ .asDouble = arguments->alarmThresholds }, .type = kJSONVariableTypeDouble, .size = numberOfThresholds },
+			{ .variableSymbol = "alarmThresholdCounts", .variableDescription = "First raw count above the lower edge of the band, the threshold and the upper edge of the band, for each threshold", .values = (JSONVariablePointer){ .asDouble = alarmThresholdCounts }, .type = kJSONVariableTypeDouble, .size = numberOfThresholds * kAlarmThresholdBandMax },
+			{ .variableSymbol = "frameAlarmPixelCounts", .variableDescription = "Number of pixels above each threshold, for each frame", .values = (JSONVariablePointer){ .asDouble = frameBandPixelCounts[kAlarmThresholdBandCentral] }, .type = kJSONVariableTypeDouble, .size = frameCount * numberOfThresholds },
+			{ .variableSymbol = "frameCertainAlarmPixelCounts", .variableDescription = "Number of pixels above the upper edge of the band of each threshold, for each frame", .values = (JSONVariablePointer){ .asDouble = frameBandPixelCounts[kAlarmThresholdBandUpper] }, .type = kJSONVariableTypeDouble, .size = frameCount * numberOfThresholds },
+			{ .variableSymbol = "framePossibleAlarmPixelCounts", .variableDescription = "Number of pixels above the lower edge of the band of each threshold, for each frame", .values = (JSONVariablePointer){ .asDouble = frameBandPixelCounts[kAlarmThresholdBandLower] }, .type = kJSONVariableTypeDouble, .size = frameCount * numberOfThresholds },
+			{ .variableSymbol = "frameFlaggedPixelCounts", .variableDescription = "Number of pixels converted, for each frame", .values = (JSONVariablePointer){ .asDouble = frameFlaggedPixelCounts }, .type = kJSONVariableTypeDouble, .size = frameCount },
+			{ .variableSymbol = "frameFlaggedMeans", .variableDescription = "Mean of the pixels converted, for each frame (null if none were)", .values = (JSONVariablePointer){ .asDouble = frameFlaggedMeans }, .type = kJSONVariableTypeDouble, .size = frameCount },
+			{ .variableSymbol = "frameFlaggedMaxima", .variableDescription = "Maximum of the pixels converted, for each frame (null if none were)", .values = (JSONVariablePointer){ .asDouble = frameFlaggedMaxima }, .type = kJSONVariableTypeDouble, .size = frameCount },
+		};
+
+		/*
+		 *	The flagged means and maxima of frames without flagged pixels are NaN.
+		 */
+		printJSONVariablesWithNulls(variables, sizeof(variables) / sizeof(variables[0]), "Lepton FLIR Sensor Calibration");
+	}
+	else
+	{
+		printf(
+			"%s alarms: %zu frames of %" PRIu32 "x%" PRIu32 " pixels, %.2lf%% of the pixels converted.\n",
+			variableDescription,
+			frameCount,
+			rawFrameFile.header.width,
+			rawFrameFile.header.height,
+			100 * overallFlaggedFraction);
+		printf("\n");
+
+		for (size_t k = 0; k < numberOfThresholds; k++)
+		{
+			printf(
+				"\tAbove %.2lf %s: counts from %" PRIu32 " (uncertain from %" PRIu32 " to %" PRIu32 ", first-order standard deviation %.4lf %s)\n",
+				arguments->alarmThresholds[k],
+				unitsOfMeasurement,
+				reportedThresholds[k].firstCounts[kAlarmThresholdBandCentral],
+				reportedThresholds[k].firstCounts[kAlarmThresholdBandLower],
+				reportedThresholds[k].firstCounts[kAlarmThresholdBandUpper],
+				reportedThresholds[k].standardDeviation,
+				unitsOfMeasurement);
+		}
+		printf("\n");
+
+		for (size_t frameIndex = 0; frameIndex < frameCount; frameIndex++)
+		{
+			if (rawFrameFile.hasProfileIndices)
+			{
+				printf("\tFrame %zu (%s):", frameIndex, getRawFrameProfile(arguments, &rawFrameFile, frameIndex)->name);
+			}
+			else
+			{
+				printf("\tFrame %zu:", frameIndex);
+			}
+
+			printf(
+				" %.0lf pixels converted, mean %.2lf, maximum %.2lf %s\n",
+				frameFlaggedPixelCounts[frameIndex],
+				frameFlaggedMeans[frameIndex],
+				frameFlaggedMaxima[frameIndex],
+				unitsOfMeasurement);
+
+			for (size_t k = 0; k < numberOfThresholds; k++)
+			{
+				printf(
+					"\t\tAbove %.2lf %s: %.0lf pixels (%.0lf certain, %.0lf possible)\n",
+					arguments->alarmThresholds[k],
+					unitsOfMeasurement,
+					frameBandPixelCounts[kAlarmThresholdBandCentral][frameIndex * numberOfThresholds + k],
+					frameBandPixelCounts[kAlarmThresholdBandUpper][frameIndex * numberOfThresholds + k],
+					frameBandPixelCounts[kAlarmThresholdBandLower][frameIndex * numberOfThresholds + k]);
+			}
+		}
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf(
+				"\nWall-clock time used: %lf seconds (%.1lf Mpixels/s)\n",
+				elapsedSeconds,
+				(elapsedSeconds > 0) ? (frameCount * pixelsPerFrame) / elapsedSeconds / 1e6 : 0.0);
+		}
+	}
+
+	free(frameFlaggedMaxima);
+	free(frameFlaggedMeans);
+	free(frameFlaggedPixelCounts);
+	for (size_t band = 0; band < kAlarmThresholdBandMax; band++)
+	{
+		free(frameBandPixelCounts[band]);
+	}
+	free(alarmThresholdCounts);
+	free(temperatures);
+	rawFrameFileClose(&rawFrameFile);
+
+	return ret;
+}
+
+/**
+ *	@brief  Runs the streaming frame pipeline with the nominal calibration, from `-i` (or stdin)
+ *		to `-o` (or stdout). Either can be a FIFO. The report goes to stderr, since stdout
+ *		may carry the temperature frames.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runFrameStream(CommandLineArguments *  arguments)
+{
+	FramePipelineConfiguration	configuration;
+	FramePipelineReport		report;
+	const CalibrationContext *	nominalContext = &arguments->calibrationProfile->nominalContext;
+	CountsLookupTable		countsLookupTable = {0};
+	CommonConstantReturnType	ret;
+
+	if (arguments->isLookupTableMode && (countsLookupTableBuild(&countsLookupTable, nominalContext) != kCommonConstantReturnTypeSuccess))
 	{
-		counts = inputDistributions[kInputDistributionIndexSensorCounts];
+		return kCommonConstantReturnTypeError;
 	}
-	else
+
+	configuration = (FramePipelineConfiguration)
 	{
-		counts = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
-	}
+		.inputPath = arguments->common.isInputFromFileEnabled ? arguments->common.inputFilePath : NULL,
+		.outputPath = arguments->common.isWriteToFileEnabled ? arguments->common.outputFilePath : NULL,
+		.isRealTime = arguments->isRealTimeFrameStreamMode,
+		.context = nominalContext,
+		.lookupTable = arguments->isLookupTableMode ? &countsLookupTable : NULL,
+		.precision = arguments->precision,
+	};
 
-	K1	=	1 /
-			(
-				kFLIRatmosphericAttenuationParameterTau *
-				kFLIRobjectParameterEmiss *
-				kFLIRexternalOpticsParameterTransmissionExtOptics
-			);
+	ret = framePipelineRun(&configuration, &report);
 
 	/*
-	 *	Pseudo radiance of the reflected environment
+	 *	A zero width means the stream header was never read, so there is nothing to report.
 	 */
-	r1	=	((1 - kFLIRobjectParameterEmiss)/kFLIRobjectParameterEmiss) * 
-			(
-				kFLIRcameraAx5CalibrationParameterR /
-				(
-					pow(M_E, kFLIRcameraAx5CalibrationParameterB/kFLIRobjectParameterTRefl) -
-					kFLIRcameraAx5CalibrationParameterF
-				)
-			);
+	if (report.width != 0)
+	{
+		framePipelinePrintReport(stderr, &report, getFrameConversionName(arguments));
+	}
+	framePipelineReportFree(&report);
+
+	countsLookupTableFree(&countsLookupTable);
+
+	return ret;
+}
+
+/**
+ *	@brief  Serves conversions on the `-srv` socket with the `-cp` profiles until SIGINT or SIGTERM,
+ *		then prints the number of clients and requests served to stderr.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runConversionServer(CommandLineArguments *  arguments)
+{
+	ConversionServerConfiguration	configuration;
+	ConversionServerReport		report;
+	CommonConstantReturnType	ret;
+
+	configuration = (ConversionServerConfiguration)
+	{
+		.socketPath = arguments->serverSocketPath,
+		.profiles = &arguments->calibrationProfiles,
+		.seed = arguments->randomSeed,
+		.numberOfThreads = arguments->numberOfThreads,
+	};
+
+	ret = conversionServerRun(&configuration, &report);
+
+	if (report.numberOfConnections > 0)
+	{
+		fprintf(
+			stderr,
+			"Conversion server: %zu requests from %zu clients in %.3f s.\n",
+			report.numberOfRequests,
+			report.numberOfConnections,
+			report.elapsedSeconds);
+	}
+
+	return ret;
+}
+
+/**
+ *	@brief  Propagates the uncertainty of the `counts` distribution (or the `-sp` value) and of
+ *		the calibration parameters to first order, then evaluates the same inputs with the
+ *		native Monte Carlo engine and prints both.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  variableDescription	: A string decribing the converted variable.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the converted variable.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runDeltaMethodComparison(
+	CommandLineArguments *	arguments,
+	const char *		variableDescription,
+	const char *		unitsOfMeasurement)
+{
+	MonteCarloConfiguration	monteCarloConfiguration;
+	DeltaMethodContext	deltaMethodContext;
+	DeltaMethodResult	deltaMethodResult;
+	StreamingStatistics	monteCarloStatistics;
+	double			countsRange;
+	double			start;
+	double			deltaMethodSeconds;
+	double			monteCarloSeconds;
+	size_t			numberOfIterations = arguments->common.isMonteCarloMode ?
+							arguments->common.numberOfMonteCarloIterations :
+							kDeltaMethodDefaultComparisonIterations;
+
+	monteCarloConfigurationSetDefaults(&monteCarloConfiguration);
+	monteCarloConfiguration.nominalParameters = arguments->calibrationProfile->nominalParameters;
+	monteCarloConfiguration.parameterHalfWidths = arguments->calibrationProfile->parameterHalfWidths;
+	monteCarloConfiguration.seed = arguments->randomSeed;
+	monteCarloConfiguration.numberOfThreads = arguments->numberOfThreads;
+	monteCarloConfiguration.samplingMethod = arguments->samplingMethod;
+	monteCarloConfiguration.numberOfDesignPoints = numberOfIterations;
+
+	if (!isnan(arguments->countValueReadFromArgvToOverrideDefaultDistribution))
+	{
+		monteCarloConfiguration.countsLow = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
+		monteCarloConfiguration.countsHigh = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
+	}
 
 	/*
-	 *	Pseudo radiance of the atmosphere
+	 *	`counts` is uniform on [countsLow, countsHigh].
 	 */
-	r2	=	(
-				(1 - kFLIRatmosphericAttenuationParameterTau) /
-				(kFLIRobjectParameterEmiss * kFLIRatmosphericAttenuationParameterTau)
-			) *
-			(
-				kFLIRcameraAx5CalibrationParameterR /
-				(
-					pow(M_E, kFLIRcameraAx5CalibrationParameterB/kFLIRatmosphericAttenuationParameterTAtm) -
-					kFLIRcameraAx5CalibrationParameterF
-				)
-			);
+	countsRange = monteCarloConfiguration.countsHigh - monteCarloConfiguration.countsLow;
+
+	start = getMonotonicTimeInSeconds();
+	deltaMethodContextInit(&deltaMethodContext, &monteCarloConfiguration.nominalParameters, &monteCarloConfiguration.parameterHalfWidths);
+	deltaMethodPropagate(
+		&deltaMethodContext,
+		(monteCarloConfiguration.countsLow + monteCarloConfiguration.countsHigh) / 2,
+		countsRange * countsRange / 12,
+		&deltaMethodResult);
+	deltaMethodSeconds = getMonotonicTimeInSeconds() - start;
+
+	streamingStatisticsInit(&monteCarloStatistics);
+
+	start = getMonotonicTimeInSeconds();
+	if (monteCarloRunStreaming(&monteCarloConfiguration, 0, numberOfIterations, &monteCarloStatistics) != kCommonConstantReturnTypeSuccess)
+	{
+		streamingStatisticsFree(&monteCarloStatistics);
+
+		return kCommonConstantReturnTypeError;
+	}
+	monteCarloSeconds = getMonotonicTimeInSeconds() - start;
+
+	printDeltaMethodComparison(
+		arguments,
+		&deltaMethodResult,
+		deltaMethodSeconds,
+		&monteCarloStatistics,
+		monteCarloSeconds,
+		variableDescription,
+		unitsOfMeasurement);
+
+	streamingStatisticsFree(&monteCarloStatistics);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief  Runs replications of the native Monte Carlo evaluation with each sampling method, with
+ *		the same number of iterations, and prints how the error of each compares.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  variableDescription	: A string decribing the converted variable.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the converted variable.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runSamplingMethodComparison(
+	CommandLineArguments *	arguments,
+	const char *		variableDescription,
+	const char *		unitsOfMeasurement)
+{
+	MonteCarloConfiguration		monteCarloConfiguration;
+	MonteCarloSamplingComparison	comparison;
+
+	monteCarloConfigurationSetDefaults(&monteCarloConfiguration);
+	monteCarloConfiguration.nominalParameters = arguments->calibrationProfile->nominalParameters;
+	monteCarloConfiguration.parameterHalfWidths = arguments->calibrationProfile->parameterHalfWidths;
+	monteCarloConfiguration.seed = arguments->randomSeed;
+	monteCarloConfiguration.numberOfThreads = arguments->numberOfThreads;
+
+	if (!isnan(arguments->countValueReadFromArgvToOverrideDefaultDistribution))
+	{
+		monteCarloConfiguration.countsLow = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
+		monteCarloConfiguration.countsHigh = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
+	}
+
+	if (monteCarloCompareSamplingMethods(
+		&monteCarloConfiguration,
+		arguments->common.numberOfMonteCarloIterations,
+		&comparison) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	printSamplingMethodComparison(arguments, &comparison, variableDescription, unitsOfMeasurement);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief  The largest of the standard errors that adaptive Monte Carlo must bring down to its
+ *		target: those of the mean, of the standard deviation and of each target quantile.
+ *
+ *	@param  arguments	: Pointer to command line arguments struct.
+ *	@param  statistics	: Pointer to the streaming statistics of the iterations run so far.
+ *
+ *	@return			: The largest standard error, in Kelvin.
+ */
+static double
+adaptiveMonteCarloLargestStandardError(const CommandLineArguments *  arguments, const StreamingStatistics *  statistics)
+{
+	double	quantiles[kMonteCarloAdaptiveMaximumQuantiles];
+	double	quantileStandardErrors[kMonteCarloAdaptiveMaximumQuantiles];
+	double	largestStandardError = fmax(
+						streamingStatisticsMeanStandardError(statistics),
+						streamingStatisticsStandardDeviationStandardError(statistics));
+
+	streamingStatisticsQuantileStandardErrors(
+		statistics,
+		arguments->targetQuantileProbabilities,
+		arguments->numberOfTargetQuantiles,
+		quantiles,
+		quantileStandardErrors);
+
+	for (size_t i = 0; i < arguments->numberOfTargetQuantiles; i++)
+	{
+		largestStandardError = fmax(largestStandardError, quantileStandardErrors[i]);
+	}
+
+	return largestStandardError;
+}
+
+/**
+ *	@brief  Runs the native Monte Carlo evaluation in blocks of iterations until the standard
+ *		errors of the mean, standard deviation and target quantiles are all at most the
+ *		target, or until `-M` iterations have run, and prints the precision reached. Fails
+ *		once a target quantile's standard error is seen to be bounded above the target.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  variableDescription	: A string decribing the converted variable.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the converted variable.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runAdaptiveMonteCarlo(
+	CommandLineArguments *	arguments,
+	const char *		variableDescription,
+	const char *		unitsOfMeasurement)
+{
+	MonteCarloConfiguration	monteCarloConfiguration;
+	StreamingStatistics	statistics;
+	size_t			maximumIterations = arguments->common.numberOfMonteCarloIterations;
+	size_t			numberOfIterations = 0;
+	size_t			numberOfBlocks = 0;
+	size_t			blockSize = (maximumIterations < kMonteCarloAdaptiveInitialIterations) ?
+						maximumIterations :
+						kMonteCarloAdaptiveInitialIterations;
+	double			start;
+
+	monteCarloConfigurationSetDefaults(&monteCarloConfiguration);
+	monteCarloConfiguration.nominalParameters = arguments->calibrationProfile->nominalParameters;
+	monteCarloConfiguration.parameterHalfWidths = arguments->calibrationProfile->parameterHalfWidths;
+	monteCarloConfiguration.seed = arguments->randomSeed;
+	monteCarloConfiguration.numberOfThreads = arguments->numberOfThreads;
+
+	if (!isnan(arguments->countValueReadFromArgvToOverrideDefaultDistribution))
+	{
+		monteCarloConfiguration.countsLow = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
+		monteCarloConfiguration.countsHigh = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
+	}
+
+	streamingStatisticsInit(&statistics);
 
 	/*
-	 *	Pseudo radiance of the external optics
+	 *	Each block continues the iteration sequence of the previous one, so the result is that
+	 *	of a single run of the same total number of iterations.
 	 */
-	r3	=	(
-				(1 - kFLIRexternalOpticsParameterTransmissionExtOptics) /
-				(
-					kFLIRobjectParameterEmiss *
-					kFLIRatmosphericAttenuationParameterTau *
-					kFLIRexternalOpticsParameterTransmissionExtOptics
-				)
-			) *
-			(
-				kFLIRcameraAx5CalibrationParameterR /
-				(
-					pow(M_E, kFLIRcameraAx5CalibrationParameterB/kFLIRexternalOpticsParameterTExtOptics) -
-					kFLIRcameraAx5CalibrationParameterF
-				)
-			);
-
-	K2	=	r1 + r2 + r3;
-	signal	=	(counts - kFLIRcameraAx5CalibrationParameterJ0) / kFLIRcameraAx5CalibrationParameterJ1;
-	calibratedValue	=	(
-					kFLIRcameraAx5CalibrationParameterB /
-					log(
-						kFLIRcameraAx5CalibrationParameterR /
-						((K1 * signal) - K2) + kFLIRcameraAx5CalibrationParameterF
-					)
-				) - kAbsoluteZeroKelvinInCelsius;
+	start = getMonotonicTimeInSeconds();
+	for (;;)
+	{
+		double	largestStandardError;
+		double	predictedIterations;
+		double	quantileStandardErrorFloors[kMonteCarloAdaptiveMaximumQuantiles];
 
-	outputDistributions[kOutputDistributionIndexCalibratedSensorOutput] = calibratedValue;
+		if (monteCarloRunStreaming(&monteCarloConfiguration, numberOfIterations, blockSize, &statistics) != kCommonConstantReturnTypeSuccess)
+		{
+			streamingStatisticsFree(&statistics);
 
-	return	calibratedValue;
+			return kCommonConstantReturnTypeError;
+		}
+
+		numberOfIterations += blockSize;
+		numberOfBlocks++;
+
+		largestStandardError = adaptiveMonteCarloLargestStandardError(arguments, &statistics);
+		if ((largestStandardError <= arguments->targetStandardError) || (numberOfIterations == maximumIterations))
+		{
+			break;
+		}
+
+		/*
+		 *	The rank error of the quantile sketch does not shrink with more iterations, so a
+		 *	quantile target below it would only use up the whole `-M` budget.
+		 */
+		streamingStatisticsQuantileStandardErrorFloors(
+			&statistics,
+			arguments->targetQuantileProbabilities,
+			arguments->numberOfTargetQuantiles,
+			quantileStandardErrorFloors);
+		for (size_t i = 0; i < arguments->numberOfTargetQuantiles; i++)
+		{
+			if (quantileStandardErrorFloors[i] > arguments->targetStandardError)
+			{
+				fprintf(
+					stderr,
+					"Error: The standard error of the %g%% quantile cannot fall below about %.3e %s, the rank error of the "
+					"streaming quantile sketch, so the target standard error of %.3e %s cannot be met. Use a larger target.\n",
+					100 * arguments->targetQuantileProbabilities[i],
+					quantileStandardErrorFloors[i],
+					unitsOfMeasurement,
+					arguments->targetStandardError,
+					unitsOfMeasurement);
+				streamingStatisticsFree(&statistics);
+
+				return kCommonConstantReturnTypeError;
+			}
+		}
+
+		/*
+		 *	The standard errors fall as 1/sqrt(iterations): aim 10% past the predicted total,
+		 *	but at most double the iterations per block, since the estimate is noisy early on.
+		 */
+		predictedIterations = numberOfIterations * 1.1 *
+					(largestStandardError / arguments->targetStandardError) *
+					(largestStandardError / arguments->targetStandardError);
+		blockSize = (predictedIterations < 2.0 * numberOfIterations) ?
+				(size_t) (predictedIterations - numberOfIterations) :
+				numberOfIterations;
+		blockSize = (blockSize < kMonteCarloAdaptiveInitialIterations) ? kMonteCarloAdaptiveInitialIterations : blockSize;
+		blockSize = (blockSize > maximumIterations - numberOfIterations) ? maximumIterations - numberOfIterations : blockSize;
+	}
+
+	printAdaptiveMonteCarloReport(
+		arguments,
+		&statistics,
+		numberOfBlocks,
+		getMonotonicTimeInSeconds() - start,
+		variableDescription,
+		unitsOfMeasurement);
+
+	streamingStatisticsFree(&statistics);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief  Measures the float32 frame kernel against the float64 one over all 65536 counts of
+ *		the nominal calibration, and prints the result.
+ *
+ *	@param  arguments		: Pointer to command line arguments struct.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the converted variable.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if the float32 kernel is within
+ *					  `kFloat32ConversionToleranceKelvin` at every count, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runFloat32ConversionReport(CommandLineArguments *  arguments, const char *  unitsOfMeasurement)
+{
+	Float32ConversionErrorReport	report;
+
+	if (measureFloat32ConversionError(&arguments->calibrationProfile->nominalContext, &report) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	printFloat32ConversionReport(arguments, &report, unitsOfMeasurement);
+
+	return ((report.numberOfCountsOutsideTolerance == 0) && (report.float64MaximumUlpDifference <= kVectorizedConversionMaximumUlpDifference)) ?
+		kCommonConstantReturnTypeSuccess :
+		kCommonConstantReturnTypeError;
 }
 
 int
 main(int argc, char *  argv[])
 {
 	CommandLineArguments	arguments = {0};
+	CalibrationContext	calibrationContext;
+	CountsLookupTable	countsLookupTable = {0};
+	ExceedanceTable		exceedanceTable = {0};
+	ExceedanceTable *	pointerToExceedanceTable = NULL;
 
 	double			calibratedSensorOutput;
 	double *		monteCarloOutputSamples = NULL;
+	StreamingStatistics	monteCarloStatistics;
 	clock_t			start;
 	clock_t			end;
 	double			cpuTimeUsedSeconds;
@@ -171,6 +1695,11 @@ main(int argc, char *  argv[])
 					"Kelvin",
 				};
 	MeanAndVariance		meanAndVariance;
+	MonteCarloConfiguration	monteCarloConfiguration;
+	InstrumentationCounters *	instrumentation = instrumentationGetProcessCounters();
+	CommonConstantReturnType	ret;
+	double			stageStart;
+	size_t			outputValuesWritten;
 
 	/*
 	 *	Get command line arguments.
@@ -180,7 +1709,93 @@ main(int argc, char *  argv[])
 		return kCommonConstantReturnTypeError;
 	}
 
-	if (arguments.common.isMonteCarloMode)
+	if (arguments.serverSocketPath != NULL)
+	{
+		ret = runConversionServer(&arguments);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	if (arguments.isFrameStreamMode)
+	{
+		ret = runFrameStream(&arguments);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	/*
+	 *	Raw frame file input (-i) converts whole frames instead of a single `counts` value or,
+	 *	with alarm thresholds (-at), only the pixels above them.
+	 */
+	if (arguments.common.isInputFromFileEnabled && (arguments.numberOfAlarmThresholds > 0))
+	{
+		ret = runFrameAlarms(
+			&arguments,
+			outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput],
+			unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	if (arguments.common.isInputFromFileEnabled)
+	{
+		ret = convertRawFrameFileInput(
+			&arguments,
+			outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput],
+			unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	if (arguments.isFloat32ReportMode)
+	{
+		ret = runFloat32ConversionReport(&arguments, unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	if (arguments.isSamplingMethodComparisonMode)
+	{
+		ret = runSamplingMethodComparison(
+			&arguments,
+			outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput],
+			unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	if (arguments.targetStandardError > 0)
+	{
+		ret = runAdaptiveMonteCarlo(
+			&arguments,
+			outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput],
+			unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	if (arguments.isDeltaMethodMode)
+	{
+		ret = runDeltaMethodComparison(
+			&arguments,
+			outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput],
+			unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
+		freeCommandLineArguments(&arguments);
+
+		return ret;
+	}
+
+	/*
+	 *	The streaming statistics mode never materializes the samples.
+	 */
+	if (arguments.common.isMonteCarloMode && !arguments.isStreamingStatisticsMode)
 	{
 		monteCarloOutputSamples = (double *) checkedMalloc(
 							arguments.common.numberOfMonteCarloIterations * sizeof(double),
@@ -196,34 +1811,125 @@ main(int argc, char *  argv[])
 		start = clock();
 	}
 
-	for (size_t i = 0; i < arguments.common.numberOfMonteCarloIterations; i++)
+	if (arguments.isLookupTableMode)
+	{
+		calibratedSensorOutput = calculateSensorOutputViaLookupTable(&arguments, &countsLookupTable, outputDistributions);
+
+		if (countsLookupTable.temperatures == NULL)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+	else if (arguments.common.isMonteCarloMode)
 	{
 		/*
-		 *	Set input distribution values, inside the main computation
-		 *	loop, so that it can also generate samples in the native
-		 *	Monte Carlo Execution Mode.
+		 *	Native Monte Carlo: every iteration draws a new set of calibration
+		 *	parameters and `counts` from its own counter-based random stream.
 		 */
-		setInputDistributionsViaUxHwCall(inputDistributions);
+		monteCarloConfigurationSetDefaults(&monteCarloConfiguration);
+		monteCarloConfiguration.nominalParameters = arguments.calibrationProfile->nominalParameters;
+		monteCarloConfiguration.parameterHalfWidths = arguments.calibrationProfile->parameterHalfWidths;
+		monteCarloConfiguration.seed = arguments.randomSeed;
+		monteCarloConfiguration.numberOfThreads = arguments.numberOfThreads;
+		monteCarloConfiguration.samplingMethod = arguments.samplingMethod;
+		monteCarloConfiguration.numberOfDesignPoints = arguments.common.numberOfMonteCarloIterations;
 
-		calibratedSensorOutput = calculateSensorOutput(&arguments, inputDistributions, outputDistributions);
+		if (!isnan(arguments.countValueReadFromArgvToOverrideDefaultDistribution))
+		{
+			monteCarloConfiguration.countsLow = arguments.countValueReadFromArgvToOverrideDefaultDistribution;
+			monteCarloConfiguration.countsHigh = arguments.countValueReadFromArgvToOverrideDefaultDistribution;
+		}
 
-		/*
-		 *	For this application, calibratedSensorOutput is the item we track.
-		 */
-		if (arguments.common.isMonteCarloMode)
+		if (arguments.isStreamingStatisticsMode)
+		{
+			streamingStatisticsInit(&monteCarloStatistics);
+
+			if (monteCarloRunStreaming(
+				&monteCarloConfiguration,
+				0,
+				arguments.common.numberOfMonteCarloIterations,
+				&monteCarloStatistics) != kCommonConstantReturnTypeSuccess)
+			{
+				streamingStatisticsFree(&monteCarloStatistics);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			calibratedSensorOutput = monteCarloStatistics.moments.mean;
+			outputDistributions[kOutputDistributionIndexCalibratedSensorOutput] = calibratedSensorOutput;
+		}
+		else
 		{
-			monteCarloOutputSamples[i] = calibratedSensorOutput;
+			if (monteCarloRun(
+				&monteCarloConfiguration,
+				0,
+				arguments.common.numberOfMonteCarloIterations,
+				monteCarloOutputSamples) != kCommonConstantReturnTypeSuccess)
+			{
+				free(monteCarloOutputSamples);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			outputDistributions[kOutputDistributionIndexCalibratedSensorOutput] =
+				monteCarloOutputSamples[arguments.common.numberOfMonteCarloIterations - 1];
 		}
 	}
+	else
+	{
+		/*
+		 *	Set input distribution values, so that on Signaloid platforms they
+		 *	carry the full `counts` distribution.
+		 */
+		stageStart = instrumentationNow();
+		setInputDistributionsViaUxHwCall(inputDistributions);
+		instrumentationStop(instrumentation, kInstrumentationStageInputSampling, 1, stageStart);
+
+		/*
+		 *	The count-independent terms only depend on the calibration parameters,
+		 *	so they are computed once, outside the per-count work.
+		 */
+		stageStart = instrumentationNow();
+		calibrationContextInitFromDistributions(
+			&calibrationContext,
+			&arguments.calibrationProfile->nominalParameters,
+			&arguments.calibrationProfile->parameterHalfWidths);
+		instrumentationStop(instrumentation, kInstrumentationStageRadianceTerms, 1, stageStart);
+
+		stageStart = instrumentationNow();
+		calibratedSensorOutput = calculateSensorOutput(&arguments, &calibrationContext, inputDistributions, outputDistributions);
+		instrumentationStop(instrumentation, kInstrumentationStageLogarithm, 1, stageStart);
+	}
 
 	/*
 	 *	If not doing Laplace version, then approximate the cost of the third phase of
 	 *	Monte Carlo (post-processing), by calculating the mean and variance.
 	 */
-	if (arguments.common.isMonteCarloMode)
+	if (arguments.common.isMonteCarloMode && !arguments.isStreamingStatisticsMode)
 	{
+		stageStart = instrumentationNow();
 		meanAndVariance = calculateMeanAndVarianceOfDoubleSamples(monteCarloOutputSamples, arguments.common.numberOfMonteCarloIterations);
 		calibratedSensorOutput = meanAndVariance.mean;
+		instrumentationStop(instrumentation, kInstrumentationStageStatistics, arguments.common.numberOfMonteCarloIterations, stageStart);
+	}
+
+	/*
+	 *	The samples are sorted once, so that every printed probability is a binary
+	 *	search instead of a pass over the samples.
+	 */
+	if (arguments.common.isMonteCarloMode && !arguments.isStreamingStatisticsMode && !arguments.common.isBenchmarkingMode &&
+		(!arguments.common.isOutputJSONMode || (arguments.numberOfExceedanceThresholds > 0)))
+	{
+		stageStart = instrumentationNow();
+		if (exceedanceTableBuild(&exceedanceTable, monteCarloOutputSamples, arguments.common.numberOfMonteCarloIterations) != kCommonConstantReturnTypeSuccess)
+		{
+			free(monteCarloOutputSamples);
+
+			return kCommonConstantReturnTypeError;
+		}
+		instrumentationStop(instrumentation, kInstrumentationStageStatistics, arguments.common.numberOfMonteCarloIterations, stageStart);
+
+		pointerToExceedanceTable = &exceedanceTable;
 	}
 
 	/*
@@ -235,6 +1941,58 @@ main(int argc, char *  argv[])
 		cpuTimeUsedSeconds = ((double)(end - start)) / CLOCKS_PER_SEC;
 	}
 
+	/*
+	 *	Write the output files before printing the results, so that the stage
+	 *	timings printed with them include the writes.
+	 */
+	stageStart = instrumentationNow();
+	outputValuesWritten = 0;
+	if (arguments.common.isMonteCarloMode && !arguments.isStreamingStatisticsMode)
+	{
+		/*
+		 *	Save Monte carlo outputs in an output file.
+		 */
+		if (arguments.binarySamplesPath != NULL)
+		{
+			if (sampleFileWrite(
+				arguments.binarySamplesPath,
+				arguments.isBinarySamplesFloat32 ? kSampleFileDataTypeFloat32 : kSampleFileDataTypeFloat64,
+				monteCarloOutputSamples,
+				arguments.common.numberOfMonteCarloIterations,
+				(uint64_t)(cpuTimeUsedSeconds*1000000),
+				&monteCarloConfiguration) != kCommonConstantReturnTypeSuccess)
+			{
+				exceedanceTableFree(&exceedanceTable);
+				free(monteCarloOutputSamples);
+
+				return kCommonConstantReturnTypeError;
+			}
+		}
+		else
+		{
+			saveMonteCarloDoubleDataToDataDotOutFile(monteCarloOutputSamples, (uint64_t)(cpuTimeUsedSeconds*1000000), arguments.common.numberOfMonteCarloIterations);
+		}
+		outputValuesWritten += arguments.common.numberOfMonteCarloIterations;
+	}
+
+	if (!arguments.common.isBenchmarkingMode && arguments.common.isWriteToFileEnabled)
+	{
+		if (writeOutputDoubleDistributionsToCSV(
+			arguments.common.outputFilePath,
+			outputDistributions,
+			outputVariableNames,
+			kOutputDistributionIndexMax))
+		{
+			exceedanceTableFree(&exceedanceTable);
+			free(monteCarloOutputSamples);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		outputValuesWritten += kOutputDistributionIndexMax;
+	}
+	instrumentationStop(instrumentation, kInstrumentationStageOutput, outputValuesWritten, stageStart);
+
 	if (arguments.common.isBenchmarkingMode)
 	{
 		/*
@@ -249,10 +2007,20 @@ main(int argc, char *  argv[])
 		/*
 		 *	Print the results (either in JSON or standard output format).
 		 */
-		if (!arguments.common.isOutputJSONMode)
+		if (arguments.isStreamingStatisticsMode)
+		{
+			printStreamingStatistics(
+				&arguments,
+				&monteCarloStatistics,
+				outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput],
+				unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
+		}
+		else if (!arguments.common.isOutputJSONMode)
 		{
 				printCalibratedValueAndProbabilities(
+					&arguments,
 					calibratedSensorOutput,
+					pointerToExceedanceTable,
 					outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput],
 					unitsOfMeasurement[kOutputDistributionIndexCalibratedSensorOutput]);
 		}
@@ -262,6 +2030,7 @@ main(int argc, char *  argv[])
 				&arguments,
 				&outputDistributions[kOutputDistributionIndexCalibratedSensorOutput],
 				monteCarloOutputSamples,
+				pointerToExceedanceTable,
 				outputVariableNames[kOutputDistributionIndexCalibratedSensorOutput]);
 		}
 
@@ -271,34 +2040,32 @@ main(int argc, char *  argv[])
 		if (arguments.common.isTimingEnabled)
 		{
 			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedSeconds);
-		}
 
-		/*
-		 *	Write output data.
-		 */
-		if (arguments.common.isWriteToFileEnabled)
-		{
-			if (writeOutputDoubleDistributionsToCSV(
-				arguments.common.outputFilePath,
-				outputDistributions,
-				outputVariableNames,
-				kOutputDistributionIndexMax))
+			if (kInstrumentationEnabled)
 			{
-				return kCommonConstantReturnTypeError;
+				instrumentationPrintReport(stdout, instrumentation);
 			}
 		}
+
+		if (arguments.isLookupTableMode && !arguments.common.isOutputJSONMode)
+		{
+			countsLookupTablePrintReport(&countsLookupTable);
+		}
 	}
 
 	/*
-	 *	Save Monte carlo outputs in an output file.
 	 *	Free dynamically-allocated memory.
 	 */
-	if (arguments.common.isMonteCarloMode)
-	{
-		saveMonteCarloDoubleDataToDataDotOutFile(monteCarloOutputSamples, (uint64_t)(cpuTimeUsedSeconds*1000000), arguments.common.numberOfMonteCarloIterations);
+	exceedanceTableFree(&exceedanceTable);
+	free(monteCarloOutputSamples);
 
-		free(monteCarloOutputSamples);
+	if (arguments.isStreamingStatisticsMode)
+	{
+		streamingStatisticsFree(&monteCarloStatistics);
 	}
 
+	countsLookupTableFree(&countsLookupTable);
+	freeCommandLineArguments(&arguments);
+
 	return 0;
 }
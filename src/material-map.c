@@ -0,0 +1,371 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include "common.h"
+#include "calibration.h"
+#include "raw-frames.h"
+#include "material-map.h"
+
+static const char *	kMaterialMapSeparators = " \t\r\n";
+
+/*
+ *	Only the parameters of the scene, not those of the camera, vary between materials.
+ */
+static bool
+materialTableIsSceneParameter(CalibrationParameterIndex parameterIndex)
+{
+	return	(parameterIndex == kCalibrationParameterIndexEmiss) ||
+		(parameterIndex == kCalibrationParameterIndexTRefl) ||
+		(parameterIndex == kCalibrationParameterIndexTAtmC) ||
+		(parameterIndex == kCalibrationParameterIndexTau);
+}
+
+void
+materialTableInit(MaterialTable *  table)
+{
+	for (size_t label = 0; label < kMaterialMapMaximumLabels; label++)
+	{
+		for (size_t p = 0; p < kCalibrationParameterIndexMax; p++)
+		{
+			table->parameterOverrides[label][p] = NAN;
+		}
+		table->isLabelDefined[label] = false;
+	}
+	table->numberOfDefinedLabels = 0;
+
+	return;
+}
+
+CommonConstantReturnType
+materialTableSetParameter(
+	MaterialTable *			table,
+	uint8_t				label,
+	CalibrationParameterIndex	parameterIndex,
+	double				value)
+{
+	if ((parameterIndex >= kCalibrationParameterIndexMax) || !materialTableIsSceneParameter(parameterIndex) || !isfinite(value))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	table->parameterOverrides[label][parameterIndex] = value;
+	if (!table->isLabelDefined[label])
+	{
+		table->isLabelDefined[label] = true;
+		table->numberOfDefinedLabels++;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Parses the `<parameter> <value>` pairs that follow the label of a table line.
+ */
+static CommonConstantReturnType
+materialTableParseLine(MaterialTable *  table, uint8_t label, const char *  path, size_t lineNumber)
+{
+	const char *	parameterName;
+	bool		hasParameters = false;
+
+	while ((parameterName = strtok(NULL, kMaterialMapSeparators)) != NULL)
+	{
+		const char *			valueToken = strtok(NULL, kMaterialMapSeparators);
+		CalibrationParameterIndex	parameterIndex = kCalibrationParameterIndexMax;
+		double				value;
+
+		for (size_t p = 0; p < kCalibrationParameterIndexMax; p++)
+		{
+			if (strcmp(parameterName, calibrationParameterGetName((CalibrationParameterIndex) p)) == 0)
+			{
+				parameterIndex = (CalibrationParameterIndex) p;
+			}
+		}
+
+		if ((valueToken == NULL) ||
+			(parseDoubleChecked(valueToken, &value) != kCommonConstantReturnTypeSuccess) ||
+			(materialTableSetParameter(table, label, parameterIndex, value) != kCommonConstantReturnTypeSuccess))
+		{
+			fprintf(
+				stderr,
+				"Error: %s:%zu: Expected \"<parameter> <value>\" pairs, with a finite value for one of Emiss, TRefl, TAtmC or Tau, at \"%s\".\n",
+				path,
+				lineNumber,
+				parameterName);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		hasParameters = true;
+	}
+
+	if (!hasParameters)
+	{
+		fprintf(stderr, "Error: %s:%zu: Material %d sets no parameters.\n", path, lineNumber, (int) label);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+materialTableLoad(MaterialTable *  table, const char *  path)
+{
+	FILE *		inputFile;
+	char		line[kMaterialMapMaximumLineLength];
+	size_t		lineNumber = 0;
+
+	materialTableInit(table);
+
+	inputFile = fopen(path, "r");
+	if (inputFile == NULL)
+	{
+		fprintf(stderr, "Error: Could not open material table file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	while (fgets(line, sizeof(line), inputFile) != NULL)
+	{
+		char *		comment = strchr(line, '#');
+		const char *	labelToken;
+		int		label;
+
+		lineNumber++;
+		if ((strchr(line, '\n') == NULL) && !feof(inputFile))
+		{
+			fprintf(stderr, "Error: %s:%zu: Line is longer than %d characters.\n", path, lineNumber, kMaterialMapMaximumLineLength - 2);
+			fclose(inputFile);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (comment != NULL)
+		{
+			*comment = '\0';
+		}
+
+		labelToken = strtok(line, kMaterialMapSeparators);
+		if (labelToken == NULL)
+		{
+			continue;
+		}
+
+		if ((parseIntChecked(labelToken, &label) != kCommonConstantReturnTypeSuccess) || (label < 0) || (label >= kMaterialMapMaximumLabels))
+		{
+			fprintf(stderr, "Error: %s:%zu: Material labels must be integers from 0 to %d.\n", path, lineNumber, kMaterialMapMaximumLabels - 1);
+			fclose(inputFile);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (materialTableParseLine(table, (uint8_t) label, path, lineNumber) != kCommonConstantReturnTypeSuccess)
+		{
+			fclose(inputFile);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (ferror(inputFile))
+	{
+		fprintf(stderr, "Error: Could not read material table file \"%s\".\n", path);
+		fclose(inputFile);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	fclose(inputFile);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+materialTableBuild(
+	MaterialTable *			table,
+	const MaterialMap *		map,
+	const CalibrationParameters *	nominalParameters)
+{
+	CalibrationContext	baseContext = {0};
+
+	calibrationContextUpdate(&baseContext, nominalParameters);
+
+	for (size_t slot = 0; slot < kMaterialMapMaximumLabels; slot++)
+	{
+		CalibrationContext *	context = &table->contexts[slot];
+		uint8_t			label = map->slotLabels[slot];
+
+		if ((slot < map->numberOfSlots) && table->isLabelDefined[label])
+		{
+			CalibrationParameters	parameters = *nominalParameters;
+
+			for (size_t p = 0; p < kCalibrationParameterIndexMax; p++)
+			{
+				if (!isnan(table->parameterOverrides[label][p]))
+				{
+					parameters.values[p] = table->parameterOverrides[label][p];
+				}
+			}
+
+			context->hasExplicitParameters = false;
+			calibrationContextUpdate(context, &parameters);
+			if (!isfinite(context->countsGain) || !isfinite(context->countsOffset))
+			{
+				fprintf(stderr, "Error: Material %d does not give a finite conversion.\n", (int) label);
+
+				return kCommonConstantReturnTypeError;
+			}
+		}
+		else
+		{
+			/*
+			 *	Labels the table does not define keep the calibration, as do the slots
+			 *	past the map's, which the permuting kernels load but never index.
+			 */
+			*context = baseContext;
+		}
+
+		table->countsGains[slot] = context->countsGain;
+		table->countsOffsets[slot] = context->countsOffset;
+	}
+	table->numberOfSlots = map->numberOfSlots;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Renumbers the labels of `map->slots` in place into dense slots, in ascending label order.
+ */
+static void
+materialMapAssignSlots(MaterialMap *  map)
+{
+	size_t	numberOfPixels = (size_t) map->width * map->height;
+	bool	isLabelUsed[kMaterialMapMaximumLabels] = {false};
+	uint8_t	labelSlots[kMaterialMapMaximumLabels] = {0};
+
+	for (size_t i = 0; i < numberOfPixels; i++)
+	{
+		isLabelUsed[map->slots[i]] = true;
+	}
+
+	map->numberOfSlots = 0;
+	memset(map->slotLabels, 0, sizeof(map->slotLabels));
+	for (size_t label = 0; label < kMaterialMapMaximumLabels; label++)
+	{
+		if (isLabelUsed[label])
+		{
+			labelSlots[label] = (uint8_t) map->numberOfSlots;
+			map->slotLabels[map->numberOfSlots++] = (uint8_t) label;
+		}
+	}
+
+	for (size_t i = 0; i < numberOfPixels; i++)
+	{
+		map->slots[i] = labelSlots[map->slots[i]];
+	}
+
+	return;
+}
+
+void
+materialMapInit(MaterialMap *  map, const uint8_t *  labels, uint32_t width, uint32_t height)
+{
+	map->width = width;
+	map->height = height;
+	map->slots = (uint8_t *) checkedMalloc((size_t) width * height, __FILE__, __LINE__);
+	memcpy(map->slots, labels, (size_t) width * height);
+	materialMapAssignSlots(map);
+
+	return;
+}
+
+CommonConstantReturnType
+materialMapLoad(MaterialMap *  map, const char *  path)
+{
+	FILE *			inputFile;
+	RawFrameFileHeader	header;
+	size_t			numberOfPixels;
+
+	map->width = 0;
+	map->height = 0;
+	map->slots = NULL;
+	map->numberOfSlots = 0;
+
+	if (!rawFrameHostIsLittleEndian())
+	{
+		fprintf(stderr, "Error: Material map files can only be read on little-endian hosts.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	inputFile = fopen(path, "rb");
+	if (inputFile == NULL)
+	{
+		fprintf(stderr, "Error: Could not open material map file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((fread(&header, sizeof(header), 1, inputFile) != 1) ||
+		(header.magic != kRawMaterialMapFileMagic) || (header.width == 0) || (header.height == 0) || (header.frameCount != 1))
+	{
+		fprintf(stderr, "Error: \"%s\" is not a material map file (bad header).\n", path);
+		fclose(inputFile);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	numberOfPixels = (size_t) header.width * header.height;
+	map->slots = (uint8_t *) checkedMalloc(numberOfPixels, __FILE__, __LINE__);
+	if (fread(map->slots, 1, numberOfPixels, inputFile) != numberOfPixels)
+	{
+		fprintf(stderr, "Error: Material map file \"%s\" is shorter than its %" PRIu32 "x%" PRIu32 " labels.\n", path, header.width, header.height);
+		fclose(inputFile);
+		materialMapFree(map);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	fclose(inputFile);
+	map->width = header.width;
+	map->height = header.height;
+	materialMapAssignSlots(map);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+materialMapFree(MaterialMap *  map)
+{
+	free(map->slots);
+	map->slots = NULL;
+
+	return;
+}
@@ -0,0 +1,168 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "calibration.h"
+
+/*
+ *	Materials of a scene. A material map labels every pixel of the frame with
+ *	a uint8 material, and a material table gives each label its own scene
+ *	parameters (emissivity, atmospheric transmission, reflected and atmospheric
+ *	temperatures). Labels the table does not define keep the parameters of the
+ *	calibration. The table file has one line per label, `#` starting a comment:
+ *
+ *		1	Emiss 0.95
+ *		2	Emiss 0.80	Tau 0.98	TRefl 25.0
+ *
+ *	The camera constants (R, B, F, J0, J1) are the same for every label, so a
+ *	label only changes the folded count terms, `countsGain` and `countsOffset`.
+ *	A map's labels are renumbered, when it is loaded, into dense slots in
+ *	ascending label order, so that a table holds one context per label the map
+ *	uses and a scene of at most `kMaterialMapMaximumPermutedSlots` materials
+ *	keeps its count terms in registers.
+ */
+typedef enum
+{
+	kMaterialMapMaximumLabels	= 256,
+	kMaterialMapMaximumLineLength	= 512,
+	/*
+	 *	Slots whose count terms fit two AVX-512 registers, which a permute
+	 *	indexes without a memory access.
+	 */
+	kMaterialMapMaximumPermutedSlots	= 16,
+} MaterialMapConstant;
+
+typedef struct
+{
+	/*
+	 *	The parameters each defined label sets, NaN for those it leaves to the calibration.
+	 */
+	double			parameterOverrides[kMaterialMapMaximumLabels][kCalibrationParameterIndexMax];
+	bool			isLabelDefined[kMaterialMapMaximumLabels];
+	size_t			numberOfDefinedLabels;
+	/*
+	 *	Built by `materialTableBuild()` for the slots of a map: the context of each slot,
+	 *	and its count terms in arrays of their own, which the frame kernels index per pixel.
+	 */
+	size_t			numberOfSlots;
+	CalibrationContext	contexts[kMaterialMapMaximumLabels];
+	double			countsGains[kMaterialMapMaximumLabels];
+	double			countsOffsets[kMaterialMapMaximumLabels];
+} MaterialTable;
+
+typedef struct
+{
+	uint32_t	width;
+	uint32_t	height;
+	/*
+	 *	The slot of every pixel, row by row, and the label of every slot.
+	 */
+	uint8_t *	slots;
+	uint8_t		slotLabels[kMaterialMapMaximumLabels];
+	size_t		numberOfSlots;
+} MaterialMap;
+
+/**
+ *	@brief  Initializes a material table with no defined labels.
+ *
+ *	@param  table		: Pointer to the table.
+ */
+void	materialTableInit(MaterialTable *  table);
+
+/**
+ *	@brief  Sets a scene parameter of a label. Only Emiss, TRefl, TAtmC and Tau vary between
+ *		materials.
+ *
+ *	@param  table		: Pointer to the table.
+ *	@param  label		: The label.
+ *	@param  parameterIndex	: The parameter.
+ *	@param  value		: The value of the parameter for the label.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	materialTableSetParameter(
+					MaterialTable *			table,
+					uint8_t				label,
+					CalibrationParameterIndex	parameterIndex,
+					double				value);
+
+/**
+ *	@brief  Loads the labels of a material table file.
+ *
+ *	@param  table		: Pointer to the table to load.
+ *	@param  path		: Path of the material table file.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	materialTableLoad(MaterialTable *  table, const char *  path);
+
+/**
+ *	@brief  Builds the context of every slot of a map from a calibration. The pow() terms are
+ *		evaluated once per label that the map uses and the table defines.
+ *
+ *	@param  table			: Pointer to the table.
+ *	@param  map			: The map whose slots to build.
+ *	@param  nominalParameters	: The calibration the labels start from.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError` if a label's conversion is not finite.
+ */
+CommonConstantReturnType	materialTableBuild(
+					MaterialTable *			table,
+					const MaterialMap *		map,
+					const CalibrationParameters *	nominalParameters);
+
+/**
+ *	@brief  Initializes a material map from the labels of its pixels.
+ *
+ *	@param  map		: Pointer to the map to initialize. Free with `materialMapFree()`.
+ *	@param  labels		: The label of every pixel, `width * height` values row by row.
+ *	@param  width		: Map width in pixels.
+ *	@param  height		: Map height in pixels.
+ */
+void	materialMapInit(MaterialMap *  map, const uint8_t *  labels, uint32_t width, uint32_t height);
+
+/**
+ *	@brief  Reads a material map file: a raw frame file header with the magic "FAXL" and a frame
+ *		count of 1, followed by `width * height` uint8 labels, row by row.
+ *
+ *	@param  map		: Pointer to the map to read. Free with `materialMapFree()`.
+ *	@param  path		: Path of the material map file.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	materialMapLoad(MaterialMap *  map, const char *  path);
+
+/**
+ *	@brief  Frees the slots of a material map.
+ *
+ *	@param  map		: Pointer to the map.
+ */
+void	materialMapFree(MaterialMap *  map);
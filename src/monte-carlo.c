@@ -0,0 +1,793 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "utilities-config.h"
+#include "calibration.h"
+#include "random.h"
+#include "quasi-random.h"
+#include "conversion.h"
+#include "streaming-statistics.h"
+#include "instrumentation.h"
+#include "timing.h"
+#include "monte-carlo.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#define kMonteCarloHaveThreads	(1)
+#include <pthread.h>
+#include <unistd.h>
+#else
+#define kMonteCarloHaveThreads	(0)
+#endif
+
+typedef struct
+{
+	const MonteCarloConfiguration *	configuration;
+	size_t				firstIteration;
+	size_t				numberOfIterations;
+	/*
+	 *	Exactly one of `samples` and `statistics` is non-NULL.
+	 */
+	double *			samples;
+	StreamingStatistics *		statistics;
+	/*
+	 *	Frame runs only: the frame, this thread's per-pixel running means and
+	 *	sums of squared deviations, and a frame of scratch temperatures, of which
+	 *	only the one of the configured precision is allocated.
+	 */
+	const MonteCarloFrame *		frame;
+	double *			pixelMeans;
+	double *			pixelSumsOfSquaredDeviations;
+	double *			temperatures;
+	float *				temperaturesFloat32;
+	StreamingStatistics *		frameMeans;
+	/*
+	 *	Frame runs with exceedance thresholds only: this thread's count of
+	 *	iterations in which each pixel exceeded each threshold.
+	 */
+	const double *			exceedanceThresholds;
+	size_t				numberOfExceedanceThresholds;
+	uint64_t *			pixelExceedanceCounts;
+	/*
+	 *	This thread's stage counters, merged into the process counters after the join.
+	 */
+	InstrumentationCounters		instrumentation;
+} MonteCarloWorkItem;
+
+typedef enum
+{
+	/*
+	 *	Samples are buffered in chunks of this size before being added to
+	 *	streaming statistics.
+	 */
+	kMonteCarloStreamingChunkSize	= 4096,
+	/*
+	 *	Iterations whose uniforms are generated together by `counterBasedUniformsBlock()`.
+	 */
+	kMonteCarloUniformsBlockSize	= 256,
+} MonteCarloWorkerConstant;
+
+void
+monteCarloConfigurationSetDefaults(MonteCarloConfiguration *  configuration)
+{
+	configuration->seed = kMonteCarloDefaultSeed;
+	configuration->numberOfThreads = kMonteCarloDefaultNumberOfThreads;
+	calibrationParametersSetNominal(&configuration->nominalParameters);
+	calibrationParametersSetHalfWidths(&configuration->parameterHalfWidths);
+	configuration->countsLow = kDefaultInputDistributionIndexSensorCountsDistLow;
+	configuration->countsHigh = kDefaultInputDistributionIndexSensorCountsDistHigh;
+	configuration->samplingMethod = kMonteCarloSamplingMethodPseudoRandom;
+	configuration->numberOfDesignPoints = 0;
+	configuration->precision = kConversionPrecisionFloat64;
+
+	return;
+}
+
+const char *
+monteCarloGetSamplingMethodName(MonteCarloSamplingMethod samplingMethod)
+{
+	switch (samplingMethod)
+	{
+		case kMonteCarloSamplingMethodPseudoRandom:
+			return "pseudo-random";
+		case kMonteCarloSamplingMethodSobol:
+			return "Sobol";
+		case kMonteCarloSamplingMethodLatinHypercube:
+			return "Latin hypercube";
+		default:
+			return "unknown";
+	}
+}
+
+/*
+ *	The Sobol sequence and the Latin hypercube index their points with 32 bits, and
+ *	a Latin hypercube only has the points of its design.
+ */
+static CommonConstantReturnType
+monteCarloCheckIterationRange(const MonteCarloConfiguration *  configuration, size_t firstIteration, size_t numberOfIterations)
+{
+	size_t	lastIteration = firstIteration + numberOfIterations;
+
+	if ((configuration->samplingMethod == kMonteCarloSamplingMethodSobol) && (lastIteration > kQuasiRandomMaximumPoints))
+	{
+		fprintf(stderr, "Error: Sobol sampling supports at most %u iterations.\n", (unsigned) kQuasiRandomMaximumPoints);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((configuration->samplingMethod == kMonteCarloSamplingMethodLatinHypercube) &&
+		((lastIteration > configuration->numberOfDesignPoints) || (configuration->numberOfDesignPoints > kQuasiRandomMaximumPoints)))
+	{
+		fprintf(stderr, "Error: Iterations beyond the %zu points of the Latin hypercube design.\n", configuration->numberOfDesignPoints);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Generates the uniforms of consecutive iterations, dimension-major, with the
+ *	configured sampling method.
+ */
+static void
+monteCarloGenerateUniforms(
+	const MonteCarloConfiguration *	configuration,
+	size_t				firstIteration,
+	size_t				numberOfIterations,
+	double *			uniforms)
+{
+	switch (configuration->samplingMethod)
+	{
+		case kMonteCarloSamplingMethodSobol:
+			sobolUniformsBlock(configuration->seed, firstIteration, numberOfIterations, kMonteCarloDimensionIndexMax, uniforms);
+			break;
+		case kMonteCarloSamplingMethodLatinHypercube:
+			latinHypercubeUniformsBlock(
+				configuration->seed,
+				configuration->numberOfDesignPoints,
+				firstIteration,
+				numberOfIterations,
+				kMonteCarloDimensionIndexMax,
+				uniforms);
+			break;
+		default:
+			counterBasedUniformsBlock(configuration->seed, firstIteration, numberOfIterations, kMonteCarloDimensionIndexMax, uniforms);
+			break;
+	}
+
+	return;
+}
+
+size_t
+monteCarloResolveNumberOfThreads(size_t requestedNumberOfThreads)
+{
+#if kMonteCarloHaveThreads
+	if (requestedNumberOfThreads == 0)
+	{
+		long	onlineProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+
+		return (onlineProcessors > 0) ? (size_t) onlineProcessors : 1;
+	}
+
+	return requestedNumberOfThreads;
+#else
+	(void) requestedNumberOfThreads;
+
+	return 1;
+#endif
+}
+
+/*
+ *	Maps the uniforms of one iteration, `uniformsStride` apart, to its calibration
+ *	parameters and `counts`.
+ */
+static void
+monteCarloMapUniforms(
+	const MonteCarloConfiguration *	configuration,
+	const double *			uniforms,
+	size_t				uniformsStride,
+	CalibrationParameters *		parameters,
+	double *			counts)
+{
+	/*
+	 *	Map each uniform to its parameter's interval [nominal - halfWidth, nominal + halfWidth).
+	 */
+	for (size_t p = 0; p < kCalibrationParameterIndexMax; p++)
+	{
+		parameters->values[p] =	configuration->nominalParameters.values[p] +
+					configuration->parameterHalfWidths.values[p] * (2 * uniforms[p * uniformsStride] - 1);
+	}
+
+	*counts =	configuration->countsLow +
+			(configuration->countsHigh - configuration->countsLow) * uniforms[kMonteCarloDimensionIndexCounts * uniformsStride];
+
+	return;
+}
+
+/*
+ *	Draws the calibration parameters and `counts` of one iteration from its
+ *	Philox stream, or from its point of the quasi-random design.
+ */
+static void
+monteCarloSampleIteration(
+	const MonteCarloConfiguration *	configuration,
+	size_t				iteration,
+	CalibrationParameters *		parameters,
+	double *			counts)
+{
+	double	uniforms[kMonteCarloDimensionIndexMax];
+
+	if (configuration->samplingMethod == kMonteCarloSamplingMethodPseudoRandom)
+	{
+		counterBasedUniforms(configuration->seed, iteration, kMonteCarloDimensionIndexMax, uniforms);
+	}
+	else
+	{
+		monteCarloGenerateUniforms(configuration, iteration, 1, uniforms);
+	}
+
+	monteCarloMapUniforms(configuration, uniforms, 1, parameters, counts);
+
+	return;
+}
+
+/*
+ *	One parameter draw per iteration, applied to every pixel of the frame by
+ *	the frame kernel. The `counts` draw of the iteration is not used: each
+ *	pixel keeps its measured count.
+ */
+static void
+monteCarloFrameWorker(MonteCarloWorkItem *  workItem)
+{
+	const MonteCarloConfiguration *	configuration = workItem->configuration;
+	const MonteCarloFrame *		frame = workItem->frame;
+	size_t				pixelsPerFrame = frame->width * frame->height;
+	CalibrationContext		context = {0};
+	CalibrationParameters		parameters;
+	double				unusedCounts;
+
+	InstrumentationCounters *	instrumentation = &workItem->instrumentation;
+
+	for (size_t i = 0; i < workItem->numberOfIterations; i++)
+	{
+		double	inverseCount = 1.0 / (double) (i + 1);
+		double	frameSum = 0;
+		double	frameMean;
+		double	stageStart;
+
+		stageStart = instrumentationNow();
+		monteCarloSampleIteration(configuration, workItem->firstIteration + i, &parameters, &unusedCounts);
+		instrumentationStop(instrumentation, kInstrumentationStageInputSampling, 1, stageStart);
+
+		stageStart = instrumentationNow();
+		calibrationContextUpdate(&context, &parameters);
+		instrumentationStop(instrumentation, kInstrumentationStageRadianceTerms, 1, stageStart);
+
+		stageStart = instrumentationNow();
+		if (configuration->precision == kConversionPrecisionFloat32)
+		{
+			convertRawCountsFrameToTemperatureFloat32(
+				&context,
+				frame->rawCounts,
+				frame->width,
+				frame->height,
+				frame->strideInPixels,
+				workItem->temperaturesFloat32);
+		}
+		else
+		{
+			convertRawCountsFrameToTemperatureVectorized(
+				&context,
+				frame->rawCounts,
+				frame->width,
+				frame->height,
+				frame->strideInPixels,
+				workItem->temperatures);
+		}
+		instrumentationStop(instrumentation, kInstrumentationStageLogarithm, pixelsPerFrame, stageStart);
+		stageStart = instrumentationNow();
+
+		/*
+		 *	Welford's update, swept over the frame.
+		 */
+		for (size_t pixel = 0; pixel < pixelsPerFrame; pixel++)
+		{
+			double	temperature = (workItem->temperaturesFloat32 != NULL) ? workItem->temperaturesFloat32[pixel] : workItem->temperatures[pixel];
+			double	delta = temperature - workItem->pixelMeans[pixel];
+
+			workItem->pixelMeans[pixel] += delta * inverseCount;
+			workItem->pixelSumsOfSquaredDeviations[pixel] += delta * (temperature - workItem->pixelMeans[pixel]);
+			frameSum += temperature;
+
+			for (size_t k = 0; k < workItem->numberOfExceedanceThresholds; k++)
+			{
+				workItem->pixelExceedanceCounts[k * pixelsPerFrame + pixel] += (temperature > workItem->exceedanceThresholds[k]);
+			}
+		}
+
+		frameMean = frameSum / pixelsPerFrame;
+		streamingStatisticsAdd(workItem->frameMeans, &frameMean, 1);
+		instrumentationStop(instrumentation, kInstrumentationStageStatistics, pixelsPerFrame, stageStart);
+	}
+
+	return;
+}
+
+static void *
+monteCarloWorker(void *  argument)
+{
+	MonteCarloWorkItem *		workItem = (MonteCarloWorkItem *) argument;
+	const MonteCarloConfiguration *	configuration = workItem->configuration;
+	CalibrationContext		context = {0};
+	double				chunk[kMonteCarloStreamingChunkSize];
+	size_t				chunkSize = 0;
+	double				uniforms[kMonteCarloDimensionIndexMax * kMonteCarloUniformsBlockSize];
+	size_t				blockSize = 0;
+	InstrumentationCounters *	instrumentation = &workItem->instrumentation;
+
+	if (workItem->frame != NULL)
+	{
+		monteCarloFrameWorker(workItem);
+
+		return NULL;
+	}
+
+	for (size_t i = 0; i < workItem->numberOfIterations; i++)
+	{
+		CalibrationParameters	parameters;
+		double			counts;
+		double			sample;
+		bool			isTimed = instrumentationIsSampledIteration(i);
+		double			radianceTermsStart;
+		double			logarithmStart;
+
+		/*
+		 *	The uniforms of the next block of iterations are generated together,
+		 *	with the same values as per-iteration generation.
+		 */
+		if (i % kMonteCarloUniformsBlockSize == 0)
+		{
+			double	samplingStart = instrumentationNow();
+
+			blockSize = workItem->numberOfIterations - i;
+			if (blockSize > kMonteCarloUniformsBlockSize)
+			{
+				blockSize = kMonteCarloUniformsBlockSize;
+			}
+
+			monteCarloGenerateUniforms(configuration, workItem->firstIteration + i, blockSize, uniforms);
+			instrumentationStop(instrumentation, kInstrumentationStageInputSampling, blockSize, samplingStart);
+		}
+
+		monteCarloMapUniforms(configuration, &uniforms[i % kMonteCarloUniformsBlockSize], blockSize, &parameters, &counts);
+
+		radianceTermsStart = isTimed ? instrumentationNow() : 0;
+		calibrationContextUpdate(&context, &parameters);
+		logarithmStart = isTimed ? instrumentationNow() : 0;
+		sample = calibrationContextConvertCounts(&context, counts);
+
+		if (isTimed)
+		{
+			instrumentationAddTime(instrumentation, kInstrumentationStageRadianceTerms, 1, logarithmStart - radianceTermsStart);
+			instrumentationAddTime(instrumentation, kInstrumentationStageLogarithm, 1, instrumentationNow() - logarithmStart);
+		}
+
+		if (workItem->samples != NULL)
+		{
+			workItem->samples[i] = sample;
+
+			continue;
+		}
+
+		chunk[chunkSize++] = sample;
+		if (chunkSize == kMonteCarloStreamingChunkSize)
+		{
+			double	statisticsStart = instrumentationNow();
+
+			streamingStatisticsAdd(workItem->statistics, chunk, chunkSize);
+			instrumentationStop(instrumentation, kInstrumentationStageStatistics, chunkSize, statisticsStart);
+			chunkSize = 0;
+		}
+	}
+
+	instrumentationAddCalls(instrumentation, kInstrumentationStageRadianceTerms, workItem->numberOfIterations);
+	instrumentationAddCalls(instrumentation, kInstrumentationStageLogarithm, workItem->numberOfIterations);
+
+	if (workItem->statistics != NULL)
+	{
+		double	statisticsStart = instrumentationNow();
+
+		streamingStatisticsAdd(workItem->statistics, chunk, chunkSize);
+		instrumentationStop(instrumentation, kInstrumentationStageStatistics, chunkSize, statisticsStart);
+	}
+
+	return NULL;
+}
+
+/*
+ *	Adds the stage counters of every work item to the process counters.
+ */
+static void
+monteCarloMergeInstrumentation(const MonteCarloWorkItem *  workItems, size_t numberOfThreads)
+{
+	for (size_t t = 0; (t < numberOfThreads) && kInstrumentationEnabled; t++)
+	{
+		instrumentationMerge(instrumentationGetProcessCounters(), &workItems[t].instrumentation);
+	}
+
+	return;
+}
+
+/*
+ *	Runs the work items, one per thread, with the calling thread taking the first.
+ */
+static CommonConstantReturnType
+monteCarloRunWorkItems(MonteCarloWorkItem *  workItems, size_t numberOfThreads)
+{
+#if kMonteCarloHaveThreads
+	if (numberOfThreads > 1)
+	{
+		pthread_t *	threads = (pthread_t *) checkedMalloc(numberOfThreads * sizeof(pthread_t), __FILE__, __LINE__);
+		size_t		numberOfStartedThreads = 0;
+		bool		failed = false;
+
+		for (size_t t = 1; t < numberOfThreads; t++)
+		{
+			if (pthread_create(&threads[t], NULL, monteCarloWorker, &workItems[t]) != 0)
+			{
+				fprintf(stderr, "Error: Could not create Monte Carlo worker thread %zu.\n", t);
+				failed = true;
+
+				break;
+			}
+
+			numberOfStartedThreads++;
+		}
+
+		if (!failed)
+		{
+			monteCarloWorker(&workItems[0]);
+		}
+
+		for (size_t t = 1; t <= numberOfStartedThreads; t++)
+		{
+			pthread_join(threads[t], NULL);
+		}
+
+		free(threads);
+		monteCarloMergeInstrumentation(workItems, numberOfThreads);
+
+		return failed ? kCommonConstantReturnTypeError : kCommonConstantReturnTypeSuccess;
+	}
+#endif
+
+	monteCarloWorker(&workItems[0]);
+	monteCarloMergeInstrumentation(workItems, numberOfThreads);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Splits the iterations into contiguous, disjoint slices, one per thread.
+ */
+static MonteCarloWorkItem *
+monteCarloCreateWorkItems(
+	const MonteCarloConfiguration *	configuration,
+	size_t				firstIteration,
+	size_t				numberOfIterations,
+	size_t *			numberOfThreads)
+{
+	MonteCarloWorkItem *	workItems;
+
+	*numberOfThreads = monteCarloResolveNumberOfThreads(configuration->numberOfThreads);
+	if (*numberOfThreads > numberOfIterations)
+	{
+		*numberOfThreads = (numberOfIterations > 0) ? numberOfIterations : 1;
+	}
+
+	workItems = (MonteCarloWorkItem *) checkedMalloc(*numberOfThreads * sizeof(MonteCarloWorkItem), __FILE__, __LINE__);
+
+	for (size_t t = 0; t < *numberOfThreads; t++)
+	{
+		size_t	begin = (numberOfIterations * t) / *numberOfThreads;
+		size_t	end = (numberOfIterations * (t + 1)) / *numberOfThreads;
+
+		workItems[t] = (MonteCarloWorkItem)
+		{
+			.configuration		= configuration,
+			.firstIteration		= firstIteration + begin,
+			.numberOfIterations	= end - begin,
+		};
+	}
+
+	return workItems;
+}
+
+CommonConstantReturnType
+monteCarloRun(
+	const MonteCarloConfiguration *	configuration,
+	size_t				firstIteration,
+	size_t				numberOfIterations,
+	double *			samples)
+{
+	size_t				numberOfThreads;
+	MonteCarloWorkItem *		workItems;
+	CommonConstantReturnType	result;
+
+	if (monteCarloCheckIterationRange(configuration, firstIteration, numberOfIterations) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	workItems = monteCarloCreateWorkItems(configuration, firstIteration, numberOfIterations, &numberOfThreads);
+
+	for (size_t t = 0; t < numberOfThreads; t++)
+	{
+		workItems[t].samples = &samples[workItems[t].firstIteration - firstIteration];
+	}
+
+	result = monteCarloRunWorkItems(workItems, numberOfThreads);
+	free(workItems);
+
+	return result;
+}
+
+CommonConstantReturnType
+monteCarloRunStreaming(
+	const MonteCarloConfiguration *	configuration,
+	size_t				firstIteration,
+	size_t				numberOfIterations,
+	StreamingStatistics *		statistics)
+{
+	size_t				numberOfThreads;
+	MonteCarloWorkItem *		workItems;
+	StreamingStatistics *		threadStatistics;
+	CommonConstantReturnType	result;
+
+	if (monteCarloCheckIterationRange(configuration, firstIteration, numberOfIterations) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	workItems = monteCarloCreateWorkItems(configuration, firstIteration, numberOfIterations, &numberOfThreads);
+
+	/*
+	 *	Every thread summarizes its own slice; the summaries are merged in
+	 *	thread order afterwards, so no locks are needed.
+	 */
+	threadStatistics = (StreamingStatistics *) checkedMalloc(numberOfThreads * sizeof(StreamingStatistics), __FILE__, __LINE__);
+	for (size_t t = 0; t < numberOfThreads; t++)
+	{
+		streamingStatisticsInit(&threadStatistics[t]);
+		workItems[t].statistics = &threadStatistics[t];
+	}
+
+	result = monteCarloRunWorkItems(workItems, numberOfThreads);
+
+	for (size_t t = 0; t < numberOfThreads; t++)
+	{
+		if (result == kCommonConstantReturnTypeSuccess)
+		{
+			streamingStatisticsMerge(statistics, &threadStatistics[t]);
+		}
+
+		streamingStatisticsFree(&threadStatistics[t]);
+	}
+
+	free(threadStatistics);
+	free(workItems);
+
+	return result;
+}
+
+CommonConstantReturnType
+monteCarloRunFrame(
+	const MonteCarloConfiguration *	configuration,
+	size_t				firstIteration,
+	size_t				numberOfIterations,
+	const MonteCarloFrame *		frame,
+	MonteCarloFrameResult *		result)
+{
+	size_t				numberOfThreads;
+	size_t				pixelsPerFrame = frame->width * frame->height;
+	size_t				numberOfExceedanceCounts = result->numberOfExceedanceThresholds * pixelsPerFrame;
+	MonteCarloWorkItem *		workItems;
+	StreamingStatistics *		threadFrameMeans;
+	double *			pixelSumsOfSquaredDeviations;
+	double				mergedCount = 0;
+	CommonConstantReturnType	ret;
+
+	if (frame->strideInPixels < frame->width)
+	{
+		fprintf(stderr, "Error: Frame stride (%zu pixels) is smaller than the frame width (%zu pixels).\n", frame->strideInPixels, frame->width);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (monteCarloCheckIterationRange(configuration, firstIteration, numberOfIterations) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	workItems = monteCarloCreateWorkItems(configuration, firstIteration, numberOfIterations, &numberOfThreads);
+	threadFrameMeans = (StreamingStatistics *) checkedMalloc(numberOfThreads * sizeof(StreamingStatistics), __FILE__, __LINE__);
+
+	for (size_t t = 0; t < numberOfThreads; t++)
+	{
+		workItems[t].frame = frame;
+		workItems[t].pixelMeans = (double *) checkedMalloc(pixelsPerFrame * sizeof(double), __FILE__, __LINE__);
+		workItems[t].pixelSumsOfSquaredDeviations = (double *) checkedMalloc(pixelsPerFrame * sizeof(double), __FILE__, __LINE__);
+		if (configuration->precision == kConversionPrecisionFloat32)
+		{
+			workItems[t].temperaturesFloat32 = (float *) checkedMalloc(pixelsPerFrame * sizeof(float), __FILE__, __LINE__);
+		}
+		else
+		{
+			workItems[t].temperatures = (double *) checkedMalloc(pixelsPerFrame * sizeof(double), __FILE__, __LINE__);
+		}
+		workItems[t].frameMeans = &threadFrameMeans[t];
+		workItems[t].exceedanceThresholds = result->exceedanceThresholds;
+		workItems[t].numberOfExceedanceThresholds = result->numberOfExceedanceThresholds;
+		workItems[t].pixelExceedanceCounts = (uint64_t *) checkedMalloc((numberOfExceedanceCounts + 1) * sizeof(uint64_t), __FILE__, __LINE__);
+		memset(workItems[t].pixelMeans, 0, pixelsPerFrame * sizeof(double));
+		memset(workItems[t].pixelSumsOfSquaredDeviations, 0, pixelsPerFrame * sizeof(double));
+		memset(workItems[t].pixelExceedanceCounts, 0, numberOfExceedanceCounts * sizeof(uint64_t));
+		streamingStatisticsInit(&threadFrameMeans[t]);
+	}
+
+	ret = monteCarloRunWorkItems(workItems, numberOfThreads);
+
+	/*
+	 *	Merge the per-thread accumulators in thread order (Chan et al.), reusing
+	 *	the first thread's arrays.
+	 */
+	pixelSumsOfSquaredDeviations = workItems[0].pixelSumsOfSquaredDeviations;
+	mergedCount = (double) workItems[0].numberOfIterations;
+	for (size_t t = 1; (t < numberOfThreads) && (ret == kCommonConstantReturnTypeSuccess); t++)
+	{
+		double	threadCount = (double) workItems[t].numberOfIterations;
+		double	totalCount = mergedCount + threadCount;
+
+		for (size_t pixel = 0; pixel < pixelsPerFrame; pixel++)
+		{
+			double	delta = workItems[t].pixelMeans[pixel] - workItems[0].pixelMeans[pixel];
+
+			workItems[0].pixelMeans[pixel] += delta * threadCount / totalCount;
+			pixelSumsOfSquaredDeviations[pixel] +=	workItems[t].pixelSumsOfSquaredDeviations[pixel] +
+								delta * delta * mergedCount * threadCount / totalCount;
+		}
+
+		for (size_t i = 0; i < numberOfExceedanceCounts; i++)
+		{
+			workItems[0].pixelExceedanceCounts[i] += workItems[t].pixelExceedanceCounts[i];
+		}
+
+		mergedCount = totalCount;
+	}
+
+	if (ret == kCommonConstantReturnTypeSuccess)
+	{
+		for (size_t pixel = 0; pixel < pixelsPerFrame; pixel++)
+		{
+			result->pixelMeans[pixel] = workItems[0].pixelMeans[pixel];
+			result->pixelStandardDeviations[pixel] = (mergedCount > 1) ? sqrt(pixelSumsOfSquaredDeviations[pixel] / (mergedCount - 1)) : 0;
+		}
+
+		for (size_t i = 0; i < numberOfExceedanceCounts; i++)
+		{
+			result->pixelExceedanceProbabilities[i] = (mergedCount > 0) ? workItems[0].pixelExceedanceCounts[i] / mergedCount : NAN;
+		}
+	}
+
+	for (size_t t = 0; t < numberOfThreads; t++)
+	{
+		if (ret == kCommonConstantReturnTypeSuccess)
+		{
+			streamingStatisticsMerge(&result->frameMeans, &threadFrameMeans[t]);
+		}
+
+		streamingStatisticsFree(&threadFrameMeans[t]);
+		free(workItems[t].pixelExceedanceCounts);
+		free(workItems[t].temperatures);
+		free(workItems[t].temperaturesFloat32);
+		free(workItems[t].pixelSumsOfSquaredDeviations);
+		free(workItems[t].pixelMeans);
+	}
+
+	free(threadFrameMeans);
+	free(workItems);
+
+	return ret;
+}
+
+CommonConstantReturnType
+monteCarloCompareSamplingMethods(
+	const MonteCarloConfiguration *	configuration,
+	size_t				numberOfIterations,
+	MonteCarloSamplingComparison *	comparison)
+{
+	MonteCarloConfiguration	replicationConfiguration = *configuration;
+	size_t			numberOfReplications = kMonteCarloSamplingComparisonReplications;
+
+	comparison->numberOfIterations = numberOfIterations;
+	comparison->numberOfReplications = numberOfReplications;
+	replicationConfiguration.numberOfDesignPoints = numberOfIterations;
+
+	for (int method = 0; method < kMonteCarloSamplingMethodMax; method++)
+	{
+		MonteCarloSamplingMethodSummary *	summary = &comparison->methods[method];
+		double					sumOfSquaredMeanDeviations = 0;
+		double					sumOfSquaredStandardDeviationDeviations = 0;
+		double					start = getMonotonicTimeInSeconds();
+
+		*summary = (MonteCarloSamplingMethodSummary){0};
+		replicationConfiguration.samplingMethod = (MonteCarloSamplingMethod) method;
+
+		/*
+		 *	Welford updates of the mean and standard deviation over the replications.
+		 */
+		for (size_t r = 0; r < numberOfReplications; r++)
+		{
+			StreamingStatistics	statistics;
+			double			mean;
+			double			standardDeviation;
+			double			meanDelta;
+			double			standardDeviationDelta;
+
+			replicationConfiguration.seed = configuration->seed + r;
+			streamingStatisticsInit(&statistics);
+
+			if (monteCarloRunStreaming(&replicationConfiguration, 0, numberOfIterations, &statistics) != kCommonConstantReturnTypeSuccess)
+			{
+				streamingStatisticsFree(&statistics);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			mean = statistics.moments.mean;
+			standardDeviation = sqrt(streamingStatisticsVariance(&statistics));
+			streamingStatisticsFree(&statistics);
+
+			meanDelta = mean - summary->meanOfMeans;
+			summary->meanOfMeans += meanDelta / (r + 1);
+			sumOfSquaredMeanDeviations += meanDelta * (mean - summary->meanOfMeans);
+
+			standardDeviationDelta = standardDeviation - summary->meanOfStandardDeviations;
+			summary->meanOfStandardDeviations += standardDeviationDelta / (r + 1);
+			sumOfSquaredStandardDeviationDeviations += standardDeviationDelta * (standardDeviation - summary->meanOfStandardDeviations);
+		}
+
+		summary->seconds = (getMonotonicTimeInSeconds() - start) / numberOfReplications;
+		summary->meanStandardError = (numberOfReplications > 1) ? sqrt(sumOfSquaredMeanDeviations / (numberOfReplications - 1)) : 0;
+		summary->standardDeviationStandardError = (numberOfReplications > 1) ? sqrt(sumOfSquaredStandardDeviationDeviations / (numberOfReplications - 1)) : 0;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
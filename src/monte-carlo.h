@@ -0,0 +1,274 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "calibration.h"
+#include "conversion.h"
+#include "streaming-statistics.h"
+
+/*
+ *	Dimensions of one Monte Carlo iteration: one uniform variate per
+ *	calibration parameter, followed by one for the sensor counts.
+ */
+typedef enum
+{
+	kMonteCarloDimensionIndexCounts		= kCalibrationParameterIndexMax,
+	kMonteCarloDimensionIndexMax,
+} MonteCarloDimensionIndex;
+
+typedef enum
+{
+	kMonteCarloDefaultSeed			= 0x5EED,
+	kMonteCarloDefaultNumberOfThreads	= 1,
+	/*
+	 *	Independently randomized runs of each sampling method in
+	 *	`monteCarloCompareSamplingMethods()`.
+	 */
+	kMonteCarloSamplingComparisonReplications	= 16,
+	/*
+	 *	Adaptive Monte Carlo: iterations of the first block, which are also the fewest
+	 *	of any later block, and the most quantiles that can be given a target.
+	 */
+	kMonteCarloAdaptiveInitialIterations	= 4096,
+	kMonteCarloAdaptiveMaximumQuantiles	= 16,
+} MonteCarloConstant;
+
+/*
+ *	The normal quantile of a two-sided 95% confidence interval.
+ */
+static const double	kMonteCarloAdaptiveConfidenceIntervalZ	= 1.959963984540054;
+
+/*
+ *	How the uniform variates of the iterations are generated.
+ */
+typedef enum
+{
+	/*
+	 *	Independent Philox uniforms; the error of the mean shrinks as 1/sqrt(N).
+	 */
+	kMonteCarloSamplingMethodPseudoRandom	= 0,
+	/*
+	 *	An Owen-scrambled Sobol sequence.
+	 */
+	kMonteCarloSamplingMethodSobol,
+	/*
+	 *	A randomized Latin hypercube of `numberOfDesignPoints` points.
+	 */
+	kMonteCarloSamplingMethodLatinHypercube,
+	kMonteCarloSamplingMethodMax,
+} MonteCarloSamplingMethod;
+
+typedef struct
+{
+	uint64_t		seed;
+	/*
+	 *	Zero selects the number of online processors.
+	 */
+	size_t			numberOfThreads;
+	CalibrationParameters	nominalParameters;
+	CalibrationParameters	parameterHalfWidths;
+	double			countsLow;
+	double			countsHigh;
+	MonteCarloSamplingMethod	samplingMethod;
+	/*
+	 *	Latin hypercube only: the number of points of the design. Every run must stay
+	 *	within iterations [0, `numberOfDesignPoints`).
+	 */
+	size_t			numberOfDesignPoints;
+	/*
+	 *	Frame runs only: precision of the per-iteration frame conversion. The
+	 *	per-pixel statistics are accumulated in float64 either way.
+	 */
+	ConversionPrecision	precision;
+} MonteCarloConfiguration;
+
+/*
+ *	A frame of raw counts for `monteCarloRunFrame()`.
+ */
+typedef struct
+{
+	const uint16_t *	rawCounts;
+	size_t			width;
+	size_t			height;
+	size_t			strideInPixels;
+} MonteCarloFrame;
+
+typedef struct
+{
+	/*
+	 *	Caller-allocated arrays of `width * height` values, written densely row by row.
+	 */
+	double *		pixelMeans;
+	double *		pixelStandardDeviations;
+	/*
+	 *	Initialized by the caller. Receives the spatial mean of the frame of every
+	 *	iteration, whose spread shows how much of the per-pixel error is common
+	 *	to the whole frame.
+	 */
+	StreamingStatistics	frameMeans;
+	/*
+	 *	Optional: `numberOfExceedanceThresholds` temperature thresholds, and a caller-allocated
+	 *	array of `numberOfExceedanceThresholds * width * height` values, one map per threshold,
+	 *	that receives the fraction of iterations in which each pixel exceeded each threshold.
+	 */
+	const double *		exceedanceThresholds;
+	size_t			numberOfExceedanceThresholds;
+	double *		pixelExceedanceProbabilities;
+} MonteCarloFrameResult;
+
+/*
+ *	The spread, over independently randomized replications, of the mean and standard
+ *	deviation estimated by one sampling method. For these unbiased estimators, the
+ *	standard errors are their root-mean-square errors.
+ */
+typedef struct
+{
+	double	meanOfMeans;
+	double	meanStandardError;
+	double	meanOfStandardDeviations;
+	double	standardDeviationStandardError;
+	double	seconds;
+} MonteCarloSamplingMethodSummary;
+
+typedef struct
+{
+	size_t				numberOfIterations;
+	size_t				numberOfReplications;
+	MonteCarloSamplingMethodSummary	methods[kMonteCarloSamplingMethodMax];
+} MonteCarloSamplingComparison;
+
+/**
+ *	@brief  Sets a Monte Carlo configuration to the `kFLIR*` calibration distributions, the
+ *		default `counts` distribution, the default seed and a single thread.
+ *
+ *	@param  configuration	: Pointer to the configuration to set.
+ */
+void	monteCarloConfigurationSetDefaults(MonteCarloConfiguration *  configuration);
+
+/**
+ *	@brief  Evaluates the sensor output for Monte Carlo iterations
+ *		[`firstIteration`, `firstIteration + numberOfIterations`), split across worker threads.
+ *
+ *		Every iteration draws each calibration parameter and `counts` exactly once, from a
+ *		Philox stream addressed by (`seed`, iteration), or from the point of the Sobol sequence
+ *		or Latin hypercube with that index. Each thread writes a disjoint slice of `samples`
+ *		without locks, so the results are bit-identical for any number of threads.
+ *
+ *	@param  configuration		: Pointer to the Monte Carlo configuration.
+ *	@param  firstIteration		: Index of the first iteration to evaluate.
+ *	@param  numberOfIterations	: Number of iterations to evaluate.
+ *	@param  samples			: Output array. `samples[i]` receives iteration `firstIteration + i`.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	monteCarloRun(
+					const MonteCarloConfiguration *	configuration,
+					size_t				firstIteration,
+					size_t				numberOfIterations,
+					double *			samples);
+
+/**
+ *	@brief  Like `monteCarloRun()`, but instead of storing the samples, adds them to `statistics`
+ *		in O(1) memory. Each thread accumulates its own statistics, which are merged in
+ *		thread order, so the results are reproducible for a given number of threads.
+ *
+ *	@param  configuration		: Pointer to the Monte Carlo configuration.
+ *	@param  firstIteration		: Index of the first iteration to evaluate.
+ *	@param  numberOfIterations	: Number of iterations to evaluate.
+ *	@param  statistics		: Pointer to initialized statistics that the samples are added to.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	monteCarloRunStreaming(
+					const MonteCarloConfiguration *	configuration,
+					size_t				firstIteration,
+					size_t				numberOfIterations,
+					StreamingStatistics *		statistics);
+
+/**
+ *	@brief  Evaluates a whole frame for Monte Carlo iterations
+ *		[`firstIteration`, `firstIteration + numberOfIterations`), with common random numbers:
+ *		every iteration draws the calibration parameters once, from the same stream as
+ *		`monteCarloRun()`, and applies them to every pixel with the vectorized frame kernel.
+ *		Pixels keep their measured counts, so the error of the result is spatially correlated
+ *		as it is for a single camera. Per-pixel means and standard deviations, and the counts of
+ *		iterations exceeding each threshold, are accumulated per thread in the same sweep over
+ *		the frame and merged in thread order, so the results are reproducible for a given
+ *		number of threads.
+ *
+ *	@param  configuration		: Pointer to the Monte Carlo configuration. `countsLow` and `countsHigh` are not used.
+ *	@param  firstIteration		: Index of the first iteration to evaluate.
+ *	@param  numberOfIterations	: Number of iterations to evaluate.
+ *	@param  frame			: Pointer to the frame of raw counts.
+ *	@param  result			: Pointer to the result to fill.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	monteCarloRunFrame(
+					const MonteCarloConfiguration *	configuration,
+					size_t				firstIteration,
+					size_t				numberOfIterations,
+					const MonteCarloFrame *		frame,
+					MonteCarloFrameResult *		result);
+
+/**
+ *	@brief  Runs `kMonteCarloSamplingComparisonReplications` replications of `numberOfIterations`
+ *		iterations with each sampling method, with seeds `configuration->seed` onwards, and
+ *		summarizes the spread of their means and standard deviations.
+ *
+ *	@param  configuration		: Pointer to the Monte Carlo configuration. The sampling method is ignored.
+ *	@param  numberOfIterations	: Number of iterations of each replication.
+ *	@param  comparison		: Pointer to the comparison to fill.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	monteCarloCompareSamplingMethods(
+					const MonteCarloConfiguration *	configuration,
+					size_t				numberOfIterations,
+					MonteCarloSamplingComparison *	comparison);
+
+/**
+ *	@brief  Returns the name of a sampling method, e.g., "Sobol".
+ *
+ *	@param  samplingMethod	: The sampling method.
+ *
+ *	@return			: The name.
+ */
+const char *	monteCarloGetSamplingMethodName(MonteCarloSamplingMethod samplingMethod);
+
+/**
+ *	@brief  Resolves a requested number of threads, mapping zero to the number of online
+ *		processors. Returns 1 on platforms without thread support.
+ *
+ *	@param  requestedNumberOfThreads	: The requested number of threads.
+ *
+ *	@return					: The number of threads to use.
+ */
+size_t	monteCarloResolveNumberOfThreads(size_t requestedNumberOfThreads);
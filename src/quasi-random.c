@@ -0,0 +1,287 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "random.h"
+#include "quasi-random.h"
+
+/*
+ *	A primitive polynomial of degree `degree` over GF(2), with the coefficients of
+ *	its inner terms as the bits of `coefficients`, and the initial direction numbers
+ *	m_1 ... m_degree of its Sobol dimension.
+ */
+typedef struct
+{
+	uint32_t	degree;
+	uint32_t	coefficients;
+	uint32_t	initialNumbers[6];
+} SobolPolynomial;
+
+/*
+ *	Joe and Kuo's new-joe-kuo-6.21201 parameters for dimensions 2 to 16. The first
+ *	dimension is the van der Corput sequence.
+ */
+static const SobolPolynomial	kSobolPolynomials[kQuasiRandomMaximumDimensions - 1] =
+{
+	{1,	0,	{1}},
+	{2,	1,	{1, 3}},
+	{3,	1,	{1, 3, 1}},
+	{3,	2,	{1, 1, 1}},
+	{4,	1,	{1, 1, 3, 3}},
+	{4,	4,	{1, 3, 5, 13}},
+	{5,	2,	{1, 1, 5, 5, 17}},
+	{5,	4,	{1, 1, 5, 5, 5}},
+	{5,	7,	{1, 1, 7, 11, 19}},
+	{5,	11,	{1, 1, 5, 1, 1}},
+	{5,	13,	{1, 1, 1, 3, 11}},
+	{5,	14,	{1, 3, 5, 5, 31}},
+	{6,	1,	{1, 3, 3, 9, 7, 49}},
+	{6,	13,	{1, 1, 1, 15, 21, 21}},
+	{6,	16,	{1, 3, 1, 13, 27, 49}},
+};
+
+enum
+{
+	kSobolBits	= 32,
+};
+
+/*
+ *	2^-32: scales a 32-bit integer to a double in [0, 1).
+ */
+static const double	kTwoPowMinus32		= 1.0 / 4294967296.0;
+
+/*
+ *	The largest double below 1.
+ */
+static const double	kOneMinusEpsilon	= 1.0 - 1.0 / 9007199254740992.0;
+
+/*
+ *	The direction numbers v_1 ... v_32 of a dimension, scaled to 32-bit fractions.
+ */
+static void
+sobolDirectionNumbers(size_t dimension, uint32_t directionNumbers[kSobolBits])
+{
+	const SobolPolynomial *	polynomial;
+	uint32_t		degree;
+
+	if (dimension == 0)
+	{
+		for (uint32_t i = 0; i < kSobolBits; i++)
+		{
+			directionNumbers[i] = 1U << (kSobolBits - 1 - i);
+		}
+
+		return;
+	}
+
+	polynomial = &kSobolPolynomials[dimension - 1];
+	degree = polynomial->degree;
+
+	for (uint32_t i = 0; i < degree; i++)
+	{
+		directionNumbers[i] = polynomial->initialNumbers[i] << (kSobolBits - 1 - i);
+	}
+
+	/*
+	 *	The recurrence of the primitive polynomial.
+	 */
+	for (uint32_t i = degree; i < kSobolBits; i++)
+	{
+		directionNumbers[i] = directionNumbers[i - degree] ^ (directionNumbers[i - degree] >> degree);
+
+		for (uint32_t k = 1; k < degree; k++)
+		{
+			if ((polynomial->coefficients >> (degree - 1 - k)) & 1)
+			{
+				directionNumbers[i] ^= directionNumbers[i - k];
+			}
+		}
+	}
+
+	return;
+}
+
+static inline uint32_t
+reverseBits32(uint32_t x)
+{
+	x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+	x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+	x = ((x >> 8) & 0x00FF00FF) | ((x & 0x00FF00FF) << 8);
+
+	return (x >> 16) | (x << 16);
+}
+
+/*
+ *	Owen scrambling: with the bits reversed, each step only carries lower bits into
+ *	higher ones, so every bit of the result is flipped by a hash of the bits above it.
+ */
+static inline uint32_t
+sobolNestedUniformScramble(uint32_t x, uint32_t key)
+{
+	x = reverseBits32(x);
+	x ^= x * 0x3D20ADEA;
+	x += key;
+	x *= (key >> 16) | 1;
+	x ^= x * 0x05526C56;
+	x ^= x * 0x53A22864;
+
+	return reverseBits32(x);
+}
+
+/*
+ *	A keyed pseudo-random permutation of [0, numberOfElements): a bijection on the
+ *	smallest enclosing power of two, applied until the result falls in range.
+ */
+static inline uint32_t
+latinHypercubePermute(uint32_t index, uint32_t numberOfElements, uint32_t key)
+{
+	uint32_t	mask = numberOfElements - 1;
+
+	mask |= mask >> 1;
+	mask |= mask >> 2;
+	mask |= mask >> 4;
+	mask |= mask >> 8;
+	mask |= mask >> 16;
+
+	do
+	{
+		index ^= key;
+		index *= 0xE170893D;
+		index ^= key >> 16;
+		index ^= (index & mask) >> 4;
+		index ^= key >> 8;
+		index *= 0x0929EB3F;
+		index ^= key >> 23;
+		index ^= (index & mask) >> 1;
+		index *= 1 | key >> 27;
+		index *= 0x6935FA69;
+		index ^= (index & mask) >> 11;
+		index *= 0x74DCB303;
+		index ^= (index & mask) >> 2;
+		index *= 0x9E501CC3;
+		index ^= (index & mask) >> 2;
+		index *= 0xC860A3DF;
+		index &= mask;
+		index ^= index >> 5;
+	} while (index >= numberOfElements);
+
+	return (uint32_t)(((uint64_t) index + key) % numberOfElements);
+}
+
+/*
+ *	The scrambling and permutation keys of a dimension. The fourth counter word is
+ *	1, so these Philox blocks are disjoint from those of the iteration streams.
+ */
+static void
+quasiRandomDimensionKeys(uint64_t seed, size_t dimension, uint32_t keys[4])
+{
+	uint32_t	key[2] = {(uint32_t) seed, (uint32_t)(seed >> 32)};
+	uint32_t	counter[4] = {(uint32_t) dimension, 0, 0, 1};
+
+	philox4x32x10(counter, key, keys);
+
+	return;
+}
+
+void
+sobolUniformsBlock(
+	uint64_t	seed,
+	uint64_t	firstIteration,
+	size_t		numberOfIterations,
+	size_t		numberOfDimensions,
+	double *	uniforms)
+{
+	for (size_t dimension = 0; dimension < numberOfDimensions; dimension++)
+	{
+		uint32_t	directionNumbers[kSobolBits];
+		uint32_t	keys[4];
+		uint32_t	index = (uint32_t) firstIteration;
+		uint32_t	point = 0;
+
+		sobolDirectionNumbers(dimension, directionNumbers);
+		quasiRandomDimensionKeys(seed, dimension, keys);
+
+		for (uint32_t bits = index, j = 0; bits != 0; bits >>= 1, j++)
+		{
+			if (bits & 1)
+			{
+				point ^= directionNumbers[j];
+			}
+		}
+
+		/*
+		 *	Consecutive points differ by the direction numbers of the bits that
+		 *	change from one index to the next, on average two.
+		 */
+		for (size_t i = 0; i < numberOfIterations; i++, index++)
+		{
+			uniforms[dimension * numberOfIterations + i] = sobolNestedUniformScramble(point, keys[0]) * kTwoPowMinus32;
+
+			for (uint32_t changedBits = index ^ (index + 1), j = 0; changedBits != 0; changedBits >>= 1, j++)
+			{
+				if (changedBits & 1)
+				{
+					point ^= directionNumbers[j];
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+void
+latinHypercubeUniformsBlock(
+	uint64_t	seed,
+	uint64_t	numberOfStrata,
+	uint64_t	firstIteration,
+	size_t		numberOfIterations,
+	size_t		numberOfDimensions,
+	double *	uniforms)
+{
+	double	inverseNumberOfStrata = 1.0 / (double) numberOfStrata;
+
+	/*
+	 *	The positions within the strata are the pseudo-random uniforms of the same iterations.
+	 */
+	counterBasedUniformsBlock(seed, firstIteration, numberOfIterations, numberOfDimensions, uniforms);
+
+	for (size_t dimension = 0; dimension < numberOfDimensions; dimension++)
+	{
+		uint32_t	keys[4];
+		double *	dimensionUniforms = &uniforms[dimension * numberOfIterations];
+
+		quasiRandomDimensionKeys(seed, dimension, keys);
+
+		for (size_t i = 0; i < numberOfIterations; i++)
+		{
+			uint32_t	stratum = latinHypercubePermute((uint32_t)(firstIteration + i), (uint32_t) numberOfStrata, keys[1]);
+			double		uniform = (stratum + dimensionUniforms[i]) * inverseNumberOfStrata;
+
+			dimensionUniforms[i] = (uniform < kOneMinusEpsilon) ? uniform : kOneMinusEpsilon;
+		}
+	}
+
+	return;
+}
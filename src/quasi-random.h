@@ -0,0 +1,83 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+	/*
+	 *	Dimensions with Sobol direction numbers (Joe and Kuo, "Constructing Sobol
+	 *	sequences with better two-dimensional projections", SIAM J. Sci. Comput., 2008).
+	 */
+	kQuasiRandomMaximumDimensions	= 16,
+	/*
+	 *	Points of the Sobol sequence, and strata of a Latin hypercube, are 32-bit indices.
+	 */
+	kQuasiRandomMaximumPoints	= 0xFFFFFFFF,
+} QuasiRandomConstant;
+
+/**
+ *	@brief  Generates points `firstIteration` to `firstIteration + numberOfIterations - 1` of an
+ *		Owen-scrambled Sobol sequence, as uniform variates in [0, 1). Each dimension is
+ *		scrambled with a hash-based nested uniform scramble (Burley, "Practical Hash-based
+ *		Owen Scrambling", JCGT, 2020) keyed by `seed`, so different seeds give independent
+ *		randomizations of the same low-discrepancy design, and any thread can generate any
+ *		range of points.
+ *
+ *	@param  seed			: The seed of the scrambling.
+ *	@param  firstIteration		: The first point.
+ *	@param  numberOfIterations	: The number of consecutive points.
+ *	@param  numberOfDimensions	: The number of dimensions, at most `kQuasiRandomMaximumDimensions`.
+ *	@param  uniforms		: The output array, dimension-major, as for `counterBasedUniformsBlock()`.
+ */
+void	sobolUniformsBlock(
+		uint64_t	seed,
+		uint64_t	firstIteration,
+		size_t		numberOfIterations,
+		size_t		numberOfDimensions,
+		double *	uniforms);
+
+/**
+ *	@brief  Generates points of a randomized Latin hypercube of `numberOfStrata` points: in every
+ *		dimension, each of the `numberOfStrata` equal strata of [0, 1) holds exactly one point.
+ *		The stratum of each point is a keyed pseudo-random permutation of its index, computed
+ *		directly for any index (Kensler, "Correlated Multi-Jittered Sampling", Pixar technical
+ *		memo 13-01, 2013), and its position within the stratum is the Philox uniform of
+ *		`counterBasedUniformsBlock()`.
+ *
+ *	@param  seed			: The seed of the permutations and of the positions within the strata.
+ *	@param  numberOfStrata		: The number of points of the whole design, at most `kQuasiRandomMaximumPoints`.
+ *	@param  firstIteration		: The first point, less than `numberOfStrata`.
+ *	@param  numberOfIterations	: The number of consecutive points, up to `numberOfStrata - firstIteration`.
+ *	@param  numberOfDimensions	: The number of dimensions.
+ *	@param  uniforms		: The output array, dimension-major, as for `counterBasedUniformsBlock()`.
+ */
+void	latinHypercubeUniformsBlock(
+		uint64_t	seed,
+		uint64_t	numberOfStrata,
+		uint64_t	firstIteration,
+		size_t		numberOfIterations,
+		size_t		numberOfDimensions,
+		double *	uniforms);
@@ -0,0 +1,167 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "random.h"
+
+static const uint32_t	kPhiloxMultiplier0	= 0xD2511F53;
+static const uint32_t	kPhiloxMultiplier1	= 0xCD9E8D57;
+static const uint32_t	kPhiloxWeyl0		= 0x9E3779B9;
+static const uint32_t	kPhiloxWeyl1		= 0xBB67AE85;
+static const int	kPhiloxRounds		= 10;
+
+/*
+ *	2^-53: scales a 53-bit integer to a double in [0, 1).
+ */
+static const double	kTwoPowMinus53		= 1.0 / 9007199254740992.0;
+
+void
+philox4x32x10(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+	uint32_t	c0 = counter[0];
+	uint32_t	c1 = counter[1];
+	uint32_t	c2 = counter[2];
+	uint32_t	c3 = counter[3];
+	uint32_t	k0 = key[0];
+	uint32_t	k1 = key[1];
+
+	for (int round = 0; round < kPhiloxRounds; round++)
+	{
+		uint64_t	product0 = (uint64_t) kPhiloxMultiplier0 * c0;
+		uint64_t	product1 = (uint64_t) kPhiloxMultiplier1 * c2;
+
+		c0 = (uint32_t)(product1 >> 32) ^ c1 ^ k0;
+		c1 = (uint32_t) product1;
+		c2 = (uint32_t)(product0 >> 32) ^ c3 ^ k1;
+		c3 = (uint32_t) product0;
+
+		k0 += kPhiloxWeyl0;
+		k1 += kPhiloxWeyl1;
+	}
+
+	output[0] = c0;
+	output[1] = c1;
+	output[2] = c2;
+	output[3] = c3;
+
+	return;
+}
+
+void
+counterBasedUniforms(uint64_t seed, uint64_t iteration, size_t numberOfDimensions, double *  uniforms)
+{
+	uint32_t	key[2] = {(uint32_t) seed, (uint32_t)(seed >> 32)};
+	uint32_t	counter[4] = {(uint32_t) iteration, (uint32_t)(iteration >> 32), 0, 0};
+	uint32_t	words[4];
+
+	/*
+	 *	Each Philox block yields 128 bits, i.e., two 53-bit uniforms. The third
+	 *	counter word selects the block.
+	 */
+	for (size_t dimension = 0; dimension < numberOfDimensions; dimension += 2)
+	{
+		counter[2] = (uint32_t)(dimension / 2);
+		philox4x32x10(counter, key, words);
+
+		uniforms[dimension] = (double)(((uint64_t) words[0] << 21) ^ (words[1] >> 11)) * kTwoPowMinus53;
+		if (dimension + 1 < numberOfDimensions)
+		{
+			uniforms[dimension + 1] = (double)(((uint64_t) words[2] << 21) ^ (words[3] >> 11)) * kTwoPowMinus53;
+		}
+	}
+
+	return;
+}
+
+void
+counterBasedUniformsBlock(
+	uint64_t	seed,
+	uint64_t	firstIteration,
+	size_t		numberOfIterations,
+	size_t		numberOfDimensions,
+	double *	uniforms)
+{
+	for (size_t laneBase = 0; laneBase < numberOfIterations; laneBase += kCounterBasedUniformsLanes)
+	{
+		size_t	numberOfLanes = numberOfIterations - laneBase;
+
+		if (numberOfLanes > kCounterBasedUniformsLanes)
+		{
+			numberOfLanes = kCounterBasedUniformsLanes;
+		}
+
+		for (size_t dimension = 0; dimension < numberOfDimensions; dimension += 2)
+		{
+			uint32_t	c0[kCounterBasedUniformsLanes];
+			uint32_t	c1[kCounterBasedUniformsLanes];
+			uint32_t	c2[kCounterBasedUniformsLanes];
+			uint32_t	c3[kCounterBasedUniformsLanes];
+			uint32_t	k0 = (uint32_t) seed;
+			uint32_t	k1 = (uint32_t)(seed >> 32);
+
+			/*
+			 *	Same counter layout as `counterBasedUniforms()`. Unused lanes of
+			 *	the last group are computed and discarded.
+			 */
+			for (size_t lane = 0; lane < kCounterBasedUniformsLanes; lane++)
+			{
+				uint64_t	iteration = firstIteration + laneBase + lane;
+
+				c0[lane] = (uint32_t) iteration;
+				c1[lane] = (uint32_t)(iteration >> 32);
+				c2[lane] = (uint32_t)(dimension / 2);
+				c3[lane] = 0;
+			}
+
+			for (int round = 0; round < kPhiloxRounds; round++)
+			{
+				for (size_t lane = 0; lane < kCounterBasedUniformsLanes; lane++)
+				{
+					uint64_t	product0 = (uint64_t) kPhiloxMultiplier0 * c0[lane];
+					uint64_t	product1 = (uint64_t) kPhiloxMultiplier1 * c2[lane];
+
+					c0[lane] = (uint32_t)(product1 >> 32) ^ c1[lane] ^ k0;
+					c1[lane] = (uint32_t) product1;
+					c2[lane] = (uint32_t)(product0 >> 32) ^ c3[lane] ^ k1;
+					c3[lane] = (uint32_t) product0;
+				}
+
+				k0 += kPhiloxWeyl0;
+				k1 += kPhiloxWeyl1;
+			}
+
+			for (size_t lane = 0; lane < numberOfLanes; lane++)
+			{
+				uniforms[dimension * numberOfIterations + laneBase + lane] =
+					(double)(((uint64_t) c0[lane] << 21) ^ (c1[lane] >> 11)) * kTwoPowMinus53;
+				if (dimension + 1 < numberOfDimensions)
+				{
+					uniforms[(dimension + 1) * numberOfIterations + laneBase + lane] =
+						(double)(((uint64_t) c2[lane] << 21) ^ (c3[lane] >> 11)) * kTwoPowMinus53;
+				}
+			}
+		}
+	}
+
+	return;
+}
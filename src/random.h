@@ -0,0 +1,80 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+	/*
+	 *	Number of Philox blocks that `counterBasedUniformsBlock()` runs in lockstep.
+	 *	The rounds are written as loops over these lanes so that the compiler
+	 *	vectorizes the 32x32-to-64-bit multiplies.
+	 */
+	kCounterBasedUniformsLanes	= 32,
+} CounterBasedUniformsConstant;
+
+/**
+ *	@brief  Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel
+ *		Random Numbers: As Easy as 1, 2, 3", SC'11). Every (key, counter) pair maps to
+ *		four independent 32-bit words, so any thread can generate the random numbers of
+ *		any iteration directly, without sharing or advancing generator state.
+ *
+ *	@param  counter		: The 128-bit counter.
+ *	@param  key		: The 64-bit key.
+ *	@param  output		: The four output words.
+ */
+void	philox4x32x10(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+
+/**
+ *	@brief  Fills `uniforms` with the first `numberOfDimensions` uniform variates in [0, 1)
+ *		of the stream identified by `seed` at position `iteration`. The values depend
+ *		only on `seed`, `iteration` and the dimension index.
+ *
+ *	@param  seed			: The stream seed (the Philox key).
+ *	@param  iteration		: The iteration (the low 64 bits of the Philox counter).
+ *	@param  numberOfDimensions	: The number of uniform variates to generate.
+ *	@param  uniforms		: The output array.
+ */
+void	counterBasedUniforms(uint64_t seed, uint64_t iteration, size_t numberOfDimensions, double *  uniforms);
+
+/**
+ *	@brief  Generates the uniform variates of `numberOfIterations` consecutive iterations at once,
+ *		with the same values as `counterBasedUniforms()`. The Philox blocks of
+ *		`kCounterBasedUniformsLanes` iterations are computed side by side, so the generator
+ *		runs in SIMD registers rather than one block at a time.
+ *
+ *	@param  seed			: The stream seed (the Philox key).
+ *	@param  firstIteration		: The first iteration.
+ *	@param  numberOfIterations	: The number of consecutive iterations.
+ *	@param  numberOfDimensions	: The number of uniform variates per iteration.
+ *	@param  uniforms		: The output array, dimension-major: the variate of dimension `d` of
+ *					  iteration `firstIteration + i` is `uniforms[d * numberOfIterations + i]`.
+ */
+void	counterBasedUniformsBlock(
+		uint64_t	seed,
+		uint64_t	firstIteration,
+		size_t		numberOfIterations,
+		size_t		numberOfDimensions,
+		double *	uniforms);
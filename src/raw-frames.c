@@ -0,0 +1,228 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include "common.h"
+#include "raw-frames.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#define kRawFramesHaveMmap	(1)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#define kRawFramesHaveMmap	(0)
+#endif
+
+bool
+rawFrameHostIsLittleEndian(void)
+{
+	const uint16_t	probe = 1;
+	uint8_t		firstByte;
+
+	memcpy(&firstByte, &probe, 1);
+
+	return firstByte == 1;
+}
+
+CommonConstantReturnType
+rawFrameFileOpen(RawFrameFile *  file, const char *  path)
+{
+#if kRawFramesHaveMmap
+	struct stat	status;
+	int		fileDescriptor;
+	void *		mapping;
+
+	memset(file, 0, sizeof(*file));
+
+	if (!rawFrameHostIsLittleEndian())
+	{
+		fprintf(stderr, "Error: Raw frame files can only be mapped on little-endian hosts.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	fileDescriptor = open(path, O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		fprintf(stderr, "Error: Could not open raw frame file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((fstat(fileDescriptor, &status) != 0) || ((size_t) status.st_size < kRawFrameFileHeaderSize))
+	{
+		fprintf(stderr, "Error: Raw frame file \"%s\" is too small to hold a header.\n", path);
+		close(fileDescriptor);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	mapping = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	/*
+	 *	The mapping keeps the file referenced; the descriptor is no longer needed.
+	 */
+	close(fileDescriptor);
+
+	if (mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "Error: Could not memory-map raw frame file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	file->mapping = (const uint8_t *) mapping;
+	file->mappingSize = (size_t) status.st_size;
+	memcpy(&file->header, file->mapping, sizeof(file->header));
+
+	if ((file->header.magic != kRawFrameFileMagic) && (file->header.magic != kRawFrameFileTaggedMagic))
+	{
+		fprintf(stderr, "Error: \"%s\" is not a raw frame file (bad magic).\n", path);
+		rawFrameFileClose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((file->header.width == 0) || (file->header.height == 0))
+	{
+		fprintf(stderr, "Error: Raw frame file \"%s\" has an empty frame size.\n", path);
+		rawFrameFileClose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	file->pixelsPerFrame = (size_t) file->header.width * file->header.height;
+	file->hasProfileIndices = (file->header.magic == kRawFrameFileTaggedMagic);
+
+	/*
+	 *	The sizes come from the file, so they are checked without multiplications that
+	 *	could wrap around.
+	 */
+	if (file->pixelsPerFrame > (SIZE_MAX - kRawFrameFileProfileIndexSize) / sizeof(uint16_t))
+	{
+		fprintf(
+			stderr,
+			"Error: Raw frame file \"%s\" has a frame size (%" PRIu32 "x%" PRIu32 ") too large to address.\n",
+			path,
+			file->header.width,
+			file->header.height);
+		rawFrameFileClose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	file->frameRecordSize = (file->hasProfileIndices ? kRawFrameFileProfileIndexSize : 0) + file->pixelsPerFrame * sizeof(uint16_t);
+
+	if (file->header.frameCount > (file->mappingSize - kRawFrameFileHeaderSize) / file->frameRecordSize)
+	{
+		fprintf(
+			stderr,
+			"Error: Raw frame file \"%s\" holds %zu bytes, too few for the %" PRIu32 " frames of %zu bytes (%" PRIu32 "x%" PRIu32 ") of its header.\n",
+			path,
+			file->mappingSize,
+			file->header.frameCount,
+			file->frameRecordSize,
+			file->header.width,
+			file->header.height);
+		rawFrameFileClose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Frames are converted front to back.
+	 */
+	madvise(mapping, file->mappingSize, MADV_SEQUENTIAL);
+
+	return kCommonConstantReturnTypeSuccess;
+#else
+	(void) file;
+	fprintf(stderr, "Error: Memory-mapped raw frame input (\"%s\") is not supported on this platform.\n", path);
+
+	return kCommonConstantReturnTypeError;
+#endif
+}
+
+const uint16_t *
+rawFrameFileGetFrame(const RawFrameFile *  file, size_t frameIndex)
+{
+	const uint8_t *	record = file->mapping + kRawFrameFileHeaderSize + frameIndex * file->frameRecordSize;
+
+	return (const uint16_t *) (file->hasProfileIndices ? record + kRawFrameFileProfileIndexSize : record);
+}
+
+uint32_t
+rawFrameFileGetProfileIndex(const RawFrameFile *  file, size_t frameIndex)
+{
+	uint32_t	profileIndex = 0;
+
+	if (file->hasProfileIndices)
+	{
+		memcpy(&profileIndex, file->mapping + kRawFrameFileHeaderSize + frameIndex * file->frameRecordSize, sizeof(profileIndex));
+	}
+
+	return profileIndex;
+}
+
+void
+rawFrameFileClose(RawFrameFile *  file)
+{
+#if kRawFramesHaveMmap
+	if (file->mapping != NULL)
+	{
+		munmap((void *) file->mapping, file->mappingSize);
+	}
+#endif
+
+	file->mapping = NULL;
+	file->mappingSize = 0;
+
+	return;
+}
+
+CommonConstantReturnType
+rawTemperatureFileWriteHeader(FILE *  outputFile, uint32_t width, uint32_t height, uint32_t frameCount, bool isFloat32)
+{
+	RawFrameFileHeader	header =
+				{
+					.magic = isFloat32 ? kRawTemperatureFileFloat32Magic : kRawTemperatureFileMagic,
+					.width = width,
+					.height = height,
+					.frameCount = frameCount,
+				};
+
+	if (fwrite(&header, sizeof(header), 1, outputFile) != 1)
+	{
+		fprintf(stderr, "Error: Could not write the raw temperature file header.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
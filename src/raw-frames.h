@@ -0,0 +1,145 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+
+/*
+ *	Raw radiometric frame files: a 16-byte little-endian header followed by
+ *	`frameCount` frames of `width * height` little-endian uint16 counts,
+ *	row by row, without padding.
+ *
+ *		offset	size	field
+ *		0	4	magic, "FAX5"
+ *		4	4	width
+ *		8	4	height
+ *		12	4	frameCount
+ *
+ *	Camera-tagged raw frame files, magic "FAXC", precede each frame with a
+ *	little-endian uint32, the number of the calibration profile of the camera
+ *	that captured it, so that one file can interleave the frames of many cameras.
+ *
+ *	Converted temperatures are written with the same header layout, magic
+ *	"FAXT", followed by little-endian float64 frames, or magic "FAXf", followed by
+ *	little-endian float32 frames.
+ *
+ *	Material maps have the same header layout, magic "FAXL" and a frame count
+ *	of 1, followed by one uint8 material label per pixel.
+ */
+typedef enum
+{
+	kRawFrameFileHeaderSize		= 16,
+	kRawFrameFileMagic		= 0x35584146,	/* "FAX5" read as a little-endian uint32 */
+	kRawFrameFileTaggedMagic	= 0x43584146,	/* "FAXC" read as a little-endian uint32 */
+	kRawFrameFileProfileIndexSize	= 4,
+	kRawTemperatureFileMagic	= 0x54584146,	/* "FAXT" read as a little-endian uint32 */
+	kRawTemperatureFileFloat32Magic	= 0x66584146,	/* "FAXf" read as a little-endian uint32 */
+	kRawMaterialMapFileMagic	= 0x4C584146,	/* "FAXL" read as a little-endian uint32 */
+} RawFrameFileConstant;
+
+typedef struct
+{
+	uint32_t	magic;
+	uint32_t	width;
+	uint32_t	height;
+	uint32_t	frameCount;
+} RawFrameFileHeader;
+
+typedef struct
+{
+	RawFrameFileHeader	header;
+	const uint8_t *		mapping;
+	size_t			mappingSize;
+	size_t			pixelsPerFrame;
+	/*
+	 *	Bytes from one frame to the next: the counts, after a profile index if
+	 *	the file is camera-tagged.
+	 */
+	bool			hasProfileIndices;
+	size_t			frameRecordSize;
+} RawFrameFile;
+
+/**
+ *	@brief  Memory-maps a raw frame file and validates its header and size. Frames are then
+ *		read directly from the mapping, without a parse step or intermediate copy.
+ *
+ *	@param  file		: Pointer to the file object to open. Close with `rawFrameFileClose()`.
+ *	@param  path		: Path of the raw frame file.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	rawFrameFileOpen(RawFrameFile *  file, const char *  path);
+
+/**
+ *	@brief  Returns a pointer to the counts of a frame inside the mapping.
+ *
+ *	@param  file		: Pointer to an open raw frame file.
+ *	@param  frameIndex	: Index of the frame, less than `file->header.frameCount`.
+ *
+ *	@return			: Pointer to the first count of the frame.
+ */
+const uint16_t *	rawFrameFileGetFrame(const RawFrameFile *  file, size_t frameIndex);
+
+/**
+ *	@brief  Returns the calibration profile number of a frame of a camera-tagged file.
+ *
+ *	@param  file		: Pointer to an open raw frame file.
+ *	@param  frameIndex	: Index of the frame, less than `file->header.frameCount`.
+ *
+ *	@return			: The profile number of the frame, or 0 if the file is not camera-tagged.
+ */
+uint32_t	rawFrameFileGetProfileIndex(const RawFrameFile *  file, size_t frameIndex);
+
+/**
+ *	@brief  Unmaps a raw frame file.
+ *
+ *	@param  file		: Pointer to the file object.
+ */
+void	rawFrameFileClose(RawFrameFile *  file);
+
+/**
+ *	@brief  Checks that the host is little-endian, so that mapped counts can be used in place.
+ *
+ *	@return			: `true` if the host is little-endian.
+ */
+bool	rawFrameHostIsLittleEndian(void);
+
+/**
+ *	@brief  Writes the header of a raw temperature file, to be followed by `frameCount` frames
+ *		of `width * height` doubles, or floats.
+ *
+ *	@param  outputFile	: The output stream, opened in binary mode.
+ *	@param  width		: Frame width in pixels.
+ *	@param  height		: Frame height in pixels.
+ *	@param  frameCount	: Number of frames that follow.
+ *	@param  isFloat32	: `true` if the frames are float32.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	rawTemperatureFileWriteHeader(FILE *  outputFile, uint32_t width, uint32_t height, uint32_t frameCount, bool isFloat32);
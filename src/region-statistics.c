@@ -0,0 +1,379 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include "common.h"
+#include "material-map.h"
+#include "streaming-statistics.h"
+#include "region-statistics.h"
+
+static const char *	kRegionStatisticsSeparators = " \t\r\n";
+
+static CommonConstantReturnType
+regionStatisticsAddRegion(RegionStatistics *  regionStatistics, const RegionOfInterest *  region)
+{
+	if (regionStatistics->numberOfRegions >= kRegionStatisticsMaximumRegions)
+	{
+		fprintf(stderr, "Error: At most %d regions of interest are supported.\n", kRegionStatisticsMaximumRegions);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	regionStatistics->regions[regionStatistics->numberOfRegions++] = *region;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Parses a `<name> <column> <row> <width> <height>` line, whose name is already read,
+ *	and checks that the rectangle lies within the frame.
+ */
+static CommonConstantReturnType
+regionStatisticsParseRectangle(
+	RegionOfInterest *	region,
+	const char *		name,
+	size_t			width,
+	size_t			height,
+	const char *		path,
+	size_t			lineNumber)
+{
+	int	values[4];
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		const char *	token = strtok(NULL, kRegionStatisticsSeparators);
+
+		if ((token == NULL) || (parseIntChecked(token, &values[i]) != kCommonConstantReturnTypeSuccess) || (values[i] < 0))
+		{
+			fprintf(stderr, "Error: %s:%zu: Expected \"<name> <column> <row> <width> <height>\", with non-negative integers.\n", path, lineNumber);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if ((strtok(NULL, kRegionStatisticsSeparators) != NULL) || (strlen(name) >= kRegionStatisticsMaximumNameLength))
+	{
+		fprintf(stderr, "Error: %s:%zu: Expected \"<name> <column> <row> <width> <height>\", with a name of at most %d characters.\n", path, lineNumber, kRegionStatisticsMaximumNameLength - 1);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((values[2] == 0) || (values[3] == 0) || ((size_t) values[0] + values[2] > width) || ((size_t) values[1] + values[3] > height))
+	{
+		fprintf(stderr, "Error: %s:%zu: Region \"%s\" is empty or extends beyond the %zux%zu frames.\n", path, lineNumber, name, width, height);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	snprintf(region->name, sizeof(region->name), "%s", name);
+	region->isMaskSlot = false;
+	region->column = (size_t) values[0];
+	region->row = (size_t) values[1];
+	region->width = (size_t) values[2];
+	region->height = (size_t) values[3];
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+static CommonConstantReturnType
+regionStatisticsLoadRectangles(RegionStatistics *  regionStatistics, const char *  path, size_t width, size_t height)
+{
+	FILE *				inputFile;
+	char				line[kRegionStatisticsMaximumLineLength];
+	size_t				lineNumber = 0;
+	CommonConstantReturnType	ret = kCommonConstantReturnTypeSuccess;
+
+	inputFile = fopen(path, "r");
+	if (inputFile == NULL)
+	{
+		fprintf(stderr, "Error: Could not open region of interest file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	while ((ret == kCommonConstantReturnTypeSuccess) && (fgets(line, sizeof(line), inputFile) != NULL))
+	{
+		char *			comment = strchr(line, '#');
+		const char *		name;
+		RegionOfInterest	region;
+
+		lineNumber++;
+		if ((strchr(line, '\n') == NULL) && !feof(inputFile))
+		{
+			fprintf(stderr, "Error: %s:%zu: Line is longer than %d characters.\n", path, lineNumber, kRegionStatisticsMaximumLineLength - 2);
+			ret = kCommonConstantReturnTypeError;
+
+			break;
+		}
+
+		if (comment != NULL)
+		{
+			*comment = '\0';
+		}
+
+		name = strtok(line, kRegionStatisticsSeparators);
+		if (name == NULL)
+		{
+			continue;
+		}
+
+		ret = regionStatisticsParseRectangle(&region, name, width, height, path, lineNumber);
+		if (ret == kCommonConstantReturnTypeSuccess)
+		{
+			ret = regionStatisticsAddRegion(regionStatistics, &region);
+		}
+	}
+
+	if ((ret == kCommonConstantReturnTypeSuccess) && ferror(inputFile))
+	{
+		fprintf(stderr, "Error: Could not read region of interest file \"%s\".\n", path);
+		ret = kCommonConstantReturnTypeError;
+	}
+
+	fclose(inputFile);
+
+	return ret;
+}
+
+static CommonConstantReturnType
+regionStatisticsLoadMask(RegionStatistics *  regionStatistics, const char *  path, size_t width, size_t height)
+{
+	MaterialMap *	mask = &regionStatistics->mask;
+
+	if (materialMapLoad(mask, path) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((mask->width != width) || (mask->height != height))
+	{
+		fprintf(stderr, "Error: The region of interest mask is %" PRIu32 "x%" PRIu32 " pixels, but the frames are %zux%zu.\n", mask->width, mask->height, width, height);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t slot = 0; slot < mask->numberOfSlots; slot++)
+	{
+		RegionOfInterest	region = {0};
+
+		if (mask->slotLabels[slot] == 0)
+		{
+			continue;
+		}
+
+		snprintf(region.name, sizeof(region.name), "label-%d", (int) mask->slotLabels[slot]);
+		region.isMaskSlot = true;
+		region.maskSlot = (uint8_t) slot;
+		regionStatistics->slotRegions[slot] = (int) regionStatistics->numberOfRegions;
+		if (regionStatisticsAddRegion(regionStatistics, &region) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+regionStatisticsInit(
+	RegionStatistics *	regionStatistics,
+	const char *		rectanglesPath,
+	const char *		maskPath,
+	size_t			width,
+	size_t			height,
+	size_t			numberOfFrames)
+{
+	regionStatistics->numberOfRegions = 0;
+	regionStatistics->mask.slots = NULL;
+	regionStatistics->values = NULL;
+	regionStatistics->numberOfFrames = numberOfFrames;
+	for (size_t slot = 0; slot < kMaterialMapMaximumLabels; slot++)
+	{
+		regionStatistics->slotRegions[slot] = -1;
+	}
+
+	if (((rectanglesPath != NULL) && (regionStatisticsLoadRectangles(regionStatistics, rectanglesPath, width, height) != kCommonConstantReturnTypeSuccess)) ||
+		((maskPath != NULL) && (regionStatisticsLoadMask(regionStatistics, maskPath, width, height) != kCommonConstantReturnTypeSuccess)))
+	{
+		regionStatisticsFree(regionStatistics);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (regionStatistics->numberOfRegions == 0)
+	{
+		fprintf(stderr, "Error: No regions of interest are defined.\n");
+		regionStatisticsFree(regionStatistics);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	regionStatistics->values = (double *) checkedMalloc(
+						(regionStatistics->numberOfRegions * numberOfFrames * kRegionStatisticsValueIndexMax + 1) * sizeof(double),
+						__FILE__,
+						__LINE__);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+regionStatisticsBeginFrame(RegionStatistics *  regionStatistics, bool hasStandardDeviations)
+{
+	for (size_t r = 0; r < regionStatistics->numberOfRegions; r++)
+	{
+		streamingStatisticsInit(&regionStatistics->statistics[r]);
+		regionStatistics->standardDeviationSums[r] = 0.0;
+	}
+	regionStatistics->hasStandardDeviations = hasStandardDeviations;
+
+	return;
+}
+
+/*
+ *	Adds consecutive pixels of a row to a region.
+ */
+static void
+regionStatisticsAddPixels(
+	RegionStatistics *	regionStatistics,
+	size_t			regionIndex,
+	const double *		temperatures,
+	const double *		standardDeviations,
+	size_t			numberOfPixels)
+{
+	streamingStatisticsAdd(&regionStatistics->statistics[regionIndex], temperatures, numberOfPixels);
+
+	if (regionStatistics->hasStandardDeviations)
+	{
+		for (size_t i = 0; i < numberOfPixels; i++)
+		{
+			regionStatistics->standardDeviationSums[regionIndex] += standardDeviations[i];
+		}
+	}
+
+	return;
+}
+
+void
+regionStatisticsAddRow(
+	RegionStatistics *	regionStatistics,
+	size_t			row,
+	const double *		temperatures,
+	const double *		standardDeviations)
+{
+	const MaterialMap *	mask = &regionStatistics->mask;
+
+	for (size_t r = 0; r < regionStatistics->numberOfRegions; r++)
+	{
+		const RegionOfInterest *	region = &regionStatistics->regions[r];
+
+		if (!region->isMaskSlot && (row >= region->row) && (row < region->row + region->height))
+		{
+			regionStatisticsAddPixels(
+				regionStatistics,
+				r,
+				&temperatures[region->column],
+				regionStatistics->hasStandardDeviations ? &standardDeviations[region->column] : NULL,
+				region->width);
+		}
+	}
+
+	/*
+	 *	Masks are added a run of equal labels at a time.
+	 */
+	if (mask->slots != NULL)
+	{
+		const uint8_t *	slots = &mask->slots[row * mask->width];
+		size_t		runStart = 0;
+
+		for (size_t column = 1; column <= mask->width; column++)
+		{
+			if ((column < mask->width) && (slots[column] == slots[runStart]))
+			{
+				continue;
+			}
+
+			if (regionStatistics->slotRegions[slots[runStart]] >= 0)
+			{
+				regionStatisticsAddPixels(
+					regionStatistics,
+					(size_t) regionStatistics->slotRegions[slots[runStart]],
+					&temperatures[runStart],
+					regionStatistics->hasStandardDeviations ? &standardDeviations[runStart] : NULL,
+					column - runStart);
+			}
+			runStart = column;
+		}
+	}
+
+	return;
+}
+
+void
+regionStatisticsEndFrame(RegionStatistics *  regionStatistics, size_t frameIndex)
+{
+	for (size_t r = 0; r < regionStatistics->numberOfRegions; r++)
+	{
+		StreamingStatistics *	statistics = &regionStatistics->statistics[r];
+		double *		values = (double *) regionStatisticsGetValues(regionStatistics, r, frameIndex);
+
+		values[kRegionStatisticsValueIndexMean] = statistics->moments.mean;
+		values[kRegionStatisticsValueIndexMinimum] = statistics->moments.minimum;
+		values[kRegionStatisticsValueIndexMaximum] = statistics->moments.maximum;
+		values[kRegionStatisticsValueIndexMeanStandardError] = streamingStatisticsMeanStandardError(statistics);
+		streamingStatisticsQuantileStandardErrors(
+			statistics,
+			kRegionStatisticsQuantileProbabilities,
+			kRegionStatisticsNumberOfQuantiles,
+			&values[kRegionStatisticsValueIndexQuantiles],
+			&values[kRegionStatisticsValueIndexQuantileStandardErrors]);
+		values[kRegionStatisticsValueIndexMeanStandardDeviation] = regionStatistics->hasStandardDeviations ?
+										regionStatistics->standardDeviationSums[r] / statistics->moments.count :
+										NAN;
+		streamingStatisticsFree(statistics);
+	}
+
+	return;
+}
+
+const double *
+regionStatisticsGetValues(const RegionStatistics *  regionStatistics, size_t regionIndex, size_t frameIndex)
+{
+	return &regionStatistics->values[(regionIndex * regionStatistics->numberOfFrames + frameIndex) * kRegionStatisticsValueIndexMax];
+}
+
+void
+regionStatisticsFree(RegionStatistics *  regionStatistics)
+{
+	materialMapFree(&regionStatistics->mask);
+	free(regionStatistics->values);
+	regionStatistics->values = NULL;
+	regionStatistics->numberOfRegions = 0;
+
+	return;
+}
@@ -0,0 +1,177 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "material-map.h"
+#include "streaming-statistics.h"
+
+/*
+ *	Statistics of regions of interest (ROIs), accumulated row by row while a
+ *	frame is converted, so that they need no second pass over the frame.
+ *	Rectangles come from a text file with one `<name> <column> <row> <width>
+ *	<height>` line per region, `#` starting a comment:
+ *
+ *		hot-spot	120	80	32	32
+ *		background	0	0	640	16
+ *
+ *	A label mask is a material map file ("FAXL"), in which every non-zero
+ *	label is a region, named `label-<label>`. A pixel can be in several regions.
+ */
+typedef enum
+{
+	kRegionStatisticsMaximumRegions		= 32,
+	kRegionStatisticsMaximumNameLength	= 64,
+	kRegionStatisticsMaximumLineLength	= 512,
+	kRegionStatisticsNumberOfQuantiles	= 3,
+} RegionStatisticsConstant;
+
+static const double	kRegionStatisticsQuantileProbabilities[kRegionStatisticsNumberOfQuantiles] = {0.05, 0.50, 0.95};
+
+/*
+ *	The values of each region for each frame.
+ */
+typedef enum
+{
+	kRegionStatisticsValueIndexMean			= 0,
+	kRegionStatisticsValueIndexMinimum,
+	kRegionStatisticsValueIndexMaximum,
+	kRegionStatisticsValueIndexMeanStandardError,
+	kRegionStatisticsValueIndexQuantiles,
+	kRegionStatisticsValueIndexQuantileStandardErrors	= kRegionStatisticsValueIndexQuantiles + kRegionStatisticsNumberOfQuantiles,
+	/*
+	 *	Mean per-pixel standard deviation, with `-dm` or `-M`, else NAN.
+	 */
+	kRegionStatisticsValueIndexMeanStandardDeviation	= kRegionStatisticsValueIndexQuantileStandardErrors + kRegionStatisticsNumberOfQuantiles,
+	kRegionStatisticsValueIndexMax,
+} RegionStatisticsValueIndex;
+
+typedef struct
+{
+	char		name[kRegionStatisticsMaximumNameLength];
+	/*
+	 *	A rectangle, or the pixels of a slot of the label mask.
+	 */
+	bool		isMaskSlot;
+	uint8_t		maskSlot;
+	size_t		column;
+	size_t		row;
+	size_t		width;
+	size_t		height;
+} RegionOfInterest;
+
+typedef struct
+{
+	RegionOfInterest	regions[kRegionStatisticsMaximumRegions];
+	size_t			numberOfRegions;
+	/*
+	 *	The label mask, and the region of each of its slots (-1 for label 0).
+	 */
+	MaterialMap		mask;
+	int			slotRegions[kMaterialMapMaximumLabels];
+	/*
+	 *	The statistics of the current frame, and the sum of its per-pixel standard deviations.
+	 */
+	StreamingStatistics	statistics[kRegionStatisticsMaximumRegions];
+	double			standardDeviationSums[kRegionStatisticsMaximumRegions];
+	bool			hasStandardDeviations;
+	/*
+	 *	`kRegionStatisticsValueIndexMax` values per frame, for `numberOfFrames` frames, for
+	 *	each region in turn.
+	 */
+	double *		values;
+	size_t			numberOfFrames;
+} RegionStatistics;
+
+/**
+ *	@brief  Loads the regions of a rectangle file and of a label mask, and checks that they
+ *		lie within the frames.
+ *
+ *	@param  regionStatistics	: Pointer to the statistics to initialize. Free with `regionStatisticsFree()`.
+ *	@param  rectanglesPath		: Path of the rectangle file, or NULL.
+ *	@param  maskPath		: Path of the label mask file, or NULL.
+ *	@param  width			: Frame width in pixels.
+ *	@param  height			: Frame height in pixels.
+ *	@param  numberOfFrames		: Number of frames to hold the values of.
+ *
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	regionStatisticsInit(
+					RegionStatistics *	regionStatistics,
+					const char *		rectanglesPath,
+					const char *		maskPath,
+					size_t			width,
+					size_t			height,
+					size_t			numberOfFrames);
+
+/**
+ *	@brief  Starts the statistics of a frame.
+ *
+ *	@param  regionStatistics	: Pointer to the statistics.
+ *	@param  hasStandardDeviations	: Whether rows come with per-pixel standard deviations.
+ */
+void	regionStatisticsBeginFrame(RegionStatistics *  regionStatistics, bool hasStandardDeviations);
+
+/**
+ *	@brief  Adds a converted row of the frame to the regions that cover it.
+ *
+ *	@param  regionStatistics	: Pointer to the statistics.
+ *	@param  row			: The row.
+ *	@param  temperatures		: The temperatures of the row.
+ *	@param  standardDeviations	: Their standard deviations, if the frame has them.
+ */
+void	regionStatisticsAddRow(
+		RegionStatistics *	regionStatistics,
+		size_t			row,
+		const double *		temperatures,
+		const double *		standardDeviations);
+
+/**
+ *	@brief  Computes the values of each region for a frame and frees its statistics.
+ *
+ *	@param  regionStatistics	: Pointer to the statistics.
+ *	@param  frameIndex		: The frame, less than `numberOfFrames`.
+ */
+void	regionStatisticsEndFrame(RegionStatistics *  regionStatistics, size_t frameIndex);
+
+/**
+ *	@brief  Returns the values of a region for a frame.
+ *
+ *	@param  regionStatistics	: Pointer to the statistics.
+ *	@param  regionIndex		: The region.
+ *	@param  frameIndex		: The frame.
+ *
+ *	@return				: Pointer to `kRegionStatisticsValueIndexMax` values, indexed by `RegionStatisticsValueIndex`.
+ */
+const double *	regionStatisticsGetValues(const RegionStatistics *  regionStatistics, size_t regionIndex, size_t frameIndex);
+
+/**
+ *	@brief  Frees the mask and the values.
+ *
+ *	@param  regionStatistics	: Pointer to the statistics.
+ */
+void	regionStatisticsFree(RegionStatistics *  regionStatistics);
@@ -0,0 +1,164 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "raw-frames.h"
+#include "monte-carlo.h"
+#include "sample-file.h"
+
+/*
+ *	64-bit FNV-1a parameters. They do not fit in an enum.
+ */
+static const uint64_t	kSampleFileFNVOffsetBasis = 0xcbf29ce484222325ULL;
+static const uint64_t	kSampleFileFNVPrime = 0x100000001b3ULL;
+
+/*
+ *	Adds the bytes of `values` to a 64-bit FNV-1a hash.
+ */
+static uint64_t
+sampleFileHashDoubles(uint64_t hash, const double *  values, size_t numberOfValues)
+{
+	const uint8_t *	bytes = (const uint8_t *) values;
+
+	for (size_t i = 0; i < numberOfValues * sizeof(double); i++)
+	{
+		hash = (hash ^ bytes[i]) * kSampleFileFNVPrime;
+	}
+
+	return hash;
+}
+
+uint64_t
+sampleFileCalibrationHash(const MonteCarloConfiguration *  configuration)
+{
+	uint64_t	hash = kSampleFileFNVOffsetBasis;
+
+	hash = sampleFileHashDoubles(hash, configuration->nominalParameters.values, kCalibrationParameterIndexMax);
+	hash = sampleFileHashDoubles(hash, configuration->parameterHalfWidths.values, kCalibrationParameterIndexMax);
+	hash = sampleFileHashDoubles(hash, &configuration->countsLow, 1);
+	hash = sampleFileHashDoubles(hash, &configuration->countsHigh, 1);
+
+	return hash;
+}
+
+/*
+ *	Writes the samples as float32, converted in chunks.
+ */
+static bool
+sampleFileWriteFloat32(FILE *  outputFile, const double *  samples, size_t numberOfSamples)
+{
+	float *	chunk = (float *) checkedMalloc(kSampleFileWriteChunkSize * sizeof(float), __FILE__, __LINE__);
+	bool	isWritten = true;
+
+	for (size_t first = 0; (first < numberOfSamples) && isWritten; first += kSampleFileWriteChunkSize)
+	{
+		size_t	chunkSize = numberOfSamples - first;
+
+		if (chunkSize > kSampleFileWriteChunkSize)
+		{
+			chunkSize = kSampleFileWriteChunkSize;
+		}
+
+		for (size_t i = 0; i < chunkSize; i++)
+		{
+			chunk[i] = (float) samples[first + i];
+		}
+
+		isWritten = (fwrite(chunk, sizeof(float), chunkSize, outputFile) == chunkSize);
+	}
+
+	free(chunk);
+
+	return isWritten;
+}
+
+CommonConstantReturnType
+sampleFileWrite(
+	const char *			path,
+	SampleFileDataType		dataType,
+	const double *			samples,
+	size_t				numberOfSamples,
+	uint64_t			executionTimeMicroseconds,
+	const MonteCarloConfiguration *	configuration)
+{
+	SampleFileHeader	header =
+				{
+					.magic				= kSampleFileMagic,
+					.version			= kSampleFileVersion,
+					.dataType			= dataType,
+					.headerSize			= kSampleFileHeaderSize,
+					.numberOfSamples		= numberOfSamples,
+					.executionTimeMicroseconds	= executionTimeMicroseconds,
+					.seed				= configuration->seed,
+					.calibrationHash		= sampleFileCalibrationHash(configuration),
+				};
+	FILE *			outputFile;
+	bool			isWritten;
+
+	/*
+	 *	The header and samples are written in host byte order.
+	 */
+	if (!rawFrameHostIsLittleEndian())
+	{
+		fprintf(stderr, "Error: Binary sample files can only be written on little-endian hosts.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	outputFile = fopen(path, "wb");
+	if (outputFile == NULL)
+	{
+		fprintf(stderr, "Error: Could not open binary sample file \"%s\" for writing.\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	The writes are already large, so stdio buffering would only add a copy.
+	 */
+	setvbuf(outputFile, NULL, _IONBF, 0);
+
+	isWritten = (fwrite(&header, sizeof(header), 1, outputFile) == 1);
+	if (isWritten && (dataType == kSampleFileDataTypeFloat32))
+	{
+		isWritten = sampleFileWriteFloat32(outputFile, samples, numberOfSamples);
+	}
+	else if (isWritten)
+	{
+		isWritten = (fwrite(samples, sizeof(double), numberOfSamples, outputFile) == numberOfSamples);
+	}
+
+	if ((fclose(outputFile) != 0) || !isWritten)
+	{
+		fprintf(stderr, "Error: Could not write binary sample file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
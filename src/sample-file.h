@@ -0,0 +1,107 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "monte-carlo.h"
+
+/*
+ *	Binary Monte Carlo sample files: a 64-byte little-endian header followed by
+ *	`numberOfSamples` little-endian float64 or float32 samples, so that the
+ *	samples are aligned and can be memory-mapped without parsing.
+ *
+ *		offset	size	field
+ *		0	4	magic, "FAXS"
+ *		4	4	version
+ *		8	4	dataType (`SampleFileDataType`)
+ *		12	4	headerSize, the offset of the first sample
+ *		16	8	numberOfSamples
+ *		24	8	executionTimeMicroseconds, as on the first line of data.out
+ *		32	8	seed of the Monte Carlo random streams
+ *		40	8	calibrationHash (`sampleFileCalibrationHash()`)
+ *		48	16	reserved, zero
+ */
+typedef enum
+{
+	kSampleFileMagic		= 0x53584146,	/* "FAXS" read as a little-endian uint32 */
+	kSampleFileVersion		= 1,
+	kSampleFileHeaderSize		= 64,
+	/*
+	 *	Samples converted to float32 are written in chunks of this many samples.
+	 */
+	kSampleFileWriteChunkSize	= 65536,
+} SampleFileConstant;
+
+typedef enum
+{
+	kSampleFileDataTypeFloat64	= 1,
+	kSampleFileDataTypeFloat32	= 2,
+} SampleFileDataType;
+
+typedef struct
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	dataType;
+	uint32_t	headerSize;
+	uint64_t	numberOfSamples;
+	uint64_t	executionTimeMicroseconds;
+	uint64_t	seed;
+	uint64_t	calibrationHash;
+	uint64_t	reserved[2];
+} SampleFileHeader;
+
+/**
+ *	@brief  Hashes the calibration distributions and `counts` range of a Monte Carlo
+ *		configuration (64-bit FNV-1a over their float64 values), so that sample files
+ *		generated with different calibrations can be told apart.
+ *
+ *	@param  configuration	: Pointer to the Monte Carlo configuration.
+ *
+ *	@return			: The hash.
+ */
+uint64_t	sampleFileCalibrationHash(const MonteCarloConfiguration *  configuration);
+
+/**
+ *	@brief  Writes samples to a binary sample file. float64 samples are written straight
+ *		from `samples` with a single unbuffered write.
+ *
+ *	@param  path				: Path of the file to write.
+ *	@param  dataType			: Type of the samples in the file.
+ *	@param  samples				: The samples.
+ *	@param  numberOfSamples			: Number of samples.
+ *	@param  executionTimeMicroseconds	: Execution time to record in the header.
+ *	@param  configuration			: Pointer to the Monte Carlo configuration that generated the samples.
+ *
+ *	@return					: `kCommonConstantReturnTypeSuccess` if successful,
+ *						  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	sampleFileWrite(
+					const char *			path,
+					SampleFileDataType		dataType,
+					const double *			samples,
+					size_t				numberOfSamples,
+					uint64_t			executionTimeMicroseconds,
+					const MonteCarloConfiguration *	configuration);
@@ -0,0 +1,86 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "stream-io.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <errno.h>
+#include <unistd.h>
+
+ssize_t
+streamReadFully(int fileDescriptor, void *  destination, size_t size)
+{
+	size_t	total = 0;
+
+	while (total < size)
+	{
+		ssize_t	count = read(fileDescriptor, (uint8_t *) destination + total, size - total);
+
+		if (count == 0)
+		{
+			break;
+		}
+
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return -1;
+		}
+
+		total += (size_t) count;
+	}
+
+	return (ssize_t) total;
+}
+
+CommonConstantReturnType
+streamWriteFully(int fileDescriptor, const void *  source, size_t size)
+{
+	size_t	total = 0;
+
+	while (total < size)
+	{
+		ssize_t	count = write(fileDescriptor, (const uint8_t *) source + total, size - total);
+
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		total += (size_t) count;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+#endif
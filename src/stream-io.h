@@ -0,0 +1,60 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "common.h"
+
+/*
+ *	Whole-buffer reads and writes on file descriptors (pipes, FIFOs and sockets),
+ *	which may transfer fewer bytes per call than asked for or be interrupted by
+ *	signals. Only available where the Posix streams that need them are.
+ */
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/types.h>
+
+/**
+ *	@brief  Reads exactly `size` bytes unless the stream ends first, retrying short reads and
+ *		reads interrupted by a signal.
+ *
+ *	@param  fileDescriptor	: The descriptor to read from.
+ *	@param  destination	: Buffer of at least `size` bytes.
+ *	@param  size		: Number of bytes to read.
+ *
+ *	@return			: The number of bytes read, less than `size` only at the end of the
+ *				  stream, or -1 on error.
+ */
+ssize_t	streamReadFully(int fileDescriptor, void *  destination, size_t size);
+
+/**
+ *	@brief  Writes all `size` bytes, retrying short writes and writes interrupted by a signal.
+ *
+ *	@param  fileDescriptor	: The descriptor to write to.
+ *	@param  source		: The bytes to write.
+ *	@param  size		: Number of bytes to write.
+ *
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	streamWriteFully(int fileDescriptor, const void *  source, size_t size);
+#endif
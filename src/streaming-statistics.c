@@ -0,0 +1,490 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+#include "streaming-statistics.h"
+
+/*
+ *	Fixed seed of the compaction coin: results are reproducible for the
+ *	same sequence of additions and merges.
+ */
+static const uint64_t	kQuantileSketchCoinSeed = 0x9E3779B97F4A7C15ULL;
+
+/*
+ *	Half the rank interval over which the density at a quantile is estimated,
+ *	wide enough that the rank error of the sketch barely affects it.
+ */
+static const double	kQuantileStandardErrorRankStep = 0.025;
+
+/*
+ *	The normalized rank error of about 1.7/k of the sketch, taken as two
+ *	standard deviations.
+ */
+static const double	kQuantileSketchRankStandardError = 0.85 / kQuantileSketchK;
+
+typedef struct
+{
+	double	value;
+	double	weight;
+} WeightedItem;
+
+static int
+compareDoubles(const void *  a, const void *  b)
+{
+	double	x = *(const double *) a;
+	double	y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+static int
+compareWeightedItems(const void *  a, const void *  b)
+{
+	return compareDoubles(&((const WeightedItem *) a)->value, &((const WeightedItem *) b)->value);
+}
+
+static bool
+quantileSketchFlipCoin(QuantileSketch *  sketch)
+{
+	/*
+	 *	xorshift64*.
+	 */
+	sketch->coinState ^= sketch->coinState >> 12;
+	sketch->coinState ^= sketch->coinState << 25;
+	sketch->coinState ^= sketch->coinState >> 27;
+
+	return ((sketch->coinState * 0x2545F4914F6CDD1DULL) >> 63) != 0;
+}
+
+/*
+ *	Capacity of level `level` when the sketch has `numberOfLevels` levels:
+ *	k at the top level, shrinking by a factor 2/3 per level below it.
+ */
+static size_t
+quantileSketchLevelThreshold(size_t level, size_t numberOfLevels)
+{
+	double	capacity = kQuantileSketchK;
+
+	for (size_t depth = level + 1; depth < numberOfLevels; depth++)
+	{
+		capacity *= 2.0 / 3.0;
+	}
+
+	return (capacity < 2) ? 2 : (size_t) ceil(capacity);
+}
+
+static void
+quantileSketchAddLevel(QuantileSketch *  sketch)
+{
+	size_t	level = sketch->numberOfLevels;
+
+	sketch->levelItems[level] = (double *) checkedMalloc(kQuantileSketchLevelCapacity * sizeof(double), __FILE__, __LINE__);
+	sketch->levelSizes[level] = 0;
+	sketch->numberOfLevels++;
+
+	return;
+}
+
+/*
+ *	Compacts `level` into `level + 1`: sorts it and promotes every other item,
+ *	starting at a random offset, with doubled weight. An odd item out stays.
+ */
+static void
+quantileSketchCompactLevel(QuantileSketch *  sketch, size_t level)
+{
+	double *	items = sketch->levelItems[level];
+	size_t		size = sketch->levelSizes[level];
+	size_t		pairedSize = size & ~(size_t) 1;
+	size_t		offset = quantileSketchFlipCoin(sketch) ? 1 : 0;
+
+	if (level + 1 == sketch->numberOfLevels)
+	{
+		quantileSketchAddLevel(sketch);
+	}
+
+	qsort(items, size, sizeof(double), compareDoubles);
+
+	for (size_t i = offset; i < pairedSize; i += 2)
+	{
+		sketch->levelItems[level + 1][sketch->levelSizes[level + 1]++] = items[i];
+	}
+
+	if (size != pairedSize)
+	{
+		items[0] = items[size - 1];
+		sketch->levelSizes[level] = 1;
+	}
+	else
+	{
+		sketch->levelSizes[level] = 0;
+	}
+
+	return;
+}
+
+static void
+quantileSketchCompress(QuantileSketch *  sketch)
+{
+	for (size_t level = 0; level < sketch->numberOfLevels; level++)
+	{
+		if ((sketch->levelSizes[level] >= quantileSketchLevelThreshold(level, sketch->numberOfLevels)) &&
+			(level + 1 < kQuantileSketchMaximumLevels))
+		{
+			quantileSketchCompactLevel(sketch, level);
+		}
+	}
+
+	return;
+}
+
+void
+streamingStatisticsInit(StreamingStatistics *  statistics)
+{
+	memset(statistics, 0, sizeof(*statistics));
+
+	statistics->moments.minimum = INFINITY;
+	statistics->moments.maximum = -INFINITY;
+	statistics->sketch.coinState = kQuantileSketchCoinSeed;
+	quantileSketchAddLevel(&statistics->sketch);
+
+	return;
+}
+
+void
+streamingStatisticsFree(StreamingStatistics *  statistics)
+{
+	for (size_t level = 0; level < statistics->sketch.numberOfLevels; level++)
+	{
+		free(statistics->sketch.levelItems[level]);
+		statistics->sketch.levelItems[level] = NULL;
+	}
+
+	statistics->sketch.numberOfLevels = 0;
+
+	return;
+}
+
+void
+streamingStatisticsAdd(StreamingStatistics *  statistics, const double *  samples, size_t numberOfSamples)
+{
+	RunningMoments *	moments = &statistics->moments;
+	QuantileSketch *	sketch = &statistics->sketch;
+
+	for (size_t i = 0; i < numberOfSamples; i++)
+	{
+		double	x = samples[i];
+		double	n = (double) (moments->count + 1);
+		double	delta = x - moments->mean;
+		double	deltaOverN = delta / n;
+		double	deltaOverNSquared = deltaOverN * deltaOverN;
+		double	term = delta * deltaOverN * (n - 1);
+
+		/*
+		 *	The higher moments are updated first, from the lower moments before this sample.
+		 */
+		moments->count++;
+		moments->mean += deltaOverN;
+		moments->sumOfFourthPowerDeviations +=	term * deltaOverNSquared * (n * n - 3 * n + 3) +
+							6 * deltaOverNSquared * moments->sumOfSquaredDeviations -
+							4 * deltaOverN * moments->sumOfCubedDeviations;
+		moments->sumOfCubedDeviations += term * deltaOverN * (n - 2) - 3 * deltaOverN * moments->sumOfSquaredDeviations;
+		moments->sumOfSquaredDeviations += term;
+		moments->minimum = fmin(moments->minimum, x);
+		moments->maximum = fmax(moments->maximum, x);
+
+		sketch->levelItems[0][sketch->levelSizes[0]++] = x;
+		if (sketch->levelSizes[0] >= quantileSketchLevelThreshold(0, sketch->numberOfLevels))
+		{
+			quantileSketchCompress(sketch);
+		}
+	}
+
+	return;
+}
+
+void
+streamingStatisticsMerge(StreamingStatistics *  into, const StreamingStatistics *  from)
+{
+	RunningMoments *	a = &into->moments;
+	const RunningMoments *	b = &from->moments;
+	size_t			count = a->count + b->count;
+
+	if (b->count == 0)
+	{
+		return;
+	}
+
+	if (count > 0)
+	{
+		double	delta = b->mean - a->mean;
+		double	countA = (double) a->count;
+		double	countB = (double) b->count;
+		double	n = (double) count;
+		double	deltaSquared = delta * delta;
+
+		a->sumOfFourthPowerDeviations +=	b->sumOfFourthPowerDeviations +
+							deltaSquared * deltaSquared * countA * countB * (countA * countA - countA * countB + countB * countB) / (n * n * n) +
+							6 * deltaSquared * (countA * countA * b->sumOfSquaredDeviations + countB * countB * a->sumOfSquaredDeviations) / (n * n) +
+							4 * delta * (countA * b->sumOfCubedDeviations - countB * a->sumOfCubedDeviations) / n;
+		a->sumOfCubedDeviations +=	b->sumOfCubedDeviations +
+						deltaSquared * delta * countA * countB * (countA - countB) / (n * n) +
+						3 * delta * (countA * b->sumOfSquaredDeviations - countB * a->sumOfSquaredDeviations) / n;
+		a->sumOfSquaredDeviations += b->sumOfSquaredDeviations + deltaSquared * (countA * countB / n);
+		a->mean += delta * ((double) b->count / count);
+		a->count = count;
+		a->minimum = fmin(a->minimum, b->minimum);
+		a->maximum = fmax(a->maximum, b->maximum);
+	}
+
+	/*
+	 *	Merge level by level, compacting as we go, so that no level ever
+	 *	holds more than `kQuantileSketchLevelCapacity` items.
+	 */
+	for (size_t level = 0; level < from->sketch.numberOfLevels; level++)
+	{
+		while (into->sketch.numberOfLevels <= level)
+		{
+			quantileSketchAddLevel(&into->sketch);
+		}
+
+		memcpy(
+			&into->sketch.levelItems[level][into->sketch.levelSizes[level]],
+			from->sketch.levelItems[level],
+			from->sketch.levelSizes[level] * sizeof(double));
+		into->sketch.levelSizes[level] += from->sketch.levelSizes[level];
+
+		if ((into->sketch.levelSizes[level] >= quantileSketchLevelThreshold(level, into->sketch.numberOfLevels)) &&
+			(level + 1 < kQuantileSketchMaximumLevels))
+		{
+			quantileSketchCompactLevel(&into->sketch, level);
+		}
+	}
+
+	quantileSketchCompress(&into->sketch);
+
+	return;
+}
+
+double
+streamingStatisticsVariance(const StreamingStatistics *  statistics)
+{
+	if (statistics->moments.count < 2)
+	{
+		return 0;
+	}
+
+	return statistics->moments.sumOfSquaredDeviations / (statistics->moments.count - 1);
+}
+
+double
+streamingStatisticsMeanStandardError(const StreamingStatistics *  statistics)
+{
+	if (statistics->moments.count < 2)
+	{
+		return INFINITY;
+	}
+
+	return sqrt(streamingStatisticsVariance(statistics) / statistics->moments.count);
+}
+
+double
+streamingStatisticsStandardDeviationStandardError(const StreamingStatistics *  statistics)
+{
+	double	n = (double) statistics->moments.count;
+	double	variance = streamingStatisticsVariance(statistics);
+	double	fourthMoment;
+	double	varianceOfVariance;
+
+	if ((statistics->moments.count < 4) || (variance <= 0))
+	{
+		return (statistics->moments.count < 4) ? INFINITY : 0;
+	}
+
+	fourthMoment = statistics->moments.sumOfFourthPowerDeviations / n;
+	varianceOfVariance = (fourthMoment - variance * variance * (n - 3) / (n - 1)) / n;
+
+	return sqrt(fmax(varianceOfVariance, 0)) / (2 * sqrt(variance));
+}
+
+/*
+ *	Estimates quantiles and the slope of the quantile function at each, from
+ *	the quantiles one rank step below and above it. The slope is INFINITY
+ *	without samples.
+ */
+static void
+streamingStatisticsQuantileSlopes(
+	const StreamingStatistics *	statistics,
+	const double *			probabilities,
+	size_t				numberOfProbabilities,
+	double *			quantiles,
+	double *			slopes)
+{
+	double *	allProbabilities = (double *) checkedMalloc((3 * numberOfProbabilities + 1) * sizeof(double), __FILE__, __LINE__);
+	double *	allQuantiles = (double *) checkedMalloc((3 * numberOfProbabilities + 1) * sizeof(double), __FILE__, __LINE__);
+
+	/*
+	 *	The quantiles, then those one step below, then those one step above. Near
+	 *	0 and 1 the step shrinks so that it stays centered on the quantile.
+	 */
+	for (size_t q = 0; q < numberOfProbabilities; q++)
+	{
+		double	step = fmin(kQuantileStandardErrorRankStep, fmin(probabilities[q], 1 - probabilities[q]) / 2);
+
+		allProbabilities[q] = probabilities[q];
+		allProbabilities[numberOfProbabilities + q] = probabilities[q] - step;
+		allProbabilities[2 * numberOfProbabilities + q] = probabilities[q] + step;
+	}
+
+	streamingStatisticsQuantiles(statistics, allProbabilities, 3 * numberOfProbabilities, allQuantiles);
+
+	for (size_t q = 0; q < numberOfProbabilities; q++)
+	{
+		double	rankWidth = allProbabilities[2 * numberOfProbabilities + q] - allProbabilities[numberOfProbabilities + q];
+		double	quantileWidth = allQuantiles[2 * numberOfProbabilities + q] - allQuantiles[numberOfProbabilities + q];
+
+		quantiles[q] = allQuantiles[q];
+		slopes[q] = ((statistics->moments.count > 0) && (rankWidth > 0)) ? quantileWidth / rankWidth : INFINITY;
+	}
+
+	free(allQuantiles);
+	free(allProbabilities);
+
+	return;
+}
+
+void
+streamingStatisticsQuantileStandardErrors(
+	const StreamingStatistics *	statistics,
+	const double *			probabilities,
+	size_t				numberOfProbabilities,
+	double *			quantiles,
+	double *			standardErrors)
+{
+	double	n = (double) statistics->moments.count;
+
+	streamingStatisticsQuantileSlopes(statistics, probabilities, numberOfProbabilities, quantiles, standardErrors);
+
+	for (size_t q = 0; q < numberOfProbabilities; q++)
+	{
+		double	p = probabilities[q];
+		double	rankVariance = (n > 0) ? p * (1 - p) / n + kQuantileSketchRankStandardError * kQuantileSketchRankStandardError : INFINITY;
+
+		standardErrors[q] *= sqrt(rankVariance);
+	}
+
+	return;
+}
+
+void
+streamingStatisticsQuantileStandardErrorFloors(
+	const StreamingStatistics *	statistics,
+	const double *			probabilities,
+	size_t				numberOfProbabilities,
+	double *			standardErrorFloors)
+{
+	double *	quantiles = (double *) checkedMalloc((numberOfProbabilities + 1) * sizeof(double), __FILE__, __LINE__);
+
+	streamingStatisticsQuantileSlopes(statistics, probabilities, numberOfProbabilities, quantiles, standardErrorFloors);
+
+	for (size_t q = 0; q < numberOfProbabilities; q++)
+	{
+		standardErrorFloors[q] *= kQuantileSketchRankStandardError;
+	}
+
+	free(quantiles);
+
+	return;
+}
+
+void
+streamingStatisticsQuantiles(
+	const StreamingStatistics *	statistics,
+	const double *			probabilities,
+	size_t				numberOfProbabilities,
+	double *			quantiles)
+{
+	const QuantileSketch *	sketch = &statistics->sketch;
+	size_t			numberOfItems = 0;
+	size_t			next = 0;
+	double			totalWeight = 0;
+	WeightedItem *		items;
+
+	for (size_t level = 0; level < sketch->numberOfLevels; level++)
+	{
+		numberOfItems += sketch->levelSizes[level];
+	}
+
+	if (numberOfItems == 0)
+	{
+		for (size_t q = 0; q < numberOfProbabilities; q++)
+		{
+			quantiles[q] = NAN;
+		}
+
+		return;
+	}
+
+	items = (WeightedItem *) checkedMalloc(numberOfItems * sizeof(WeightedItem), __FILE__, __LINE__);
+
+	for (size_t level = 0; level < sketch->numberOfLevels; level++)
+	{
+		for (size_t i = 0; i < sketch->levelSizes[level]; i++)
+		{
+			items[next++] = (WeightedItem){ .value = sketch->levelItems[level][i], .weight = ldexp(1.0, (int) level) };
+		}
+	}
+
+	qsort(items, numberOfItems, sizeof(WeightedItem), compareWeightedItems);
+
+	for (size_t i = 0; i < numberOfItems; i++)
+	{
+		totalWeight += items[i].weight;
+	}
+
+	for (size_t q = 0; q < numberOfProbabilities; q++)
+	{
+		double	targetWeight = probabilities[q] * totalWeight;
+		double	cumulativeWeight = 0;
+		size_t	i = 0;
+
+		for (; i + 1 < numberOfItems; i++)
+		{
+			cumulativeWeight += items[i].weight;
+			if (cumulativeWeight >= targetWeight)
+			{
+				break;
+			}
+		}
+
+		quantiles[q] = items[i].value;
+	}
+
+	free(items);
+
+	return;
+}
@@ -0,0 +1,187 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+	/*
+	 *	KLL accuracy parameter. The normalized rank error of a quantile
+	 *	estimate is about 1.7/k, i.e., about 0.3% for k = 512.
+	 */
+	kQuantileSketchK			= 512,
+	/*
+	 *	Each level can transiently hold up to three times k items while
+	 *	two sketches are merged.
+	 */
+	kQuantileSketchLevelCapacity		= 3 * kQuantileSketchK,
+	kQuantileSketchMaximumLevels		= 48,
+} QuantileSketchConstant;
+
+/*
+ *	Welford's online mean and variance, mergeable with Chan et al.'s
+ *	pairwise update, extended to the third and fourth central moments
+ *	(Pebay, "Formulas for robust, one-pass parallel computation of
+ *	covariances and arbitrary-order statistical moments", 2008), which
+ *	give the standard error of the standard deviation.
+ */
+typedef struct
+{
+	size_t	count;
+	double	mean;
+	double	sumOfSquaredDeviations;
+	double	sumOfCubedDeviations;
+	double	sumOfFourthPowerDeviations;
+	double	minimum;
+	double	maximum;
+} RunningMoments;
+
+/*
+ *	KLL quantile sketch (Karnin, Lang and Liberty, FOCS 2016). Level h holds
+ *	items of weight 2^h. Memory is bounded by `kQuantileSketchLevelCapacity`
+ *	doubles per level, independent of the number of samples.
+ */
+typedef struct
+{
+	double *	levelItems[kQuantileSketchMaximumLevels];
+	size_t		levelSizes[kQuantileSketchMaximumLevels];
+	size_t		numberOfLevels;
+	uint64_t	coinState;
+} QuantileSketch;
+
+typedef struct
+{
+	RunningMoments	moments;
+	QuantileSketch	sketch;
+} StreamingStatistics;
+
+/**
+ *	@brief  Initializes empty streaming statistics.
+ *
+ *	@param  statistics	: Pointer to the statistics to initialize. Free with `streamingStatisticsFree()`.
+ */
+void	streamingStatisticsInit(StreamingStatistics *  statistics);
+
+/**
+ *	@brief  Frees the memory held by streaming statistics.
+ *
+ *	@param  statistics	: Pointer to the statistics.
+ */
+void	streamingStatisticsFree(StreamingStatistics *  statistics);
+
+/**
+ *	@brief  Adds samples to streaming statistics.
+ *
+ *	@param  statistics	: Pointer to the statistics.
+ *	@param  samples		: The samples to add.
+ *	@param  numberOfSamples	: The number of samples.
+ */
+void	streamingStatisticsAdd(StreamingStatistics *  statistics, const double *  samples, size_t numberOfSamples);
+
+/**
+ *	@brief  Merges the samples summarized by `from` into `into`.
+ *
+ *	@param  into		: Pointer to the statistics to merge into.
+ *	@param  from		: Pointer to the statistics to merge from. Left unchanged.
+ */
+void	streamingStatisticsMerge(StreamingStatistics *  into, const StreamingStatistics *  from);
+
+/**
+ *	@brief  Returns the unbiased sample variance.
+ *
+ *	@param  statistics	: Pointer to the statistics.
+ *
+ *	@return			: The variance, or zero with fewer than two samples.
+ */
+double	streamingStatisticsVariance(const StreamingStatistics *  statistics);
+
+/**
+ *	@brief  Returns the standard error of the mean, sqrt(variance / count).
+ *
+ *	@param  statistics	: Pointer to the statistics.
+ *
+ *	@return			: The standard error, or INFINITY with fewer than two samples.
+ */
+double	streamingStatisticsMeanStandardError(const StreamingStatistics *  statistics);
+
+/**
+ *	@brief  Returns the large-sample standard error of the sample standard deviation s, from
+ *		the fourth central moment m4: Var(s^2) = (m4 - s^4 (n - 3) / (n - 1)) / n, and
+ *		SE(s) = SE(s^2) / (2 s).
+ *
+ *	@param  statistics	: Pointer to the statistics.
+ *
+ *	@return			: The standard error, or INFINITY with fewer than four samples.
+ */
+double	streamingStatisticsStandardDeviationStandardError(const StreamingStatistics *  statistics);
+
+/**
+ *	@brief  Estimates several quantiles and their standard errors. The standard error of a
+ *		quantile is that of its rank, sqrt(p (1 - p) / n) combined with the rank error of
+ *		the sketch, divided by the density at the quantile, which is estimated from the
+ *		quantiles up to 2.5% of the ranks below and above it.
+ *
+ *	@param  statistics		: Pointer to the statistics.
+ *	@param  probabilities		: The quantile probabilities, each in [0, 1].
+ *	@param  numberOfProbabilities	: The number of quantiles to estimate.
+ *	@param  quantiles		: Output array of quantile estimates. NAN if no samples were added.
+ *	@param  standardErrors		: Output array of their standard errors.
+ */
+void	streamingStatisticsQuantileStandardErrors(
+		const StreamingStatistics *	statistics,
+		const double *			probabilities,
+		size_t				numberOfProbabilities,
+		double *			quantiles,
+		double *			standardErrors);
+
+/**
+ *	@brief  Estimates the standard errors that the quantiles of `streamingStatisticsQuantileStandardErrors()`
+ *		approach as samples are added: that of the rank error of the sketch alone, which
+ *		does not shrink with the number of samples.
+ *	@param  statistics		: Pointer to the statistics.
+ *	@param  probabilities		: The quantile probabilities, each in [0, 1].
+ *	@param  numberOfProbabilities	: The number of quantiles.
+ *	@param  standardErrorFloors	: Output array of the smallest standard errors reachable. INFINITY if no
+ *					  samples were added.
+ */
+void	streamingStatisticsQuantileStandardErrorFloors(
+		const StreamingStatistics *	statistics,
+		const double *			probabilities,
+		size_t				numberOfProbabilities,
+		double *			standardErrorFloors);
+
+/**
+ *	@brief  Estimates several quantiles at once from the sketch.
+ *
+ *	@param  statistics		: Pointer to the statistics.
+ *	@param  probabilities		: The quantile probabilities, each in [0, 1].
+ *	@param  numberOfProbabilities	: The number of quantiles to estimate.
+ *	@param  quantiles		: Output array of quantile estimates. NAN if no samples were added.
+ */
+void	streamingStatisticsQuantiles(
+		const StreamingStatistics *	statistics,
+		const double *			probabilities,
+		size_t				numberOfProbabilities,
+		double *			quantiles);
@@ -33,36 +33,60 @@
  *	not follow our usual coding convention.
  */
 
+/*
+ *	Every uncertain parameter is a uniform distribution, centred on its
+ *	`*Nominal` value and extending `*HalfWidth` to either side.
+ */
+#define	kFLIRUniformAboutNominal(nominal, halfWidth)			UxHwDoubleUniformDist((nominal) - (halfWidth), (nominal) + (halfWidth))
+
 /*
  *	Object Parameters: Reflected Energy.
  */
-#define	kFLIRobjectParameterEmiss				UxHwDoubleUniformDist(1.0 - 0.05,		1.0 + 0.05)
-#define	kFLIRobjectParameterTRefl				UxHwDoubleUniformDist(21.85 - 0.005,		21.85 + 0.005)
+#define	kFLIRobjectParameterEmissNominal				(1.0)
+#define	kFLIRobjectParameterEmissHalfWidth				(0.05)
+#define	kFLIRobjectParameterEmiss					kFLIRUniformAboutNominal(kFLIRobjectParameterEmissNominal, kFLIRobjectParameterEmissHalfWidth)
+#define	kFLIRobjectParameterTReflNominal				(21.85)
+#define	kFLIRobjectParameterTReflHalfWidth				(0.005)
+#define	kFLIRobjectParameterTRefl					kFLIRUniformAboutNominal(kFLIRobjectParameterTReflNominal, kFLIRobjectParameterTReflHalfWidth)
 
 /*
  *	Atmospheric Attenuation.
  */
-#define	kFLIRatmosphericAttenuationParameterTAtmC		UxHwDoubleUniformDist(21.85 - 0.005,		21.85 + 0.005)
-#define	kFLIRatmosphericAttenuationParameterTAtm		(kFLIRatmosphericAttenuationParameterTAtmC + kAbsoluteZeroKelvinInCelsius)
-#define	kFLIRatmosphericAttenuationParameterHumidity		UxHwDoubleUniformDist(0.0/100)
-#define	kFLIRatmosphericAttenuationParameterTau			UxHwDoubleUniformDist(1.0 - 0.05,		1.0 + 0.05)
+#define	kFLIRatmosphericAttenuationParameterTAtmCNominal		(21.85)
+#define	kFLIRatmosphericAttenuationParameterTAtmCHalfWidth		(0.005)
+#define	kFLIRatmosphericAttenuationParameterTAtmC			kFLIRUniformAboutNominal(kFLIRatmosphericAttenuationParameterTAtmCNominal, kFLIRatmosphericAttenuationParameterTAtmCHalfWidth)
+#define	kFLIRatmosphericAttenuationParameterTAtm			(kFLIRatmosphericAttenuationParameterTAtmC + kAbsoluteZeroKelvinInCelsius)
+#define	kFLIRatmosphericAttenuationParameterHumidity			UxHwDoubleUniformDist(0.0/100)
+#define	kFLIRatmosphericAttenuationParameterTauNominal			(1.0)
+#define	kFLIRatmosphericAttenuationParameterTauHalfWidth		(0.05)
+#define	kFLIRatmosphericAttenuationParameterTau				kFLIRUniformAboutNominal(kFLIRatmosphericAttenuationParameterTauNominal, kFLIRatmosphericAttenuationParameterTauHalfWidth)
 
 /*
  *	External Optics.
  */
-#define	kFLIRexternalOpticsParameterTExtOptics			(20)
-#define	kFLIRexternalOpticsParameterTransmissionExtOptics	UxHwDoubleUniformDist(1.0 - 0.05,		1.0 + 0.05)
+#define	kFLIRexternalOpticsParameterTExtOptics				(20)
+#define	kFLIRexternalOpticsParameterTransmissionExtOpticsNominal	(1.0)
+#define	kFLIRexternalOpticsParameterTransmissionExtOpticsHalfWidth	(0.05)
+#define	kFLIRexternalOpticsParameterTransmissionExtOptics		kFLIRUniformAboutNominal(kFLIRexternalOpticsParameterTransmissionExtOpticsNominal, kFLIRexternalOpticsParameterTransmissionExtOpticsHalfWidth)
 
 /*
  *	Camera Calibration Parameters. According to FLIR, these
  *	depend on individual cameras and temperature range situations,
  *	with the values below being for an FLIR Ax5 camera.
  */
-#define	kFLIRcameraAx5CalibrationParameterR			(16556)
-#define	kFLIRcameraAx5CalibrationParameterB			UxHwDoubleUniformDist(1428.0 - 0.05,		1428.0 + 0.05)
-#define	kFLIRcameraAx5CalibrationParameterF			UxHwDoubleUniformDist(1.0 - 0.05,		1.0 + 0.05)
-#define	kFLIRcameraAx5CalibrationParameterJ1			UxHwDoubleUniformDist(22.5916 - 0.00005,	22.5916 + 0.00005)
-#define	kFLIRcameraAx5CalibrationParameterJ0			UxHwDoubleUniformDist(89.796 - 0.0005,		89.796 + 0.0005)
+#define	kFLIRcameraAx5CalibrationParameterR				(16556)
+#define	kFLIRcameraAx5CalibrationParameterBNominal			(1428.0)
+#define	kFLIRcameraAx5CalibrationParameterBHalfWidth			(0.05)
+#define	kFLIRcameraAx5CalibrationParameterB				kFLIRUniformAboutNominal(kFLIRcameraAx5CalibrationParameterBNominal, kFLIRcameraAx5CalibrationParameterBHalfWidth)
+#define	kFLIRcameraAx5CalibrationParameterFNominal			(1.0)
+#define	kFLIRcameraAx5CalibrationParameterFHalfWidth			(0.05)
+#define	kFLIRcameraAx5CalibrationParameterF				kFLIRUniformAboutNominal(kFLIRcameraAx5CalibrationParameterFNominal, kFLIRcameraAx5CalibrationParameterFHalfWidth)
+#define	kFLIRcameraAx5CalibrationParameterJ1Nominal			(22.5916)
+#define	kFLIRcameraAx5CalibrationParameterJ1HalfWidth			(0.00005)
+#define	kFLIRcameraAx5CalibrationParameterJ1				kFLIRUniformAboutNominal(kFLIRcameraAx5CalibrationParameterJ1Nominal, kFLIRcameraAx5CalibrationParameterJ1HalfWidth)
+#define	kFLIRcameraAx5CalibrationParameterJ0Nominal			(89.796)
+#define	kFLIRcameraAx5CalibrationParameterJ0HalfWidth			(0.0005)
+#define	kFLIRcameraAx5CalibrationParameterJ0				kFLIRUniformAboutNominal(kFLIRcameraAx5CalibrationParameterJ0Nominal, kFLIRcameraAx5CalibrationParameterJ0HalfWidth)
 
 /*
  *	Input Distributions:
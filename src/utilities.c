@@ -24,9 +24,252 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <inttypes.h>
 #include <uxhw.h>
 #include "common.h"
 #include "utilities.h"
+#include "lookup-table.h"
+#include "conversion.h"
+#include "monte-carlo.h"
+#include "instrumentation.h"
+#include "json-writer.h"
+#include "exceedance.h"
+#include "incremental-conversion.h"
+#include "region-statistics.h"
+
+/*
+ *	Percentiles reported by the streaming statistics mode.
+ */
+static const double	kStreamingStatisticsPercentileProbabilities[] = {0.01, 0.05, 0.25, 0.50, 0.75, 0.95, 0.99};
+enum
+{
+	kStreamingStatisticsNumberOfPercentiles	= sizeof(kStreamingStatisticsPercentileProbabilities) / sizeof(kStreamingStatisticsPercentileProbabilities[0]),
+};
+
+enum
+{
+	/*
+	 *	JSON variables appended by `printJSONVariablesWithInstrumentation()`.
+	 */
+	kInstrumentationNumberOfJSONVariables	= 3,
+	kInstrumentationMaximumJSONVariables	= 16,
+	/*
+	 *	JSON variables set by `setStatisticsSummaryJSONVariables()`.
+	 */
+	kStatisticsSummaryNumberOfJSONVariables	= 5,
+	/*
+	 *	The `-pt` thresholds and their probabilities of being exceeded.
+	 */
+	kExceedanceNumberOfJSONVariables	= 2,
+};
+
+/*
+ *	The mean, variance, range and percentiles printed for streaming statistics
+ *	and for `-jh`.
+ */
+typedef struct
+{
+	double	mean;
+	double	variance;
+	double	minimum;
+	double	maximum;
+	double	percentiles[kStreamingStatisticsNumberOfPercentiles];
+} StatisticsSummary;
+
+/*
+ *	Fills `summary` from `statistics`, and sets the first
+ *	`kStatisticsSummaryNumberOfJSONVariables` of `variables` to point into it.
+ */
+static void
+setStatisticsSummaryJSONVariables(const StreamingStatistics *  statistics, StatisticsSummary *  summary, JSONVariable *  variables)
+{
+	summary->mean = statistics->moments.mean;
+	summary->variance = streamingStatisticsVariance(statistics);
+	summary->minimum = statistics->moments.minimum;
+	summary->maximum = statistics->moments.maximum;
+	streamingStatisticsQuantiles(statistics, kStreamingStatisticsPercentileProbabilities, kStreamingStatisticsNumberOfPercentiles, summary->percentiles);
+
+	variables[0] = (JSONVariable){ .variableSymbol = "calibratedSensorOutputMean", .variableDescription = "Mean", .values = (JSONVariablePointer){ .asDouble = &summary->mean }, .type = kJSONVariableTypeDouble, .size = 1 };
+	variables[1] = (JSONVariable){ .variableSymbol = "calibratedSensorOutputVariance", .variableDescription = "Variance", .values = (JSONVariablePointer){ .asDouble = &summary->variance }, .type = kJSONVariableTypeDouble, .size = 1 };
+	variables[2] = (JSONVariable){ .variableSymbol = "calibratedSensorOutputMinimum", .variableDescription = "Minimum", .values = (JSONVariablePointer){ .asDouble = &summary->minimum }, .type = kJSONVariableTypeDouble, .size = 1 };
+	variables[3] = (JSONVariable){ .variableSymbol = "calibratedSensorOutputMaximum", .variableDescription = "Maximum", .values = (JSONVariablePointer){ .asDouble = &summary->maximum }, .type = kJSONVariableTypeDouble, .size = 1 };
+	variables[4] = (JSONVariable){ .variableSymbol = "calibratedSensorOutputPercentiles", .variableDescription = "Percentiles 1, 5, 25, 50, 75, 95, 99", .values = (JSONVariablePointer){ .asDouble = summary->percentiles }, .type = kJSONVariableTypeDouble, .size = kStreamingStatisticsNumberOfPercentiles };
+
+	return;
+}
+
+/*
+ *	Prints `variables`, followed by the per-stage call counts, estimated
+ *	times and bytes when instrumentation is compiled in. In MonteCarlo Mode the
+ *	values are plain doubles, so they go through the buffered JSON writer, with
+ *	at most `maximumValues` values of the first variable, the samples (zero for
+ *	all), and the time it takes is reported as the serialization stage.
+ */
+static void
+printJSONVariablesWithInstrumentation(
+	const CommandLineArguments *	arguments,
+	const JSONVariable *		variables,
+	size_t				numberOfVariables,
+	size_t				maximumValues,
+	const char *			title)
+{
+	InstrumentationCounters *	counters = instrumentationGetProcessCounters();
+	JSONVariable			allVariables[kInstrumentationMaximumJSONVariables + kInstrumentationNumberOfJSONVariables];
+	double				stageCalls[kInstrumentationStageMax];
+	double				stageSeconds[kInstrumentationStageMax];
+	double				stageBytes[kInstrumentationStageMax];
+	size_t				numberOfAllVariables = numberOfVariables;
+	JSONWriter			writer;
+	double				stageStart;
+
+	memcpy(allVariables, variables, numberOfVariables * sizeof(JSONVariable));
+
+	if (arguments->common.isMonteCarloMode)
+	{
+		stageStart = instrumentationNow();
+		jsonWriterBeginDocument(&writer, stdout, title);
+
+		for (size_t i = 0; i < numberOfVariables; i++)
+		{
+			jsonWriterAppendVariable(&writer, &variables[i], (i == 0) ? maximumValues : 0, arguments->jsonSignificantDigits);
+		}
+
+		jsonWriterFlush(&writer);
+		instrumentationStop(counters, kInstrumentationStageSerialization, writer.valuesWritten, stageStart);
+		instrumentationAddBytes(counters, kInstrumentationStageSerialization, writer.bytesWritten);
+	}
+
+	if (kInstrumentationEnabled)
+	{
+		for (int stage = 0; stage < kInstrumentationStageMax; stage++)
+		{
+			stageCalls[stage] = (double) counters->calls[stage];
+			stageSeconds[stage] = instrumentationEstimatedSeconds(counters, (InstrumentationStage) stage);
+			stageBytes[stage] = (double) counters->bytes[stage];
+		}
+
+		allVariables[numberOfAllVariables++] = (JSONVariable)
+		{
+			.variableSymbol = "instrumentationStageCalls",
+			.variableDescription = "Calls of input sampling, radiance terms, conversion (log), mean and variance, output writing, JSON serialization",
+			.values = (JSONVariablePointer){ .asDouble = stageCalls },
+			.type = kJSONVariableTypeDouble,
+			.size = kInstrumentationStageMax,
+		};
+		allVariables[numberOfAllVariables++] = (JSONVariable)
+		{
+			.variableSymbol = "instrumentationStageSeconds",
+			.variableDescription = "Seconds in input sampling, radiance terms, conversion (log), mean and variance, output writing, JSON serialization",
+			.values = (JSONVariablePointer){ .asDouble = stageSeconds },
+			.type = kJSONVariableTypeDouble,
+			.size = kInstrumentationStageMax,
+		};
+		allVariables[numberOfAllVariables++] = (JSONVariable)
+		{
+			.variableSymbol = "instrumentationStageBytes",
+			.variableDescription = "Bytes written by input sampling, radiance terms, conversion (log), mean and variance, output writing, JSON serialization",
+			.values = (JSONVariablePointer){ .asDouble = stageBytes },
+			.type = kJSONVariableTypeDouble,
+			.size = kInstrumentationStageMax,
+		};
+	}
+
+	if (!arguments->common.isMonteCarloMode)
+	{
+		printJSONVariables(allVariables, numberOfAllVariables, title);
+
+		return;
+	}
+
+	for (size_t i = numberOfVariables; i < numberOfAllVariables; i++)
+	{
+		jsonWriterAppendVariable(&writer, &allVariables[i], 0, kJSONWriterShortestRoundTrip);
+	}
+
+	jsonWriterFinish(&writer);
+
+	return;
+}
+
+/*
+ *	Prints the mean, variance, range and percentiles of the Monte Carlo samples,
+ *	and a histogram of `arguments->jsonHistogramBins` equal bins over their
+ *	range, instead of the samples themselves, followed by `extraVariables`.
+ */
+static void
+printJSONHistogramSummary(
+	const CommandLineArguments *	arguments,
+	const double *			samples,
+	size_t				numberOfSamples,
+	const JSONVariable *		extraVariables,
+	size_t				numberOfExtraVariables)
+{
+	InstrumentationCounters *	counters = instrumentationGetProcessCounters();
+	StreamingStatistics		statistics;
+	StatisticsSummary		summary;
+	JSONVariable			variables[kStatisticsSummaryNumberOfJSONVariables + 2 + kExceedanceNumberOfJSONVariables];
+	size_t				numberOfBins = arguments->jsonHistogramBins;
+	double *			binEdges = (double *) checkedMalloc((numberOfBins + 1) * sizeof(double), __FILE__, __LINE__);
+	double *			binCounts = (double *) checkedMalloc(numberOfBins * sizeof(double), __FILE__, __LINE__);
+	double				binWidth;
+	double				stageStart;
+
+	memset(binCounts, 0, numberOfBins * sizeof(double));
+
+	stageStart = instrumentationNow();
+	streamingStatisticsInit(&statistics);
+	streamingStatisticsAdd(&statistics, samples, numberOfSamples);
+	setStatisticsSummaryJSONVariables(&statistics, &summary, variables);
+
+	binWidth = (summary.maximum - summary.minimum) / numberOfBins;
+
+	for (size_t i = 0; i <= numberOfBins; i++)
+	{
+		binEdges[i] = summary.minimum + i * binWidth;
+	}
+
+	/*
+	 *	The last bin includes the maximum. All samples fall in the first bin if they are all equal.
+	 */
+	for (size_t i = 0; i < numberOfSamples; i++)
+	{
+		size_t	bin = (binWidth > 0) ? (size_t) ((samples[i] - summary.minimum) / binWidth) : 0;
+
+		binCounts[(bin < numberOfBins) ? bin : numberOfBins - 1]++;
+	}
+	instrumentationStop(counters, kInstrumentationStageStatistics, numberOfSamples, stageStart);
+
+	variables[kStatisticsSummaryNumberOfJSONVariables] = (JSONVariable)
+	{
+		.variableSymbol = "calibratedSensorOutputHistogramBinEdges",
+		.variableDescription = "Edges of the histogram bins",
+		.values = (JSONVariablePointer){ .asDouble = binEdges },
+		.type = kJSONVariableTypeDouble,
+		.size = numberOfBins + 1,
+	};
+	variables[kStatisticsSummaryNumberOfJSONVariables + 1] = (JSONVariable)
+	{
+		.variableSymbol = "calibratedSensorOutputHistogramCounts",
+		.variableDescription = "Number of samples in each histogram bin",
+		.values = (JSONVariablePointer){ .asDouble = binCounts },
+		.type = kJSONVariableTypeDouble,
+		.size = numberOfBins,
+	};
+
+	memcpy(&variables[kStatisticsSummaryNumberOfJSONVariables + 2], extraVariables, numberOfExtraVariables * sizeof(JSONVariable));
+	printJSONVariablesWithInstrumentation(
+		arguments,
+		variables,
+		kStatisticsSummaryNumberOfJSONVariables + 2 + numberOfExtraVariables,
+		0,
+		"Lepton FLIR Sensor Calibration");
+
+	streamingStatisticsFree(&statistics);
+	free(binCounts);
+	free(binEdges);
+
+	return;
+}
 
 void
 printUsage(void)
@@ -35,7 +278,8 @@ printUsage(void)
 	fprintf(stderr, "Usage: Valid command-line arguments are:\n");
 	fprintf(
 		stderr,
-		"\t[-o, --output <Path to output CSV file : str>] (Specify the output file.)\n"
+		"\t[-i, --input <Path to raw frame file : str>] (Convert every frame of a little-endian uint16 raw frame file, memory-mapped.)\n"
+		"\t[-o, --output <Path to output CSV file : str>] (Specify the output file. With -i, a raw float64 (or -f32 float32) temperature file.)\n"
 		"\t[-S, --select-output <output : int>] (Compute 0-indexed output, by default 0.)\n"
 		"\t[-M, --multiple-executions <Number of executions : int (Default: 1)>] (Repeated execute kernel for benchmarking.)\n"
 		"\t[-T, --time] (Timing mode: Times and prints the timing of the kernel execution.)\n"
@@ -46,12 +290,79 @@ printUsage(void)
 	 *	Print demo specific options usage
 	 */
 	fprintf(stderr,
-		"\t[-sp, --sensor-parameter <particle value used to override default distribution for `counts`: double>]\n");
+		"\t[-sp, --sensor-parameter <particle value used to override default distribution for `counts`: double>]\n"
+		"\t[-lut, --lookup-table] (Convert the `-sp` count, or the `-i` frames, through a 65536-entry table built from the nominal calibration, and report the table's cost and accuracy.)\n"
+		"\t[-th, --threads <Number of Monte Carlo worker threads, 0 for all processors : int (Default: 1)>]\n"
+		"\t[-rs, --random-seed <Seed of the Monte Carlo random number streams : int>]\n"
+		"\t[-ss, --streaming-statistics] (With -M: report mean, variance and percentiles in O(1) memory, without storing samples or writing data.out.)\n"
+		"\t[-fs, --frame-stream] (Convert a raw frame stream from `-i` or stdin to `-o` or stdout, overlapping reading, conversion and writing, and report latency to stderr.)\n"
+		"\t[-rt, --real-time] (With -fs: drop frames that arrive while all buffers are busy, instead of blocking the producer.)\n"
+		"\t[-dm, --delta-method] (Propagate the input uncertainty to first order from analytic derivatives, and compare with -M Monte Carlo iterations (Default: 100000). With -i: per-pixel standard deviations.)\n"
+		"\t[-bs, --binary-samples <Path to binary sample file : str>] (With -M: write the samples as little-endian float64 after a 64-byte header, for mmap, instead of data.out.)\n"
+		"\t[-bsf, --binary-samples-float32] (With -bs: write float32 samples.)\n"
+		"\t[-jd, --json-digits <Significant digits of the -j -M values, 1 to 17 : int (Default: shortest that reads back exactly)>]\n"
+		"\t[-jn, --json-samples <Number of evenly spaced -M samples to print with -j : int (Default: all)>]\n"
+		"\t[-jh, --json-histogram <Number of histogram bins : int>] (With -j -M: print the mean, variance, range, percentiles and a histogram instead of the samples.)\n"
+		"\t[-pt, --probability-threshold <Comma-separated alarm thresholds in Kelvin : double list>] (Print the probability of exceeding each threshold. With -i -M: per-pixel probability maps.)\n"
+		"\t[-sm, --sampling-method <random | sobol | lhs : str (Default: random)>] (With -M: draw the iterations from independent pseudo-random numbers, a scrambled Sobol sequence or a Latin hypercube.)\n"
+		"\t[-smc, --sampling-method-comparison] (Compare the error of the mean and standard deviation of each sampling method over %d replications of -M iterations.)\n"
+		"\t[-tse, --target-standard-error <Kelvin : double>] (Adaptive Monte Carlo: run blocks of iterations, up to -M, until the standard errors of the mean, standard deviation and -tq quantiles are at most this.)\n"
+		"\t[-tci, --target-confidence-interval <Kelvin : double>] (As -tse, for a target half-width of the 95%% confidence intervals.)\n"
+		"\t[-tq, --target-quantiles <Comma-separated probabilities : double list>] (With -tse or -tci: quantiles that must also meet the target.)\n"
+		"\t[-f32, --float32] (With -i or -fs: convert frames in single precision, twice the pixels per instruction, and write float32 frames. With -i -M: single-precision conversion of every iteration.)\n"
+		"\t[-f32r, --float32-report] (Compare the float32 and float64 frame kernels over all 65536 counts, against a %g Kelvin tolerance, and the vectorized float64 kernel with the scalar one, against a %d ULP bound.)\n"
+		"\t[-cp, --calibration-profiles <Path to calibration profile file : str>] (Load the camera calibrations, instead of the built-in one. Camera-tagged -i frames each name their profile.)\n"
+		"\t[-cn, --calibration-profile <Profile name : str (Default: the first)>] (With -cp: the profile of every conversion other than that of camera-tagged frames.)\n"
+		"\t[-mt, --material-table <Path to material table file : str>] (With -i and -mm: the emissivity, Tau, TRefl and TAtmC of each material label.)\n"
+		"\t[-mm, --material-map <Path to material map file : str>] (With -i and -mt: the uint8 material label of every pixel.)\n"
+		"\t[-inc, --incremental <Count tolerance, 0 for exact : int>] (With -i: convert again only the %d-pixel tiles with a count that changed by more than the tolerance since it was last converted, and report the fraction converted.)\n"
+		"\t[-roi, --regions-of-interest <Path to region of interest file : str>] (With -i: the mean, range, %d quantiles and their standard errors of each \"<name> <column> <row> <width> <height>\" rectangle of every frame.)\n"
+		"\t[-roim, --roi-mask <Path to material map file : str>] (With -i: as -roi, for the pixels of each non-zero label of the mask.)\n"
+		"\t[-at, --alarm-thresholds <Comma-separated alarm thresholds in Kelvin : double list>] (With -i: map the thresholds and their %g-standard-deviation bands to raw counts, count the pixels above each by comparing counts, and convert only those pixels.)\n"
+		"\t[-srv, --server <Path of Unix-domain socket : str>] (Stay resident and serve value, frame and Monte Carlo conversions to any number of clients with the -cp profiles, until SIGINT or SIGTERM.)\n",
+		kMonteCarloSamplingComparisonReplications,
+		kFloat32ConversionToleranceKelvin,
+		kVectorizedConversionMaximumUlpDifference,
+		kIncrementalConversionTileWidth,
+		kRegionStatisticsNumberOfQuantiles,
+		kAlarmThresholdBandStandardDeviations);
 	fprintf(stderr, "\n");
 
 	return;
 }
 
+/*
+ *	Parses a comma-separated list of at most `maximumNumberOfValues` finite numbers.
+ */
+static CommonConstantReturnType
+parseDoubleListChecked(const char *  list, double *  values, size_t maximumNumberOfValues, size_t *  numberOfValues)
+{
+	char *	copy = (char *) checkedMalloc(strlen(list) + 1, __FILE__, __LINE__);
+	char *	savePointer = NULL;
+	size_t	count = 0;
+
+	strcpy(copy, list);
+
+	for (char *  token = strtok_r(copy, ",", &savePointer); token != NULL; token = strtok_r(NULL, ",", &savePointer))
+	{
+		if ((count == maximumNumberOfValues) ||
+			(parseDoubleChecked(token, &values[count]) != kCommonConstantReturnTypeSuccess) ||
+			!isfinite(values[count]))
+		{
+			free(copy);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		count++;
+	}
+
+	free(copy);
+	*numberOfValues = count;
+
+	return (count > 0) ? kCommonConstantReturnTypeSuccess : kCommonConstantReturnTypeError;
+}
+
 static void
 setDefaultCommandLineArguments(CommandLineArguments *  arguments)
 {
@@ -76,6 +387,8 @@ setDefaultCommandLineArguments(CommandLineArguments *  arguments)
 	 *	Initialize any demo-specific command line arguments to default values
 	 */
 	arguments->countValueReadFromArgvToOverrideDefaultDistribution = kCountValueIndicatingNotSetOverride;
+	arguments->numberOfThreads = kMonteCarloDefaultNumberOfThreads;
+	arguments->randomSeed = kMonteCarloDefaultSeed;
 
 	return;
 }
@@ -88,9 +401,87 @@ getCommandLineArguments(
 {
 	const char *		sensorParameterArg = NULL;
 	bool			sensorParameterArgFound = false;
+	bool			lookupTableArgFound = false;
+	const char *		threadsArg = NULL;
+	bool			threadsArgFound = false;
+	const char *		randomSeedArg = NULL;
+	bool			randomSeedArgFound = false;
+	bool			streamingStatisticsArgFound = false;
+	bool			frameStreamArgFound = false;
+	bool			realTimeArgFound = false;
+	bool			deltaMethodArgFound = false;
+	const char *		binarySamplesArg = NULL;
+	bool			binarySamplesArgFound = false;
+	bool			binarySamplesFloat32ArgFound = false;
+	const char *		jsonDigitsArg = NULL;
+	bool			jsonDigitsArgFound = false;
+	const char *		jsonSamplesArg = NULL;
+	bool			jsonSamplesArgFound = false;
+	const char *		jsonHistogramArg = NULL;
+	bool			jsonHistogramArgFound = false;
+	const char *		probabilityThresholdArg = NULL;
+	bool			probabilityThresholdArgFound = false;
+	const char *		samplingMethodArg = NULL;
+	bool			samplingMethodArgFound = false;
+	bool			samplingMethodComparisonArgFound = false;
+	const char *		targetStandardErrorArg = NULL;
+	bool			targetStandardErrorArgFound = false;
+	const char *		targetConfidenceIntervalArg = NULL;
+	bool			targetConfidenceIntervalArgFound = false;
+	const char *		targetQuantilesArg = NULL;
+	bool			targetQuantilesArgFound = false;
+	bool			float32ArgFound = false;
+	bool			float32ReportArgFound = false;
+	const char *		calibrationProfilesArg = NULL;
+	bool			calibrationProfilesArgFound = false;
+	const char *		calibrationProfileArg = NULL;
+	bool			calibrationProfileArgFound = false;
+	const char *		materialTableArg = NULL;
+	bool			materialTableArgFound = false;
+	const char *		materialMapArg = NULL;
+	bool			materialMapArgFound = false;
+	const char *		incrementalArg = NULL;
+	bool			incrementalArgFound = false;
+	const char *		regionsOfInterestArg = NULL;
+	bool			regionsOfInterestArgFound = false;
+	const char *		regionMaskArg = NULL;
+	bool			regionMaskArgFound = false;
+	const char *		alarmThresholdsArg = NULL;
+	bool			alarmThresholdsArgFound = false;
+	const char *		serverArg = NULL;
+	bool			serverArgFound = false;
 	DemoOption		options[] =
 				{
 					{ .opt = "sp", .optAlternative = "sensor-parameter", .hasArg = true, .foundArg = &sensorParameterArg, .foundOpt = &sensorParameterArgFound },
+					{ .opt = "lut", .optAlternative = "lookup-table", .hasArg = false, .foundArg = NULL, .foundOpt = &lookupTableArgFound },
+					{ .opt = "th", .optAlternative = "threads", .hasArg = true, .foundArg = &threadsArg, .foundOpt = &threadsArgFound },
+					{ .opt = "rs", .optAlternative = "random-seed", .hasArg = true, .foundArg = &randomSeedArg, .foundOpt = &randomSeedArgFound },
+					{ .opt = "ss", .optAlternative = "streaming-statistics", .hasArg = false, .foundArg = NULL, .foundOpt = &streamingStatisticsArgFound },
+					{ .opt = "fs", .optAlternative = "frame-stream", .hasArg = false, .foundArg = NULL, .foundOpt = &frameStreamArgFound },
+					{ .opt = "rt", .optAlternative = "real-time", .hasArg = false, .foundArg = NULL, .foundOpt = &realTimeArgFound },
+					{ .opt = "dm", .optAlternative = "delta-method", .hasArg = false, .foundArg = NULL, .foundOpt = &deltaMethodArgFound },
+					{ .opt = "bs", .optAlternative = "binary-samples", .hasArg = true, .foundArg = &binarySamplesArg, .foundOpt = &binarySamplesArgFound },
+					{ .opt = "bsf", .optAlternative = "binary-samples-float32", .hasArg = false, .foundArg = NULL, .foundOpt = &binarySamplesFloat32ArgFound },
+					{ .opt = "jd", .optAlternative = "json-digits", .hasArg = true, .foundArg = &jsonDigitsArg, .foundOpt = &jsonDigitsArgFound },
+					{ .opt = "jn", .optAlternative = "json-samples", .hasArg = true, .foundArg = &jsonSamplesArg, .foundOpt = &jsonSamplesArgFound },
+					{ .opt = "jh", .optAlternative = "json-histogram", .hasArg = true, .foundArg = &jsonHistogramArg, .foundOpt = &jsonHistogramArgFound },
+					{ .opt = "pt", .optAlternative = "probability-threshold", .hasArg = true, .foundArg = &probabilityThresholdArg, .foundOpt = &probabilityThresholdArgFound },
+					{ .opt = "sm", .optAlternative = "sampling-method", .hasArg = true, .foundArg = &samplingMethodArg, .foundOpt = &samplingMethodArgFound },
+					{ .opt = "smc", .optAlternative = "sampling-method-comparison", .hasArg = false, .foundArg = NULL, .foundOpt = &samplingMethodComparisonArgFound },
+					{ .opt = "tse", .optAlternative = "target-standard-error", .hasArg = true, .foundArg = &targetStandardErrorArg, .foundOpt = &targetStandardErrorArgFound },
+					{ .opt = "tci", .optAlternative = "target-confidence-interval", .hasArg = true, .foundArg = &targetConfidenceIntervalArg, .foundOpt = &targetConfidenceIntervalArgFound },
+					{ .opt = "tq", .optAlternative = "target-quantiles", .hasArg = true, .foundArg = &targetQuantilesArg, .foundOpt = &targetQuantilesArgFound },
+					{ .opt = "f32", .optAlternative = "float32", .hasArg = false, .foundArg = NULL, .foundOpt = &float32ArgFound },
+					{ .opt = "f32r", .optAlternative = "float32-report", .hasArg = false, .foundArg = NULL, .foundOpt = &float32ReportArgFound },
+					{ .opt = "cp", .optAlternative = "calibration-profiles", .hasArg = true, .foundArg = &calibrationProfilesArg, .foundOpt = &calibrationProfilesArgFound },
+					{ .opt = "cn", .optAlternative = "calibration-profile", .hasArg = true, .foundArg = &calibrationProfileArg, .foundOpt = &calibrationProfileArgFound },
+					{ .opt = "mt", .optAlternative = "material-table", .hasArg = true, .foundArg = &materialTableArg, .foundOpt = &materialTableArgFound },
+					{ .opt = "mm", .optAlternative = "material-map", .hasArg = true, .foundArg = &materialMapArg, .foundOpt = &materialMapArgFound },
+					{ .opt = "inc", .optAlternative = "incremental", .hasArg = true, .foundArg = &incrementalArg, .foundOpt = &incrementalArgFound },
+					{ .opt = "roi", .optAlternative = "regions-of-interest", .hasArg = true, .foundArg = &regionsOfInterestArg, .foundOpt = &regionsOfInterestArgFound },
+					{ .opt = "roim", .optAlternative = "roi-mask", .hasArg = true, .foundArg = &regionMaskArg, .foundOpt = &regionMaskArgFound },
+					{ .opt = "at", .optAlternative = "alarm-thresholds", .hasArg = true, .foundArg = &alarmThresholdsArg, .foundOpt = &alarmThresholdsArgFound },
+					{ .opt = "srv", .optAlternative = "server", .hasArg = true, .foundArg = &serverArg, .foundOpt = &serverArgFound },
 					{0},
 				};
 
@@ -125,20 +516,55 @@ getCommandLineArguments(
 	}
 
 	/*
-	 *	For most of the sensor applications, we do not support reading
-	 *	from input files.
+	 *	The frame stream reads `-i` (or stdin) as a stream and writes `-o` (or
+	 *	stdout), so it is checked before the file input and output options.
 	 */
-	if (arguments->common.isInputFromFileEnabled)
+	if (frameStreamArgFound)
+	{
+		if (arguments->common.isMonteCarloMode || arguments->common.isBenchmarkingMode || arguments->common.isOutputJSONMode || sensorParameterArgFound)
+		{
+			fprintf(stderr, "Error: Frame stream mode (-fs) cannot be combined with -M, -b, -j or -sp.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isFrameStreamMode = true;
+		arguments->isRealTimeFrameStreamMode = realTimeArgFound;
+	}
+	else if (realTimeArgFound)
 	{
-		fprintf(stderr, "Reading inputs from CSV file is not currently supported\n");
+		fprintf(stderr, "Error: Real-time mode (-rt) requires frame stream mode (-fs).\n");
 
 		return kCommonConstantReturnTypeError;
 	}
 
 	/*
-	 *	Write to output file is not supported in MonteCarlo Mode.
+	 *	Input files are memory-mapped raw frame files (see `raw-frames.h`), converted
+	 *	frame by frame with the nominal calibration, or in MonteCarlo Mode with
+	 *	calibration draws shared by all pixels.
+	 */
+	if (arguments->common.isInputFromFileEnabled && !arguments->isFrameStreamMode)
+	{
+		if (arguments->common.isMonteCarloMode && (deltaMethodArgFound || streamingStatisticsArgFound))
+		{
+			fprintf(stderr, "Error: Raw frame input (-i) in MonteCarlo Mode cannot be combined with -dm or -ss.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (sensorParameterArgFound)
+		{
+			fprintf(stderr, "Error: Raw frame input (-i) takes its counts from the file and cannot be combined with -sp.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	Write to output file is not supported in MonteCarlo Mode, except for the
+	 *	per-pixel maps of raw frame input.
 	 */
-	if (arguments->common.isWriteToFileEnabled && arguments->common.isMonteCarloMode)
+	if (arguments->common.isWriteToFileEnabled && arguments->common.isMonteCarloMode && !arguments->common.isInputFromFileEnabled)
 	{
 		fprintf(stderr, "Writing to output file is not supported in MonteCarlo Mode.\n");
 
@@ -199,93 +625,1063 @@ getCommandLineArguments(
 		}
 	}
 
-	return kCommonConstantReturnTypeSuccess;
-}
+	if (lookupTableArgFound)
+	{
+		double	counts = arguments->countValueReadFromArgvToOverrideDefaultDistribution;
 
-void
-printCalibratedValueAndProbabilities(double calibratedSensorOutput, const char *  variableDescription, const char *  unitsOfMeasurement)
-{
-	/*
-	 *	Note: the calculations of the quantities involving UxHwDoubleProbabilityGT()
-	 *	are purposefully written so as to be self-explanatory and easily checkable,
-	 *	not for efficiency or "cleverness". Also, beware the "percent greater than"
-	 *	and "percent less than" are tricky for larger versus smaller so don't jump
-	 *	to conclusions when you read the code.
-	 */
-	printf("%s: %.2lf %s.\n", variableDescription, calibratedSensorOutput, unitsOfMeasurement);
-	printf("\n");
-	printf(
-		"\tProbability that calibrated sensor output is   1%% or more smaller than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
-		calibratedSensorOutput,
-		unitsOfMeasurement,
-		1 - UxHwDoubleProbabilityGT(calibratedSensorOutput, calibratedSensorOutput * (1 - 0.01)));
-	printf(
-		"\tProbability that calibrated sensor output is   2%% or more smaller than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
-		calibratedSensorOutput,
-		unitsOfMeasurement,
-		1 - UxHwDoubleProbabilityGT(calibratedSensorOutput, calibratedSensorOutput * (1 - 0.02)));
-	printf(
-		"\tProbability that calibrated sensor output is   5%% or more smaller than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
-		calibratedSensorOutput,
-		unitsOfMeasurement,
-		1 - UxHwDoubleProbabilityGT(calibratedSensorOutput, calibratedSensorOutput * (1 - 0.05)));
-	printf("\n");
-	printf(
-		"\tProbability that calibrated sensor output is   1%% or more greater than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
-		calibratedSensorOutput,
-		unitsOfMeasurement,
-		UxHwDoubleProbabilityGT(calibratedSensorOutput, 1.01 * calibratedSensorOutput));
-	printf(
-		"\tProbability that calibrated sensor output is   2%% or more greater than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
-		calibratedSensorOutput,
-		unitsOfMeasurement,
-		UxHwDoubleProbabilityGT(calibratedSensorOutput, 1.02 * calibratedSensorOutput));
-	printf(
-		"\tProbability that calibrated sensor output is   5%% or more greater than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
-		calibratedSensorOutput,
-		unitsOfMeasurement,
-		UxHwDoubleProbabilityGT(calibratedSensorOutput, 1.05 * calibratedSensorOutput));
+		/*
+		 *	The table covers integer 16-bit counts of a deterministic calibration,
+		 *	so it needs a point value for `counts`, either from `-sp` or from the
+		 *	frames of `-i`, and cannot run Monte Carlo.
+		 */
+		if (!arguments->common.isInputFromFileEnabled && !arguments->isFrameStreamMode &&
+			(isnan(counts) || (counts != floor(counts)) || (counts < 0) || (counts >= kCountsLookupTableEntries)))
+		{
+			fprintf(stderr, "Error: Lookup table mode (-lut) requires an integer `-sp` count in [0, %d].\n", kCountsLookupTableEntries - 1);
 
-	return;
-}
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Lookup table mode (-lut) is not supported in MonteCarlo Mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isLookupTableMode = true;
+	}
+
+	if (threadsArgFound)
+	{
+		int	numberOfThreads;
+
+		if ((parseIntChecked(threadsArg, &numberOfThreads) != kCommonConstantReturnTypeSuccess) || (numberOfThreads < 0))
+		{
+			fprintf(stderr, "Error: The number of threads must be a non-negative integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->numberOfThreads = (size_t) numberOfThreads;
+	}
+
+	if (randomSeedArgFound)
+	{
+		int	randomSeed;
+
+		if ((parseIntChecked(randomSeedArg, &randomSeed) != kCommonConstantReturnTypeSuccess) || (randomSeed < 0))
+		{
+			fprintf(stderr, "Error: The random seed must be a non-negative integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->randomSeed = (uint64_t) randomSeed;
+	}
+
+	if (streamingStatisticsArgFound)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Streaming statistics mode (-ss) requires MonteCarlo Mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isStreamingStatisticsMode = true;
+	}
+
+	if (deltaMethodArgFound)
+	{
+		if (arguments->isFrameStreamMode || arguments->isLookupTableMode || arguments->isStreamingStatisticsMode || arguments->common.isBenchmarkingMode)
+		{
+			fprintf(stderr, "Error: Delta method mode (-dm) cannot be combined with -fs, -lut, -ss or -b.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isDeltaMethodMode = true;
+	}
 
-void
-printJSONFormattedOutput(
-	CommandLineArguments *	arguments,
-	double *		outputVariable,
-	double *		monteCarloOutputSamples,
-	const char *		variableDescription)
-{
 	/*
-	 *	If in Monte Carlo mode, `pointerToOutputVariable` points to the beginning
-	 *	of the `monteCarloOutputSamples` array. In this case, `arguments.common.numberOfMonteCarloIterations`
-	 *	is the length of the `monteCarloOutputSamples` array. If not in Monte Carlo mode,
-	 *	`pointerToOutputVariable` points to the `outputVariable` to be used.
+	 *	The binary sample file replaces `data.out`, so it needs the stored samples
+	 *	of a single-value MonteCarlo Mode run.
 	 */
-	double *	pointerToOutputVariable = (arguments->common.isMonteCarloMode) ? monteCarloOutputSamples : outputVariable;
+	if (binarySamplesArgFound)
+	{
+		if (!arguments->common.isMonteCarloMode || arguments->isStreamingStatisticsMode || arguments->isDeltaMethodMode || arguments->common.isInputFromFileEnabled)
+		{
+			fprintf(stderr, "Error: Binary sample output (-bs) requires MonteCarlo Mode (-M) and cannot be combined with -ss, -dm or -i.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->binarySamplesPath = binarySamplesArg;
+		arguments->isBinarySamplesFloat32 = binarySamplesFloat32ArgFound;
+	}
+	else if (binarySamplesFloat32ArgFound)
+	{
+		fprintf(stderr, "Error: Float32 binary samples (-bsf) require binary sample output (-bs).\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
 	/*
-	 *	Print json formatted output.
+	 *	The JSON output options apply to the buffered JSON writer, which prints the
+	 *	plain double samples of MonteCarlo Mode.
 	 */
-	JSONVariable variables[] =
+	if (jsonDigitsArgFound || jsonSamplesArgFound || jsonHistogramArgFound)
 	{
+		if (!arguments->common.isOutputJSONMode || !arguments->common.isMonteCarloMode || arguments->isDeltaMethodMode || arguments->common.isInputFromFileEnabled)
 		{
-			.variableSymbol = "calibratedSensorOutput",
-			.variableDescription = "",
-			.values = (JSONVariablePointer){ .asDouble = pointerToOutputVariable },
-			.type = kJSONVariableTypeDouble,
-			.size = arguments->common.numberOfMonteCarloIterations
-		},
-	};
+			fprintf(stderr, "Error: JSON output options (-jd, -jn, -jh) require -j and MonteCarlo Mode (-M), and cannot be combined with -dm or -i.\n");
 
-	strncpy(
-		variables[kOutputDistributionIndexCalibratedSensorOutput].variableDescription,
-		variableDescription,
-		kCommonConstantMaxCharsPerJSONVariableDescription);
+			return kCommonConstantReturnTypeError;
+		}
 
-	printJSONVariables(
-		variables,
-		kOutputDistributionIndexMax,
-		"Lepton FLIR Sensor Calibration");
+		if ((jsonSamplesArgFound || jsonHistogramArgFound) && arguments->isStreamingStatisticsMode)
+		{
+			fprintf(stderr, "Error: JSON sample options (-jn, -jh) need the stored samples and cannot be combined with -ss.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (jsonSamplesArgFound && jsonHistogramArgFound)
+		{
+			fprintf(stderr, "Error: -jn and -jh cannot be combined.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (jsonDigitsArgFound)
+	{
+		int	significantDigits;
+
+		if ((parseIntChecked(jsonDigitsArg, &significantDigits) != kCommonConstantReturnTypeSuccess) ||
+			(significantDigits < 1) || (significantDigits > kJSONWriterRoundTripDigits))
+		{
+			fprintf(stderr, "Error: The number of JSON significant digits must be an integer in [1, %d].\n", kJSONWriterRoundTripDigits);
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->jsonSignificantDigits = significantDigits;
+	}
+
+	if (jsonSamplesArgFound)
+	{
+		int	maximumSamples;
+
+		if ((parseIntChecked(jsonSamplesArg, &maximumSamples) != kCommonConstantReturnTypeSuccess) || (maximumSamples < 1))
+		{
+			fprintf(stderr, "Error: The number of JSON samples must be a positive integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->jsonMaximumSamples = (size_t) maximumSamples;
+	}
+
+	if (jsonHistogramArgFound)
+	{
+		int	histogramBins;
+
+		if ((parseIntChecked(jsonHistogramArg, &histogramBins) != kCommonConstantReturnTypeSuccess) || (histogramBins < 1))
+		{
+			fprintf(stderr, "Error: The number of histogram bins must be a positive integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->jsonHistogramBins = (size_t) histogramBins;
+	}
+
+	/*
+	 *	The exceedance probabilities are read from the stored samples of MonteCarlo Mode,
+	 *	or from the distribution on Signaloid platforms, and per pixel for `-i -M`.
+	 */
+	if (probabilityThresholdArgFound)
+	{
+		if (arguments->isFrameStreamMode || arguments->isStreamingStatisticsMode || arguments->isDeltaMethodMode || arguments->common.isBenchmarkingMode ||
+			(arguments->common.isInputFromFileEnabled && !arguments->common.isMonteCarloMode))
+		{
+			fprintf(stderr, "Error: Probability thresholds (-pt) cannot be combined with -fs, -ss, -dm or -b, and require MonteCarlo Mode (-M) with -i.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (parseDoubleListChecked(
+			probabilityThresholdArg,
+			arguments->exceedanceThresholds,
+			kExceedanceMaximumThresholds,
+			&arguments->numberOfExceedanceThresholds) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: The probability thresholds must be a comma-separated list of at most %d numbers.\n", kExceedanceMaximumThresholds);
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (samplingMethodArgFound)
+	{
+		if (!arguments->common.isMonteCarloMode || samplingMethodComparisonArgFound)
+		{
+			fprintf(stderr, "Error: The sampling method (-sm) requires MonteCarlo Mode (-M), and cannot be combined with -smc.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (strcmp(samplingMethodArg, "random") == 0)
+		{
+			arguments->samplingMethod = kMonteCarloSamplingMethodPseudoRandom;
+		}
+		else if (strcmp(samplingMethodArg, "sobol") == 0)
+		{
+			arguments->samplingMethod = kMonteCarloSamplingMethodSobol;
+		}
+		else if (strcmp(samplingMethodArg, "lhs") == 0)
+		{
+			arguments->samplingMethod = kMonteCarloSamplingMethodLatinHypercube;
+		}
+		else
+		{
+			fprintf(stderr, "Error: The sampling method must be one of random, sobol or lhs.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (samplingMethodComparisonArgFound)
+	{
+		if (!arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled || arguments->isStreamingStatisticsMode ||
+			arguments->isDeltaMethodMode || arguments->common.isBenchmarkingMode || (arguments->binarySamplesPath != NULL) ||
+			(arguments->numberOfExceedanceThresholds > 0) || jsonSamplesArgFound || jsonHistogramArgFound)
+		{
+			fprintf(stderr, "Error: Sampling method comparison (-smc) requires MonteCarlo Mode (-M), and cannot be combined with -i, -ss, -dm, -b, -bs, -pt, -jn or -jh.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isSamplingMethodComparisonMode = true;
+	}
+
+	/*
+	 *	Adaptive Monte Carlo estimates its errors from the spread of independent samples,
+	 *	so it uses pseudo-random sampling, and `-M` is the largest number of iterations.
+	 */
+	if (targetStandardErrorArgFound || targetConfidenceIntervalArgFound)
+	{
+		double	target;
+
+		if (!arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled || arguments->isStreamingStatisticsMode ||
+			arguments->isDeltaMethodMode || arguments->common.isBenchmarkingMode || (arguments->binarySamplesPath != NULL) ||
+			(arguments->numberOfExceedanceThresholds > 0) || jsonSamplesArgFound || jsonHistogramArgFound ||
+			arguments->isSamplingMethodComparisonMode || (arguments->samplingMethod != kMonteCarloSamplingMethodPseudoRandom))
+		{
+			fprintf(stderr, "Error: Adaptive Monte Carlo (-tse, -tci) requires MonteCarlo Mode (-M), and cannot be combined with -i, -ss, -dm, -b, -bs, -pt, -jn, -jh, -smc or quasi-random -sm.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (targetStandardErrorArgFound && targetConfidenceIntervalArgFound)
+		{
+			fprintf(stderr, "Error: -tse and -tci cannot be combined.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((parseDoubleChecked(targetStandardErrorArgFound ? targetStandardErrorArg : targetConfidenceIntervalArg, &target) != kCommonConstantReturnTypeSuccess) ||
+			!(target > 0) || isinf(target))
+		{
+			fprintf(stderr, "Error: The target standard error or confidence interval half-width must be a positive number.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->targetStandardError = targetStandardErrorArgFound ? target : target / kMonteCarloAdaptiveConfidenceIntervalZ;
+	}
+
+	if (targetQuantilesArgFound)
+	{
+		if (arguments->targetStandardError == 0)
+		{
+			fprintf(stderr, "Error: Target quantiles (-tq) require -tse or -tci.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (parseDoubleListChecked(
+			targetQuantilesArg,
+			arguments->targetQuantileProbabilities,
+			kMonteCarloAdaptiveMaximumQuantiles,
+			&arguments->numberOfTargetQuantiles) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: The target quantiles must be a comma-separated list of at most %d probabilities.\n", kMonteCarloAdaptiveMaximumQuantiles);
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		for (size_t i = 0; i < arguments->numberOfTargetQuantiles; i++)
+		{
+			if (!(arguments->targetQuantileProbabilities[i] > 0) || !(arguments->targetQuantileProbabilities[i] < 1))
+			{
+				fprintf(stderr, "Error: The target quantile probabilities must be in (0, 1).\n");
+
+				return kCommonConstantReturnTypeError;
+			}
+		}
+	}
+
+	/*
+	 *	The float32 kernels convert frames through the calibration context, so they
+	 *	replace the float64 vectorized kernel, but not the lookup table.
+	 */
+	if (float32ArgFound)
+	{
+		if ((!arguments->common.isInputFromFileEnabled && !arguments->isFrameStreamMode) || arguments->isLookupTableMode || arguments->isDeltaMethodMode)
+		{
+			fprintf(stderr, "Error: Float32 conversion (-f32) requires -i or -fs, and cannot be combined with -lut or -dm.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->precision = kConversionPrecisionFloat32;
+	}
+
+	if (float32ReportArgFound)
+	{
+		if (arguments->common.isInputFromFileEnabled || arguments->isFrameStreamMode || arguments->common.isMonteCarloMode ||
+			arguments->isLookupTableMode || arguments->isDeltaMethodMode || float32ArgFound)
+		{
+			fprintf(stderr, "Error: The float32 report (-f32r) cannot be combined with -i, -fs, -M, -lut, -dm or -f32.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isFloat32ReportMode = true;
+	}
+
+	/*
+	 *	Materials change the count terms of the float64 vectorized kernel pixel by pixel,
+	 *	so they apply to the plain conversion of `-i` frames only.
+	 */
+	if (materialTableArgFound || materialMapArgFound)
+	{
+		if (!materialTableArgFound || !materialMapArgFound || !arguments->common.isInputFromFileEnabled || arguments->isFrameStreamMode ||
+			arguments->common.isMonteCarloMode || arguments->isDeltaMethodMode || arguments->isLookupTableMode ||
+			(arguments->precision == kConversionPrecisionFloat32))
+		{
+			fprintf(stderr, "Error: Material conversion requires both -mt and -mm with -i, and cannot be combined with -fs, -M, -dm, -lut or -f32.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->materialTablePath = materialTableArg;
+		arguments->materialMapPath = materialMapArg;
+	}
+
+	/*
+	 *	Monte Carlo frames are statistics of whole frames, so only the per-pixel
+	 *	conversions of `-i` can skip unchanged pixels.
+	 */
+	if (incrementalArgFound)
+	{
+		int	countTolerance;
+
+		if (!arguments->common.isInputFromFileEnabled || arguments->isFrameStreamMode || arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Incremental conversion (-inc) requires -i, and cannot be combined with -fs or -M.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((parseIntChecked(incrementalArg, &countTolerance) != kCommonConstantReturnTypeSuccess) || (countTolerance < 0) || (countTolerance > UINT16_MAX))
+		{
+			fprintf(stderr, "Error: The incremental count tolerance must be an integer in [0, %d].\n", UINT16_MAX);
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isIncrementalMode = true;
+		arguments->incrementalCountTolerance = (uint16_t) countTolerance;
+	}
+
+	/*
+	 *	Regions of interest are accumulated while `-i` frames are converted.
+	 */
+	if (regionsOfInterestArgFound || regionMaskArgFound)
+	{
+		if (!arguments->common.isInputFromFileEnabled || arguments->isFrameStreamMode)
+		{
+			fprintf(stderr, "Error: Regions of interest (-roi and -roim) require -i, and cannot be combined with -fs.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->regionsOfInterestPath = regionsOfInterestArg;
+		arguments->regionMaskPath = regionMaskArg;
+	}
+
+	/*
+	 *	The alarm mode converts only the pixels above a threshold, so it cannot feed
+	 *	the modes that need every pixel's temperature.
+	 */
+	if (alarmThresholdsArgFound)
+	{
+		if (!arguments->common.isInputFromFileEnabled || arguments->isFrameStreamMode || arguments->common.isMonteCarloMode ||
+			arguments->isDeltaMethodMode || arguments->isLookupTableMode || (arguments->precision == kConversionPrecisionFloat32) ||
+			(arguments->materialMapPath != NULL) || arguments->isIncrementalMode || regionsOfInterestArgFound || regionMaskArgFound)
+		{
+			fprintf(stderr, "Error: Alarm thresholds (-at) require -i, and cannot be combined with -fs, -M, -dm, -lut, -f32, -mt, -mm, -inc, -roi or -roim.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (parseDoubleListChecked(
+			alarmThresholdsArg,
+			arguments->alarmThresholds,
+			kAlarmThresholdsMaximum,
+			&arguments->numberOfAlarmThresholds) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: The alarm thresholds must be a comma-separated list of at most %d numbers.\n", kAlarmThresholdsMaximum);
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	The server takes its counts and frames from its clients, and answers them
+	 *	over the socket, so it has no input, output or report of its own.
+	 */
+	if (serverArgFound)
+	{
+		if (arguments->common.isInputFromFileEnabled || arguments->common.isWriteToFileEnabled || arguments->isFrameStreamMode ||
+			arguments->common.isMonteCarloMode || arguments->isDeltaMethodMode || arguments->isLookupTableMode ||
+			(arguments->precision == kConversionPrecisionFloat32) || arguments->common.isBenchmarkingMode ||
+			arguments->common.isOutputJSONMode || sensorParameterArgFound)
+		{
+			fprintf(stderr, "Error: Server mode (-srv) cannot be combined with -i, -o, -fs, -M, -dm, -lut, -f32, -b, -j or -sp.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->serverSocketPath = serverArg;
+	}
+
+	if (calibrationProfileArgFound && !calibrationProfilesArgFound)
+	{
+		fprintf(stderr, "Error: Selecting a calibration profile (-cn) requires a calibration profile file (-cp).\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	The profiles are loaded last, so that no earlier error leaves them allocated.
+	 */
+	if (calibrationProfilesArgFound)
+	{
+		if (calibrationProfileSetLoad(&arguments->calibrationProfiles, calibrationProfilesArg) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+	else
+	{
+		calibrationProfileSetInitDefault(&arguments->calibrationProfiles);
+	}
+
+	arguments->calibrationProfile = calibrationProfileArgFound ?
+						calibrationProfileSetFind(&arguments->calibrationProfiles, calibrationProfileArg) :
+						calibrationProfileSetGet(&arguments->calibrationProfiles, 0);
+	if (arguments->calibrationProfile == NULL)
+	{
+		fprintf(stderr, "Error: Calibration profile \"%s\" is not in \"%s\".\n", calibrationProfileArg, calibrationProfilesArg);
+		calibrationProfileSetFree(&arguments->calibrationProfiles);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+freeCommandLineArguments(CommandLineArguments *  arguments)
+{
+	calibrationProfileSetFree(&arguments->calibrationProfiles);
+	arguments->calibrationProfile = NULL;
+
+	return;
+}
+
+/*
+ *	The probability that `value` is greater than `threshold`. The native Monte Carlo
+ *	samples are plain doubles, so their probabilities come from the sorted samples.
+ */
+static double
+probabilityGT(const ExceedanceTable *  exceedanceTable, double value, double threshold)
+{
+	if (exceedanceTable != NULL)
+	{
+		return exceedanceTableProbabilityGT(exceedanceTable, threshold);
+	}
+
+	return UxHwDoubleProbabilityGT(value, threshold);
+}
+
+void
+printCalibratedValueAndProbabilities(
+	const CommandLineArguments *	arguments,
+	double				calibratedSensorOutput,
+	const ExceedanceTable *		exceedanceTable,
+	const char *			variableDescription,
+	const char *			unitsOfMeasurement)
+{
+	/*
+	 *	Note: the calculations of the quantities involving probabilityGT()
+	 *	are purposefully written so as to be self-explanatory and easily checkable,
+	 *	not for efficiency or "cleverness". Also, beware the "percent greater than"
+	 *	and "percent less than" are tricky for larger versus smaller so don't jump
+	 *	to conclusions when you read the code.
+	 */
+	printf("%s: %.2lf %s.\n", variableDescription, calibratedSensorOutput, unitsOfMeasurement);
+	printf("\n");
+	printf(
+		"\tProbability that calibrated sensor output is   1%% or more smaller than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
+		calibratedSensorOutput,
+		unitsOfMeasurement,
+		1 - probabilityGT(exceedanceTable, calibratedSensorOutput, calibratedSensorOutput * (1 - 0.01)));
+	printf(
+		"\tProbability that calibrated sensor output is   2%% or more smaller than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
+		calibratedSensorOutput,
+		unitsOfMeasurement,
+		1 - probabilityGT(exceedanceTable, calibratedSensorOutput, calibratedSensorOutput * (1 - 0.02)));
+	printf(
+		"\tProbability that calibrated sensor output is   5%% or more smaller than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
+		calibratedSensorOutput,
+		unitsOfMeasurement,
+		1 - probabilityGT(exceedanceTable, calibratedSensorOutput, calibratedSensorOutput * (1 - 0.05)));
+	printf("\n");
+	printf(
+		"\tProbability that calibrated sensor output is   1%% or more greater than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
+		calibratedSensorOutput,
+		unitsOfMeasurement,
+		probabilityGT(exceedanceTable, calibratedSensorOutput, 1.01 * calibratedSensorOutput));
+	printf(
+		"\tProbability that calibrated sensor output is   2%% or more greater than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
+		calibratedSensorOutput,
+		unitsOfMeasurement,
+		probabilityGT(exceedanceTable, calibratedSensorOutput, 1.02 * calibratedSensorOutput));
+	printf(
+		"\tProbability that calibrated sensor output is   5%% or more greater than %.2"SignaloidParticleModifier"lf %s, is %.6"SignaloidParticleModifier"lf\n",
+		calibratedSensorOutput,
+		unitsOfMeasurement,
+		probabilityGT(exceedanceTable, calibratedSensorOutput, 1.05 * calibratedSensorOutput));
+
+	if (arguments->numberOfExceedanceThresholds > 0)
+	{
+		printf("\n");
+	}
+
+	for (size_t i = 0; i < arguments->numberOfExceedanceThresholds; i++)
+	{
+		printf(
+			"\tProbability that calibrated sensor output is greater than %.2lf %s, is %.6"SignaloidParticleModifier"lf\n",
+			arguments->exceedanceThresholds[i],
+			unitsOfMeasurement,
+			probabilityGT(exceedanceTable, calibratedSensorOutput, arguments->exceedanceThresholds[i]));
+	}
+
+	if ((exceedanceTable != NULL) && arguments->common.isTimingEnabled)
+	{
+		printf("\n\tSorted %zu samples for the probabilities in %.3lf milliseconds.\n", exceedanceTable->numberOfSamples, 1e3 * exceedanceTable->buildTimeSeconds);
+	}
+
+	return;
+}
+
+void
+printJSONFormattedOutput(
+	CommandLineArguments *		arguments,
+	double *			outputVariable,
+	double *			monteCarloOutputSamples,
+	const ExceedanceTable *		exceedanceTable,
+	const char *			variableDescription)
+{
+	/*
+	 *	If in Monte Carlo mode, `pointerToOutputVariable` points to the beginning
+	 *	of the `monteCarloOutputSamples` array. In this case, `arguments.common.numberOfMonteCarloIterations`
+	 *	is the length of the `monteCarloOutputSamples` array. If not in Monte Carlo mode,
+	 *	`pointerToOutputVariable` points to the `outputVariable` to be used.
+	 */
+	double *	pointerToOutputVariable = (arguments->common.isMonteCarloMode) ? monteCarloOutputSamples : outputVariable;
+	size_t		numberOfSamples = arguments->common.numberOfMonteCarloIterations;
+	size_t		numberOfExceedanceVariables = (arguments->numberOfExceedanceThresholds > 0) ? kExceedanceNumberOfJSONVariables : 0;
+	double		exceedanceProbabilities[kExceedanceMaximumThresholds];
+	/*
+	 *	Print json formatted output.
+	 */
+	JSONVariable variables[] =
+	{
+		{
+			.variableSymbol = "calibratedSensorOutput",
+			.variableDescription = "",
+			.values = (JSONVariablePointer){ .asDouble = pointerToOutputVariable },
+			.type = kJSONVariableTypeDouble,
+			.size = numberOfSamples
+		},
+		{
+			.variableSymbol = "exceedanceThresholds",
+			.variableDescription = "Alarm thresholds",
+			.values = (JSONVariablePointer){ .asDouble = arguments->exceedanceThresholds },
+			.type = kJSONVariableTypeDouble,
+			.size = arguments->numberOfExceedanceThresholds
+		},
+		{
+			.variableSymbol = "exceedanceProbabilities",
+			.variableDescription = "Probability of exceeding each alarm threshold",
+			.values = (JSONVariablePointer){ .asDouble = exceedanceProbabilities },
+			.type = kJSONVariableTypeDouble,
+			.size = arguments->numberOfExceedanceThresholds
+		},
+	};
+
+	for (size_t i = 0; i < arguments->numberOfExceedanceThresholds; i++)
+	{
+		exceedanceProbabilities[i] = probabilityGT(exceedanceTable, *pointerToOutputVariable, arguments->exceedanceThresholds[i]);
+	}
+
+	if (arguments->jsonHistogramBins > 0)
+	{
+		printJSONHistogramSummary(
+			arguments,
+			monteCarloOutputSamples,
+			numberOfSamples,
+			&variables[kOutputDistributionIndexMax],
+			numberOfExceedanceVariables);
+
+		return;
+	}
+
+	if ((arguments->jsonMaximumSamples > 0) && (arguments->jsonMaximumSamples < numberOfSamples))
+	{
+		snprintf(
+			variables[kOutputDistributionIndexCalibratedSensorOutput].variableDescription,
+			kCommonConstantMaxCharsPerJSONVariableDescription,
+			"%s (%zu evenly spaced of %zu samples)",
+			variableDescription,
+			arguments->jsonMaximumSamples,
+			numberOfSamples);
+	}
+	else
+	{
+		strncpy(
+			variables[kOutputDistributionIndexCalibratedSensorOutput].variableDescription,
+			variableDescription,
+			kCommonConstantMaxCharsPerJSONVariableDescription);
+	}
+
+	printJSONVariablesWithInstrumentation(
+		arguments,
+		variables,
+		kOutputDistributionIndexMax + numberOfExceedanceVariables,
+		arguments->jsonMaximumSamples,
+		"Lepton FLIR Sensor Calibration");
+
+	return;
+}
+
+void
+printStreamingStatistics(
+	CommandLineArguments *		arguments,
+	const StreamingStatistics *	statistics,
+	const char *			variableDescription,
+	const char *			unitsOfMeasurement)
+{
+	double	mean = statistics->moments.mean;
+	double	variance = streamingStatisticsVariance(statistics);
+	double	percentiles[kStreamingStatisticsNumberOfPercentiles];
+
+	if (arguments->common.isOutputJSONMode)
+	{
+		StatisticsSummary	summary;
+		JSONVariable		variables[kStatisticsSummaryNumberOfJSONVariables];
+
+		setStatisticsSummaryJSONVariables(statistics, &summary, variables);
+		printJSONVariablesWithInstrumentation(arguments, variables, kStatisticsSummaryNumberOfJSONVariables, 0, "Lepton FLIR Sensor Calibration");
+
+		return;
+	}
+
+	streamingStatisticsQuantiles(statistics, kStreamingStatisticsPercentileProbabilities, kStreamingStatisticsNumberOfPercentiles, percentiles);
+
+	printf("%s: %.2lf %s.\n", variableDescription, mean, unitsOfMeasurement);
+	printf("\n");
+	printf("\tSamples: %zu (streaming, not stored)\n", statistics->moments.count);
+	printf("\tMean: %.6lf %s\n", mean, unitsOfMeasurement);
+	printf("\tVariance: %.6e %s^2 (standard deviation %.6lf %s)\n", variance, unitsOfMeasurement, sqrt(variance), unitsOfMeasurement);
+	printf("\tRange: [%.6lf, %.6lf] %s\n", statistics->moments.minimum, statistics->moments.maximum, unitsOfMeasurement);
+
+	for (size_t i = 0; i < kStreamingStatisticsNumberOfPercentiles; i++)
+	{
+		printf(
+			"\tPercentile %2.0lf%%: %.6lf %s\n",
+			100 * kStreamingStatisticsPercentileProbabilities[i],
+			percentiles[i],
+			unitsOfMeasurement);
+	}
+
+	return;
+}
+
+void
+printDeltaMethodComparison(
+	CommandLineArguments *		arguments,
+	const DeltaMethodResult *	deltaMethodResult,
+	double				deltaMethodSeconds,
+	const StreamingStatistics *	monteCarloStatistics,
+	double				monteCarloSeconds,
+	const char *			variableDescription,
+	const char *			unitsOfMeasurement)
+{
+	double	mean = deltaMethodResult->mean;
+	double	standardDeviation = deltaMethodResult->standardDeviation;
+	double	monteCarloMean = monteCarloStatistics->moments.mean;
+	double	monteCarloStandardDeviation = sqrt(streamingStatisticsVariance(monteCarloStatistics));
+	double	varianceContributions[kDeltaMethodInputIndexMax];
+	double	variance = standardDeviation * standardDeviation;
+
+	for (size_t i = 0; i < kDeltaMethodInputIndexMax; i++)
+	{
+		varianceContributions[i] = deltaMethodResult->varianceContributions[i];
+	}
+
+	if (arguments->common.isOutputJSONMode)
+	{
+		JSONVariable	variables[] =
+		{
+			{ .variableSymbol = "calibratedSensorOutputMean", .variableDescription = "First-order mean", .values = (JSONVariablePointer){ .asDouble = &mean }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "calibratedSensorOutputStandardDeviation", .variableDescription = "First-order standard deviation", .values = (JSONVariablePointer){ .asDouble = &standardDeviation }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "calibratedSensorOutputVarianceContributions", .variableDescription = "Variance contribution of Emiss, TRefl, TAtmC, Tau, TExtOptics, TransmissionExtOptics, R, B, F, J1, J0, counts", .values = (JSONVariablePointer){ .asDouble = varianceContributions }, .type = kJSONVariableTypeDouble, .size = kDeltaMethodInputIndexMax },
+			{ .variableSymbol = "monteCarloMean", .variableDescription = "Monte Carlo mean", .values = (JSONVariablePointer){ .asDouble = &monteCarloMean }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "monteCarloStandardDeviation", .variableDescription = "Monte Carlo standard deviation", .values = (JSONVariablePointer){ .asDouble = &monteCarloStandardDeviation }, .type = kJSONVariableTypeDouble, .size = 1 },
+		};
+
+		printJSONVariables(variables, sizeof(variables) / sizeof(variables[0]), "Lepton FLIR Sensor Calibration");
+
+		return;
+	}
+
+	printf("%s: %.2lf %s (first-order propagation).\n", variableDescription, mean, unitsOfMeasurement);
+	printf("\n");
+	printf("\tStandard deviation: %.6lf %s\n", standardDeviation, unitsOfMeasurement);
+	printf("\tPropagation time: %.3lf microseconds\n", 1e6 * deltaMethodSeconds);
+	printf("\tVariance contributions:\n");
+
+	for (size_t i = 0; i < kDeltaMethodInputIndexMax; i++)
+	{
+		if (varianceContributions[i] == 0)
+		{
+			continue;
+		}
+
+		printf("\t\t%-24s %6.2lf%%\n", deltaMethodGetInputName((DeltaMethodInputIndex) i), (variance > 0) ? 100 * varianceContributions[i] / variance : 0.0);
+	}
+
+	printf("\n");
+	printf(
+		"\tMonte Carlo (%zu iterations, %.3lf seconds): mean %.6lf %s, standard deviation %.6lf %s\n",
+		monteCarloStatistics->moments.count,
+		monteCarloSeconds,
+		monteCarloMean,
+		unitsOfMeasurement,
+		monteCarloStandardDeviation,
+		unitsOfMeasurement);
+	printf(
+		"\tFirst-order minus Monte Carlo: mean %+.6lf %s (%.2lf Monte Carlo standard errors), standard deviation %+.2lf%%\n",
+		mean - monteCarloMean,
+		unitsOfMeasurement,
+		fabs(mean - monteCarloMean) / (monteCarloStandardDeviation / sqrt((double) monteCarloStatistics->moments.count)),
+		100 * (standardDeviation - monteCarloStandardDeviation) / monteCarloStandardDeviation);
+
+	return;
+}
+
+void
+printSamplingMethodComparison(
+	CommandLineArguments *			arguments,
+	const MonteCarloSamplingComparison *	comparison,
+	const char *				variableDescription,
+	const char *				unitsOfMeasurement)
+{
+	const MonteCarloSamplingMethodSummary *	pseudoRandom = &comparison->methods[kMonteCarloSamplingMethodPseudoRandom];
+	double					means[kMonteCarloSamplingMethodMax];
+	double					meanStandardErrors[kMonteCarloSamplingMethodMax];
+	double					standardDeviations[kMonteCarloSamplingMethodMax];
+	double					standardDeviationStandardErrors[kMonteCarloSamplingMethodMax];
+	double					meanVarianceReductions[kMonteCarloSamplingMethodMax];
+	double					standardDeviationVarianceReductions[kMonteCarloSamplingMethodMax];
+	double					seconds[kMonteCarloSamplingMethodMax];
+
+	/*
+	 *	The variance reductions are the factors by which pseudo-random sampling would need
+	 *	more iterations to reach the same standard errors.
+	 */
+	for (int method = 0; method < kMonteCarloSamplingMethodMax; method++)
+	{
+		const MonteCarloSamplingMethodSummary *	summary = &comparison->methods[method];
+
+		means[method] = summary->meanOfMeans;
+		meanStandardErrors[method] = summary->meanStandardError;
+		standardDeviations[method] = summary->meanOfStandardDeviations;
+		standardDeviationStandardErrors[method] = summary->standardDeviationStandardError;
+		meanVarianceReductions[method] = (summary->meanStandardError > 0) ?
+							(pseudoRandom->meanStandardError * pseudoRandom->meanStandardError) /
+							(summary->meanStandardError * summary->meanStandardError) :
+							INFINITY;
+		standardDeviationVarianceReductions[method] = (summary->standardDeviationStandardError > 0) ?
+							(pseudoRandom->standardDeviationStandardError * pseudoRandom->standardDeviationStandardError) /
+							(summary->standardDeviationStandardError * summary->standardDeviationStandardError) :
+							INFINITY;
+		seconds[method] = summary->seconds;
+	}
+
+	if (arguments->common.isOutputJSONMode)
+	{
+		JSONVariable	variables[] =
+		{
+			{ .variableSymbol = "samplingMethodMeans", .variableDescription = "Mean over the replications of pseudo-random, Sobol and Latin hypercube sampling", .values = (JSONVariablePointer){ .asDouble = means }, .type = kJSONVariableTypeDouble, .size = kMonteCarloSamplingMethodMax },
+			{ .variableSymbol = "samplingMethodMeanStandardErrors", .variableDescription = "Standard error of the mean of pseudo-random, Sobol and Latin hypercube sampling", .values = (JSONVariablePointer){ .asDouble = meanStandardErrors }, .type = kJSONVariableTypeDouble, .size = kMonteCarloSamplingMethodMax },
+			{ .variableSymbol = "samplingMethodStandardDeviations", .variableDescription = "Standard deviation over the replications of pseudo-random, Sobol and Latin hypercube sampling", .values = (JSONVariablePointer){ .asDouble = standardDeviations }, .type = kJSONVariableTypeDouble, .size = kMonteCarloSamplingMethodMax },
+			{ .variableSymbol = "samplingMethodStandardDeviationStandardErrors", .variableDescription = "Standard error of the standard deviation of pseudo-random, Sobol and Latin hypercube sampling", .values = (JSONVariablePointer){ .asDouble = standardDeviationStandardErrors }, .type = kJSONVariableTypeDouble, .size = kMonteCarloSamplingMethodMax },
+			{ .variableSymbol = "samplingMethodMeanVarianceReductions", .variableDescription = "Variance reduction of the mean relative to pseudo-random sampling", .values = (JSONVariablePointer){ .asDouble = meanVarianceReductions }, .type = kJSONVariableTypeDouble, .size = kMonteCarloSamplingMethodMax },
+			{ .variableSymbol = "samplingMethodStandardDeviationVarianceReductions", .variableDescription = "Variance reduction of the standard deviation relative to pseudo-random sampling", .values = (JSONVariablePointer){ .asDouble = standardDeviationVarianceReductions }, .type = kJSONVariableTypeDouble, .size = kMonteCarloSamplingMethodMax },
+			{ .variableSymbol = "samplingMethodSeconds", .variableDescription = "Seconds per replication of pseudo-random, Sobol and Latin hypercube sampling", .values = (JSONVariablePointer){ .asDouble = seconds }, .type = kJSONVariableTypeDouble, .size = kMonteCarloSamplingMethodMax },
+		};
+
+		printJSONVariables(variables, sizeof(variables) / sizeof(variables[0]), "Lepton FLIR Sensor Calibration");
+
+		return;
+	}
+
+	printf(
+		"%s: %.2lf %s (%zu replications of %zu iterations per sampling method).\n",
+		variableDescription,
+		means[kMonteCarloSamplingMethodPseudoRandom],
+		unitsOfMeasurement,
+		comparison->numberOfReplications,
+		comparison->numberOfIterations);
+	printf("\n");
+
+	for (int method = 0; method < kMonteCarloSamplingMethodMax; method++)
+	{
+		printf("\t%s:\n", monteCarloGetSamplingMethodName((MonteCarloSamplingMethod) method));
+		printf(
+			"\t\tMean: %.6lf %s, standard error %.3e %s (variance reduction %.1lfx)\n",
+			means[method],
+			unitsOfMeasurement,
+			meanStandardErrors[method],
+			unitsOfMeasurement,
+			meanVarianceReductions[method]);
+		printf(
+			"\t\tStandard deviation: %.6lf %s, standard error %.3e %s (variance reduction %.1lfx)\n",
+			standardDeviations[method],
+			unitsOfMeasurement,
+			standardDeviationStandardErrors[method],
+			unitsOfMeasurement,
+			standardDeviationVarianceReductions[method]);
+		printf("\t\tTime per replication: %.3lf seconds\n", seconds[method]);
+	}
+
+	return;
+}
+
+void
+printAdaptiveMonteCarloReport(
+	CommandLineArguments *		arguments,
+	const StreamingStatistics *	statistics,
+	size_t				numberOfBlocks,
+	double				seconds,
+	const char *			variableDescription,
+	const char *			unitsOfMeasurement)
+{
+	double	iterations = (double) statistics->moments.count;
+	double	blocks = (double) numberOfBlocks;
+	double	targetStandardError = arguments->targetStandardError;
+	double	mean = statistics->moments.mean;
+	double	meanStandardError = streamingStatisticsMeanStandardError(statistics);
+	double	standardDeviation = sqrt(streamingStatisticsVariance(statistics));
+	double	standardDeviationStandardError = streamingStatisticsStandardDeviationStandardError(statistics);
+	double	quantiles[kMonteCarloAdaptiveMaximumQuantiles];
+	double	quantileStandardErrors[kMonteCarloAdaptiveMaximumQuantiles];
+	double	largestStandardError = fmax(meanStandardError, standardDeviationStandardError);
+	double	isTargetMet;
+
+	streamingStatisticsQuantileStandardErrors(
+		statistics,
+		arguments->targetQuantileProbabilities,
+		arguments->numberOfTargetQuantiles,
+		quantiles,
+		quantileStandardErrors);
+
+	for (size_t i = 0; i < arguments->numberOfTargetQuantiles; i++)
+	{
+		largestStandardError = fmax(largestStandardError, quantileStandardErrors[i]);
+	}
+
+	isTargetMet = (largestStandardError <= targetStandardError) ? 1 : 0;
+
+	if (arguments->common.isOutputJSONMode)
+	{
+		JSONVariable	variables[] =
+		{
+			{ .variableSymbol = "adaptiveIterations", .variableDescription = "Monte Carlo iterations run", .values = (JSONVariablePointer){ .asDouble = &iterations }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "adaptiveBlocks", .variableDescription = "Blocks of iterations run", .values = (JSONVariablePointer){ .asDouble = &blocks }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "adaptiveTargetStandardError", .variableDescription = "Target standard error", .values = (JSONVariablePointer){ .asDouble = &targetStandardError }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "adaptiveIsTargetMet", .variableDescription = "1 if every standard error met the target, else 0", .values = (JSONVariablePointer){ .asDouble = &isTargetMet }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "calibratedSensorOutputMean", .variableDescription = "Mean", .values = (JSONVariablePointer){ .asDouble = &mean }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "calibratedSensorOutputMeanStandardError", .variableDescription = "Standard error of the mean", .values = (JSONVariablePointer){ .asDouble = &meanStandardError }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "calibratedSensorOutputStandardDeviation", .variableDescription = "Standard deviation", .values = (JSONVariablePointer){ .asDouble = &standardDeviation }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "calibratedSensorOutputStandardDeviationStandardError", .variableDescription = "Standard error of the standard deviation", .values = (JSONVariablePointer){ .asDouble = &standardDeviationStandardError }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "calibratedSensorOutputQuantileProbabilities", .variableDescription = "Probabilities of the target quantiles", .values = (JSONVariablePointer){ .asDouble = arguments->targetQuantileProbabilities }, .type = kJSONVariableTypeDouble, .size = arguments->numberOfTargetQuantiles },
+			{ .variableSymbol = "calibratedSensorOutputQuantiles", .variableDescription = "Target quantiles", .values = (JSONVariablePointer){ .asDouble = quantiles }, .type = kJSONVariableTypeDouble, .size = arguments->numberOfTargetQuantiles },
+			{ .variableSymbol = "calibratedSensorOutputQuantileStandardErrors", .variableDescription = "Standard errors of the target quantiles", .values = (JSONVariablePointer){ .asDouble = quantileStandardErrors }, .type = kJSONVariableTypeDouble, .size = arguments->numberOfTargetQuantiles },
+		};
+
+		printJSONVariablesWithInstrumentation(arguments, variables, sizeof(variables) / sizeof(variables[0]), 0, "Lepton FLIR Sensor Calibration");
+
+		return;
+	}
+
+	printf(
+		"%s: %.2lf %s (adaptive Monte Carlo, %zu of at most %zu iterations in %zu blocks, %.3lf seconds).\n",
+		variableDescription,
+		mean,
+		unitsOfMeasurement,
+		statistics->moments.count,
+		arguments->common.numberOfMonteCarloIterations,
+		numberOfBlocks,
+		seconds);
+	printf("\n");
+	printf(
+		"\tTarget: standard error %.3e %s (95%% confidence interval +/- %.3e %s), %s\n",
+		targetStandardError,
+		unitsOfMeasurement,
+		kMonteCarloAdaptiveConfidenceIntervalZ * targetStandardError,
+		unitsOfMeasurement,
+		isTargetMet ? "met" : "NOT met within the -M iterations");
+	printf(
+		"\tMean: %.6lf +/- %.3e %s (standard error %.3e)\n",
+		mean,
+		kMonteCarloAdaptiveConfidenceIntervalZ * meanStandardError,
+		unitsOfMeasurement,
+		meanStandardError);
+	printf(
+		"\tStandard deviation: %.6lf +/- %.3e %s (standard error %.3e)\n",
+		standardDeviation,
+		kMonteCarloAdaptiveConfidenceIntervalZ * standardDeviationStandardError,
+		unitsOfMeasurement,
+		standardDeviationStandardError);
+
+	for (size_t i = 0; i < arguments->numberOfTargetQuantiles; i++)
+	{
+		printf(
+			"\tQuantile %g%%: %.6lf +/- %.3e %s (standard error %.3e)\n",
+			100 * arguments->targetQuantileProbabilities[i],
+			quantiles[i],
+			kMonteCarloAdaptiveConfidenceIntervalZ * quantileStandardErrors[i],
+			unitsOfMeasurement,
+			quantileStandardErrors[i]);
+	}
+
+	return;
+}
+
+void
+printFloat32ConversionReport(
+	CommandLineArguments *			arguments,
+	const Float32ConversionErrorReport *	report,
+	const char *				unitsOfMeasurement)
+{
+	double	maximumAbsoluteError = report->maximumAbsoluteError;
+	double	countsAtMaximumError = (double) report->countsAtMaximumError;
+	double	numberOfCountsOutsideTolerance = (double) report->numberOfCountsOutsideTolerance;
+	double	tolerance = kFloat32ConversionToleranceKelvin;
+	double	nanosecondsPerPixel[] = {report->float64NanosecondsPerPixel, report->float32NanosecondsPerPixel};
+	double	float64MaximumUlpDifference = (double) report->float64MaximumUlpDifference;
+	double	float64UlpTolerance = kVectorizedConversionMaximumUlpDifference;
+
+	if (arguments->common.isOutputJSONMode)
+	{
+		JSONVariable	variables[] =
+		{
+			{ .variableSymbol = "float32MaximumAbsoluteError", .variableDescription = "Largest difference between the float32 and float64 frame kernels over all counts", .values = (JSONVariablePointer){ .asDouble = &maximumAbsoluteError }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "float32CountsAtMaximumError", .variableDescription = "Count of the largest difference", .values = (JSONVariablePointer){ .asDouble = &countsAtMaximumError }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "float32Tolerance", .variableDescription = "Tolerance", .values = (JSONVariablePointer){ .asDouble = &tolerance }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "float32CountsOutsideTolerance", .variableDescription = "Counts whose float32 result is outside the tolerance", .values = (JSONVariablePointer){ .asDouble = &numberOfCountsOutsideTolerance }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "nanosecondsPerPixel", .variableDescription = "Nanoseconds per pixel of the float64 and float32 frame kernels", .values = (JSONVariablePointer){ .asDouble = nanosecondsPerPixel }, .type = kJSONVariableTypeDouble, .size = 2 },
+			{ .variableSymbol = "float64MaximumUlpDifference", .variableDescription = "Largest difference between the vectorized and scalar float64 frame kernels over all counts, in ULP", .values = (JSONVariablePointer){ .asDouble = &float64MaximumUlpDifference }, .type = kJSONVariableTypeDouble, .size = 1 },
+			{ .variableSymbol = "float64UlpTolerance", .variableDescription = "Tolerance of the vectorized float64 frame kernel, in ULP", .values = (JSONVariablePointer){ .asDouble = &float64UlpTolerance }, .type = kJSONVariableTypeDouble, .size = 1 },
+		};
+
+		printJSONVariables(variables, sizeof(variables) / sizeof(variables[0]), "Lepton FLIR Sensor Calibration");
+
+		return;
+	}
+
+	printf(
+		"Float32 frame kernel (%s): %s the %g %s tolerance over all 65536 counts.\n",
+		getVectorizedConversionKernelName(report->kernel),
+		(report->numberOfCountsOutsideTolerance == 0) ? "within" : "OUTSIDE",
+		tolerance,
+		unitsOfMeasurement);
+	printf("\n");
+	printf(
+		"\tMaximum absolute difference from float64: %.3e %s (count %zu)\n",
+		maximumAbsoluteError,
+		unitsOfMeasurement,
+		report->countsAtMaximumError);
+	printf("\tCounts compared: %zu (%zu below the valid range of the calibration)\n", report->numberOfComparedCounts, report->numberOfUndefinedCounts);
+	printf("\tCounts outside the tolerance: %zu\n", report->numberOfCountsOutsideTolerance);
+	printf(
+		"\tTime per pixel: float64 %.3lf ns, float32 %.3lf ns (%.2lfx)\n",
+		report->float64NanosecondsPerPixel,
+		report->float32NanosecondsPerPixel,
+		report->float64NanosecondsPerPixel / report->float32NanosecondsPerPixel);
+	printf(
+		"\tVectorized float64 kernel: %" PRIu64 " ULP from the scalar kernel, %s the %d ULP bound\n",
+		report->float64MaximumUlpDifference,
+		(report->float64MaximumUlpDifference <= kVectorizedConversionMaximumUlpDifference) ? "within" : "OUTSIDE",
+		kVectorizedConversionMaximumUlpDifference);
+
+	return;
+}
+
+void
+printJSONVariablesWithNulls(const JSONVariable *  variables, size_t numberOfVariables, const char *  title)
+{
+	JSONWriter	writer;
+
+	jsonWriterBeginDocument(&writer, stdout, title);
+
+	for (size_t i = 0; i < numberOfVariables; i++)
+	{
+		jsonWriterAppendVariable(&writer, &variables[i], 0, kJSONWriterShortestRoundTrip);
+	}
+
+	jsonWriterFinish(&writer);
 
 	return;
 }
@@ -22,13 +22,93 @@
 
 #pragma once
 
+#include <stdint.h>
 #include "common.h"
 #include "utilities-config.h"
+#include "streaming-statistics.h"
+#include "delta-method.h"
+#include "exceedance.h"
+#include "monte-carlo.h"
+#include "calibration-profile.h"
+#include "alarm-thresholds.h"
 
 typedef struct
 {
 	CommonCommandLineArguments	common;
 	double				countValueReadFromArgvToOverrideDefaultDistribution;
+	bool				isLookupTableMode;
+	size_t				numberOfThreads;
+	uint64_t			randomSeed;
+	bool				isStreamingStatisticsMode;
+	bool				isFrameStreamMode;
+	bool				isRealTimeFrameStreamMode;
+	bool				isDeltaMethodMode;
+	/*
+	 *	NULL unless the samples are written to a binary sample file instead of `data.out`.
+	 */
+	const char *			binarySamplesPath;
+	bool				isBinarySamplesFloat32;
+	/*
+	 *	JSON output of MonteCarlo Mode: significant digits of each value (zero for the
+	 *	shortest round-trip form), the number of samples to print (zero for all), and the
+	 *	number of histogram bins to print instead of the samples (zero for none).
+	 */
+	int				jsonSignificantDigits;
+	size_t				jsonMaximumSamples;
+	size_t				jsonHistogramBins;
+	/*
+	 *	Alarm thresholds, in Kelvin, whose probabilities of being exceeded are printed (`-pt`).
+	 */
+	double				exceedanceThresholds[kExceedanceMaximumThresholds];
+	size_t				numberOfExceedanceThresholds;
+	MonteCarloSamplingMethod	samplingMethod;
+	bool				isSamplingMethodComparisonMode;
+	/*
+	 *	Adaptive Monte Carlo: the target standard error in Kelvin (zero unless adaptive),
+	 *	and the probabilities of the quantiles that must also meet it.
+	 */
+	double				targetStandardError;
+	double				targetQuantileProbabilities[kMonteCarloAdaptiveMaximumQuantiles];
+	size_t				numberOfTargetQuantiles;
+	/*
+	 *	Precision of the `-i` and `-fs` frame kernels, and whether to print the
+	 *	float32 accuracy report instead of converting.
+	 */
+	ConversionPrecision		precision;
+	bool				isFloat32ReportMode;
+	/*
+	 *	The calibration profiles of `-cp` (else the built-in one), and the profile of `-cn`
+	 *	(else the first) that every conversion except that of camera-tagged frames uses.
+	 */
+	CalibrationProfileSet		calibrationProfiles;
+	const CalibrationProfile *	calibrationProfile;
+	/*
+	 *	NULL unless `-i` frames are converted with per-pixel materials (`-mt` and `-mm`).
+	 */
+	const char *			materialTablePath;
+	const char *			materialMapPath;
+	/*
+	 *	Whether `-i` frames only convert the tiles whose counts changed by more than
+	 *	`incrementalCountTolerance` since their last conversion (`-inc`).
+	 */
+	bool				isIncrementalMode;
+	uint16_t			incrementalCountTolerance;
+	/*
+	 *	NULL unless `-i` frames accumulate the statistics of the rectangles of `-roi`
+	 *	or of the labels of `-roim`.
+	 */
+	const char *			regionsOfInterestPath;
+	const char *			regionMaskPath;
+	/*
+	 *	The temperature thresholds of `-at`, which `-i` frames are checked against
+	 *	through raw counts instead of converted.
+	 */
+	double				alarmThresholds[kAlarmThresholdsMaximum];
+	size_t				numberOfAlarmThresholds;
+	/*
+	 *	NULL unless conversions are served on this Unix-domain socket (`-srv`).
+	 */
+	const char *			serverSocketPath;
 } CommandLineArguments;
 
 /**
@@ -48,25 +128,144 @@ void	printUsage(void);
 CommonConstantReturnType getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  arguments);
 
 /**
- *	@brief  Prints the output of the evaluation in a human-readable form.
+ *	@brief	Frees the memory that `getCommandLineArguments()` allocated.
  *
+ *	@param	arguments	: Pointer to the arguments.
+ */
+void	freeCommandLineArguments(CommandLineArguments *  arguments);
+
+/**
+ *	@brief  Prints the output of the evaluation in a human-readable form, followed by the
+ *		probabilities of exceeding the `-pt` thresholds.
+ *
+ *	@param  arguments		: The command-line arguments, holding the `-pt` thresholds.
  *	@param  calibratedSensorOutput	: A single result of the evaluation. Calculates useful statistics from it.
+ *	@param  exceedanceTable		: In MonteCarlo Mode, the sorted samples the probabilities are read from,
+ *					  else NULL to use `UxHwDoubleProbabilityGT()`.
  *	@param  variableDescription	: A string decribing the mode of the sensor it prints.
  *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the value it prints.
  */
-void	printCalibratedValueAndProbabilities(double calibratedSensorOutput, const char *  variableDescription, const char *  unitsOfMeasurement);
+void	printCalibratedValueAndProbabilities(
+		const CommandLineArguments *	arguments,
+		double				calibratedSensorOutput,
+		const ExceedanceTable *		exceedanceTable,
+		const char *			variableDescription,
+		const char *			unitsOfMeasurement);
 
 /**
  *	@brief  Prints output distributions in JSON format. Based on command-line arguments will either print
- *		a single value or all values stored in `outputDistributions`.
+ *		a single value or all values stored in `outputDistributions`. In MonteCarlo Mode, the samples
+ *		can be limited to `-jn` evenly spaced samples, or summarized by a `-jh` histogram. The
+ *		probabilities of exceeding the `-pt` thresholds follow.
  *
  *	@param  arguments			: The command-line arguments, specifying which outputs will be printed.
  *	@param  outputVariable 			: A pointer to the distribution to print.
  *	@param  monteCarloOutputSamples		: The array of data samples of Monte Carlo.
+ *	@param  exceedanceTable			: The sorted samples for the `-pt` probabilities in MonteCarlo Mode, else NULL.
  *	@param  variableDescription		: A string containing a description of the variable printed.
  */
 void	printJSONFormattedOutput(
-		CommandLineArguments *	arguments,
-		double *		outputVariable,
-		double *		monteCarloOutputSamples,
-		const char *		variableDescription);
+		CommandLineArguments *		arguments,
+		double *			outputVariable,
+		double *			monteCarloOutputSamples,
+		const ExceedanceTable *		exceedanceTable,
+		const char *			variableDescription);
+
+/**
+ *	@brief  Prints the mean, variance, range and selected percentiles of streaming Monte Carlo
+ *		statistics, either in JSON or in a human-readable form.
+ *
+ *	@param  arguments		: The command-line arguments, selecting the output format.
+ *	@param  statistics		: Pointer to the streaming statistics.
+ *	@param  variableDescription	: A string decribing the variable summarized.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the variable.
+ */
+void	printStreamingStatistics(
+		CommandLineArguments *		arguments,
+		const StreamingStatistics *	statistics,
+		const char *			variableDescription,
+		const char *			unitsOfMeasurement);
+
+/**
+ *	@brief  Prints the first-order (delta method) mean and standard deviation, the contribution
+ *		of each input to the variance, and the difference from a Monte Carlo evaluation of the
+ *		same inputs, either in JSON or in a human-readable form.
+ *
+ *	@param  arguments			: The command-line arguments, selecting the output format.
+ *	@param  deltaMethodResult		: Pointer to the first-order result.
+ *	@param  deltaMethodSeconds		: Time taken by the first-order propagation.
+ *	@param  monteCarloStatistics		: Pointer to the Monte Carlo statistics of the same inputs.
+ *	@param  monteCarloSeconds		: Time taken by the Monte Carlo evaluation.
+ *	@param  variableDescription		: A string decribing the variable.
+ *	@param  unitsOfMeasurement		: A string decribing the units of measurement of the variable.
+ */
+void	printDeltaMethodComparison(
+		CommandLineArguments *		arguments,
+		const DeltaMethodResult *	deltaMethodResult,
+		double				deltaMethodSeconds,
+		const StreamingStatistics *	monteCarloStatistics,
+		double				monteCarloSeconds,
+		const char *			variableDescription,
+		const char *			unitsOfMeasurement);
+
+/**
+ *	@brief  Prints, for each sampling method, the mean and standard deviation over the replications
+ *		and their standard errors, with the variance reduction relative to pseudo-random sampling,
+ *		either in JSON or in a human-readable form.
+ *
+ *	@param  arguments		: The command-line arguments, selecting the output format.
+ *	@param  comparison		: Pointer to the comparison.
+ *	@param  variableDescription	: A string decribing the variable.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the variable.
+ */
+void	printSamplingMethodComparison(
+		CommandLineArguments *			arguments,
+		const MonteCarloSamplingComparison *	comparison,
+		const char *				variableDescription,
+		const char *				unitsOfMeasurement);
+
+/**
+ *	@brief  Prints the result of an adaptive Monte Carlo run: the iterations it used, and the mean,
+ *		standard deviation and target quantiles with their standard errors and 95% confidence
+ *		intervals, either in JSON or in a human-readable form.
+ *
+ *	@param  arguments		: The command-line arguments, holding the target.
+ *	@param  statistics		: Pointer to the streaming statistics of all the iterations run.
+ *	@param  numberOfBlocks		: The number of blocks of iterations run.
+ *	@param  seconds			: The wall-clock time of the run.
+ *	@param  variableDescription	: A string decribing the variable.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the variable.
+ */
+void	printAdaptiveMonteCarloReport(
+		CommandLineArguments *		arguments,
+		const StreamingStatistics *	statistics,
+		size_t				numberOfBlocks,
+		double				seconds,
+		const char *			variableDescription,
+		const char *			unitsOfMeasurement);
+
+/**
+ *	@brief  Prints how far the float32 frame kernel is from the float64 one over all 65536
+ *		counts, whether that is within `kFloat32ConversionToleranceKelvin`, the cost per
+ *		pixel of each, and how far the vectorized float64 kernel is from the scalar one,
+ *		either in JSON or in a human-readable form.
+ *
+ *	@param  arguments		: The command-line arguments.
+ *	@param  report			: Pointer to the measured report.
+ *	@param  unitsOfMeasurement	: A string decribing the units of measurement of the temperatures.
+ */
+void	printFloat32ConversionReport(
+		CommandLineArguments *			arguments,
+		const Float32ConversionErrorReport *	report,
+		const char *				unitsOfMeasurement);
+
+/**
+ *	@brief  Prints variables as `printJSONVariables()` does, but through the JSON writer, which
+ *		writes non-finite values as `null` instead of numbers that JSON cannot represent.
+ *		For the documents of per-frame statistics that can be undefined.
+ *
+ *	@param  variables		: The variables, of type `kJSONVariableTypeDouble`.
+ *	@param  numberOfVariables	: Number of variables.
+ *	@param  title			: The document's "description".
+ */
+void	printJSONVariablesWithNulls(const JSONVariable *  variables, size_t numberOfVariables, const char *  title);